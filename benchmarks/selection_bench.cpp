@@ -0,0 +1,257 @@
+// Selection microbenchmarks.
+// Drives LexicaseSelect, AgeLexicaseSelect, and TournamentSelect over a sweep of population sizes,
+// test counts, score distributions, and duplicate-phenotype ratios. TruncationSelect, RandomSelect,
+// and NoSelect are included as minimal-cost reference points. Writes one CSV row per cell.
+//
+// Duplicate candidates share one score row (and its score functions): the population is a list of
+// row ids passed to the selectors' cohort overloads, so only unique rows cost memory per test.
+//
+// Usage: ./bench-selection_bench.out [--quick] [--out <path>] [--max-mem <GB>] [--min-time <seconds>]
+
+// Count heap allocations made by each timed call (see utils::AllocationStopwatch)
+#define PSYNTH_TRACK_ALLOCATIONS
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <numeric>
+#include <string>
+
+#include "emp/base/vector.hpp"
+#include "emp/math/Random.hpp"
+
+#include "utility/AllocationTracker.hpp"
+#include "selection/Lexicase.hpp"
+#include "selection/AgeLexicase.hpp"
+#include "selection/Tournament.hpp"
+#include "selection/Truncation.hpp"
+#include "selection/Random.hpp"
+#include "selection/NoSelect.hpp"
+
+namespace {
+
+using score_fun_t = std::function<double(void)>;
+
+struct BenchConfig {
+  std::string out_path = "selection_bench.csv";
+  double max_mem_gb = 8.0;        ///< Skip cells whose estimated memory use (see EstimateCellBytes) exceeds this
+  double min_time = 0.2;          ///< Minimum seconds of timed selection calls per cell
+  size_t max_reps = 1000;         ///< Maximum number of timed selection calls per cell
+  emp::vector<size_t> pop_sizes{100, 1000, 10000, 100000};
+  emp::vector<size_t> test_counts{10, 100, 500, 2000};
+  emp::vector<std::string> distributions{"binary", "few-valued", "continuous"};
+  emp::vector<double> dup_ratios{0.0, 0.5, 0.9};
+};
+
+struct BenchResult {
+  size_t reps = 0;
+  size_t selections = 0;
+  double seconds = 0.0;
+  size_t allocs = 0;
+  size_t bytes = 0;
+};
+
+size_t NumUniqueRows(size_t pop_size, double dup_ratio) {
+  return std::max((size_t)1, (size_t)((1.0 - dup_ratio) * (double)pop_size));
+}
+
+/// Rough peak memory for one cell: unique score rows and their score functions (which
+/// AgeLexicaseSelect copies), plus the selector's per-candidate score table and rank table.
+double EstimateCellBytes(size_t pop_size, size_t num_tests, double dup_ratio) {
+  const double unique_cells = (double)NumUniqueRows(pop_size, dup_ratio) * (double)(num_tests + 1);
+  const double pop_cells = (double)pop_size * (double)(num_tests + 1);
+  return unique_cells * (double)(2 * sizeof(score_fun_t) + sizeof(double))
+    + pop_cells * (double)(sizeof(double) + sizeof(uint8_t));
+}
+
+/// Fill score rows for the unique candidates, and map each of pop_size candidates onto a row
+/// (row_ids). The first rows map to themselves; dup_ratio of candidates copy a random row.
+void GenerateScores(
+  emp::Random& random,
+  emp::vector< emp::vector<double> >& scores,
+  emp::vector<size_t>& row_ids,
+  size_t pop_size,
+  size_t num_tests,
+  const std::string& distribution,
+  double dup_ratio
+) {
+  const size_t num_unique = NumUniqueRows(pop_size, dup_ratio);
+  scores.resize(num_unique);
+  row_ids.resize(pop_size);
+  for (size_t cand = 0; cand < pop_size; ++cand) {
+    row_ids[cand] = (cand < num_unique) ? cand : random.GetUInt(num_unique);
+  }
+  for (size_t cand = 0; cand < num_unique; ++cand) {
+    auto& row = scores[cand];
+    row.resize(num_tests);
+    // Candidates vary in quality so that lexicase pools shrink at realistic rates
+    const double quality = random.GetDouble();
+    for (size_t test = 0; test < num_tests; ++test) {
+      if (distribution == "binary") {
+        row[test] = (double)random.P(quality);
+      } else if (distribution == "few-valued") {
+        row[test] = (double)std::min((size_t)4, (size_t)(quality * 4.0 + random.GetDouble()));
+      } else {
+        row[test] = quality + random.GetDouble();
+      }
+    }
+  }
+}
+
+template<typename SELECT_FUN_T>
+BenchResult TimeSelector(const BenchConfig& cfg, size_t n, SELECT_FUN_T&& do_select) {
+  BenchResult result;
+  do_select(n); // Warm-up (lets selectors size internal buffers)
+  utils::AllocationStopwatch stopwatch;
+  const auto start = std::chrono::steady_clock::now();
+  double elapsed = 0.0;
+  while (result.reps < cfg.max_reps && (elapsed < cfg.min_time || result.reps == 0)) {
+    do_select(n);
+    ++result.reps;
+    result.selections += n;
+    elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+  result.seconds = elapsed;
+  const utils::AllocationCounts counts = stopwatch.Lap();
+  result.allocs = counts.allocations;
+  result.bytes = counts.bytes;
+  return result;
+}
+
+void WriteRow(
+  std::ostream& os,
+  const std::string& selector,
+  size_t pop_size,
+  size_t num_tests,
+  const std::string& distribution,
+  double dup_ratio,
+  const BenchResult& r
+) {
+  const double sel_per_sec = (double)r.selections / r.seconds;
+  os << selector << ","
+     << pop_size << ","
+     << num_tests << ","
+     << distribution << ","
+     << dup_ratio << ","
+     << r.reps << ","
+     << r.selections << ","
+     << r.seconds << ","
+     << sel_per_sec << ","
+     << (1e9 / sel_per_sec) << ","
+     << ((double)r.allocs / (double)r.reps) << ","
+     << ((double)r.bytes / (double)r.reps)
+     << std::endl;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+  BenchConfig cfg;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg(argv[i]);
+    if (arg == "--quick") {
+      cfg.pop_sizes = {100, 1000};
+      cfg.test_counts = {10, 100};
+      cfg.dup_ratios = {0.0, 0.9};
+      cfg.min_time = 0.05;
+    } else if (arg == "--out" && i + 1 < argc) {
+      cfg.out_path = argv[++i];
+    } else if (arg == "--max-mem" && i + 1 < argc) {
+      cfg.max_mem_gb = std::stod(argv[++i]);
+    } else if (arg == "--min-time" && i + 1 < argc) {
+      cfg.min_time = std::stod(argv[++i]);
+    } else {
+      std::cout << "Unknown argument: " << arg << std::endl;
+      return 1;
+    }
+  }
+
+  std::ofstream out(cfg.out_path);
+  out << "selector,pop_size,num_tests,distribution,dup_ratio,reps,selections,seconds,"
+      << "selections_per_sec,ns_per_selection,allocs_per_call,bytes_per_call" << std::endl;
+
+  emp::Random random(1);
+  emp::vector< emp::vector<double> > scores;
+  emp::vector<size_t> row_ids;
+  emp::vector<size_t> test_ids;
+  emp::vector<double> agg_scores;
+  emp::vector<double> ages;
+
+  for (size_t pop_size : cfg.pop_sizes) {
+    for (size_t num_tests : cfg.test_counts) {
+      test_ids.resize(num_tests);
+      std::iota(test_ids.begin(), test_ids.end(), 0);
+      for (const std::string& distribution : cfg.distributions) {
+        for (double dup_ratio : cfg.dup_ratios) {
+          const double est_gb = EstimateCellBytes(pop_size, num_tests, dup_ratio) / 1e9;
+          if (est_gb > cfg.max_mem_gb) {
+            std::cout << "Skipping pop_size=" << pop_size << ", num_tests=" << num_tests
+                      << ", dup_ratio=" << dup_ratio << " (needs ~" << est_gb << " GB; --max-mem "
+                      << cfg.max_mem_gb << ")" << std::endl;
+            continue;
+          }
+          GenerateScores(random, scores, row_ids, pop_size, num_tests, distribution, dup_ratio);
+          const size_t num_rows = scores.size();
+          // Per-row, per-test score functions (same interface the world uses)
+          emp::vector< emp::vector<score_fun_t> > fit_funs(num_rows);
+          emp::vector< emp::vector<score_fun_t> > age_funs(num_rows);
+          ages.resize(num_rows);
+          for (size_t row = 0; row < num_rows; ++row) {
+            fit_funs[row].reserve(num_tests);
+            for (size_t test = 0; test < num_tests; ++test) {
+              const double* score = &scores[row][test];
+              fit_funs[row].emplace_back([score]() { return *score; });
+            }
+            ages[row] = -1.0 * (double)random.GetUInt(50);
+            const double* age = &ages[row];
+            age_funs[row].emplace_back([age]() { return *age; });
+          }
+          // Aggregate-score selectors see every candidate directly
+          agg_scores.resize(pop_size);
+          for (size_t cand = 0; cand < pop_size; ++cand) {
+            const auto& row = scores[row_ids[cand]];
+            agg_scores[cand] = std::accumulate(row.begin(), row.end(), 0.0);
+          }
+
+          {
+            selection::LexicaseSelect sel(fit_funs, random);
+            const auto r = TimeSelector(cfg, pop_size, [&](size_t n) { sel(n, row_ids, test_ids); });
+            WriteRow(out, "lexicase", pop_size, num_tests, distribution, dup_ratio, r);
+          }
+          {
+            selection::AgeLexicaseSelect sel(fit_funs, age_funs, random);
+            sel.SetAgeFunOrderLimit(std::min((size_t)100, num_tests + 1));
+            const auto r = TimeSelector(cfg, pop_size, [&](size_t n) { sel(n, row_ids, test_ids); });
+            WriteRow(out, "age-lexicase", pop_size, num_tests, distribution, dup_ratio, r);
+          }
+          {
+            selection::TournamentSelect sel(agg_scores, random, 4);
+            const auto r = TimeSelector(cfg, pop_size, [&sel](size_t n) { sel(n); });
+            WriteRow(out, "tournament", pop_size, num_tests, distribution, dup_ratio, r);
+          }
+          {
+            selection::TruncationSelect sel(agg_scores, random, 8);
+            const auto r = TimeSelector(cfg, pop_size, [&sel](size_t n) { sel(n); });
+            WriteRow(out, "truncation", pop_size, num_tests, distribution, dup_ratio, r);
+          }
+          {
+            selection::RandomSelect sel(random, pop_size);
+            const auto r = TimeSelector(cfg, pop_size, [&sel](size_t n) { sel(n); });
+            WriteRow(out, "random", pop_size, num_tests, distribution, dup_ratio, r);
+          }
+          {
+            selection::NoSelect sel(pop_size);
+            const auto r = TimeSelector(cfg, pop_size, [&sel](size_t n) { sel(n); });
+            WriteRow(out, "none", pop_size, num_tests, distribution, dup_ratio, r);
+          }
+          std::cout << "Finished pop_size=" << pop_size << ", num_tests=" << num_tests
+                    << ", distribution=" << distribution << ", dup_ratio=" << dup_ratio << std::endl;
+        }
+      }
+    }
+  }
+  std::cout << "Wrote " << cfg.out_path << std::endl;
+  return 0;
+}
@@ -13,6 +13,8 @@
 #include "emp/Evolve/Systematics.hpp"
 #include "emp/base/vector.hpp"
 
+#include "../utility/ScoreCodec.hpp"
+
 // TODO - Data structure for tracking phenotypes
 // TODO - Subclass of systematics that makes it easy to search for relative
 // TODO - make search more efficient!
@@ -25,9 +27,12 @@
 namespace phylo {
 
 // NOTE - might need to make this more generic!
-struct taxon_info {
+/// SCORE_T: storage type for phenotype trait scores (see utils::ScoreCodec).
+template<typename SCORE_T=double>
+struct basic_taxon_info {
 
-  using phen_t = emp::vector<double>;
+  using score_t = SCORE_T;
+  using phen_t = emp::vector<score_t>;
   using has_phen_t = std::true_type;
   using has_mutations_t = std::true_type;
   using has_fitness_t = std::true_type;
@@ -52,7 +57,7 @@ struct taxon_info {
   }
 
   double GetTraitScore(size_t i) const {
-    return phenotype[i];
+    return utils::ScoreCodec<score_t>::Decode(phenotype[i]);
   }
 
   double GetFitness() const {
@@ -99,6 +104,8 @@ struct taxon_info {
 
 };
 
+using taxon_info = basic_taxon_info<double>;
+
 namespace impl {
 
 void FilterEvaluated(size_t min_pool_size, emp::vector<size_t>& pool, const emp::vector<bool>& evaluated) {
@@ -5,7 +5,7 @@ Implemenation adapted from: https://github.com/amlalejini/Tag-based-Genetic-Regu
 */
 #pragma once
 
-#include <unordered_map>
+#include <array>
 #include "emp/bits/BitSet.hpp"
 #include "emp/math/Random.hpp"
 #include "emp/math/random_utils.hpp"
@@ -13,6 +13,10 @@ Implemenation adapted from: https://github.com/amlalejini/Tag-based-Genetic-Regu
 
 #include "sgp/cpu/lfunprg/LinearFunctionsProgram.hpp"
 
+#include "../utility/BernoulliSkipSampler.hpp"
+#include "PackedProgram.hpp"
+#include "SharedProgram.hpp"
+
 namespace psynth {
 
 template<
@@ -42,6 +46,9 @@ public:
   using inst_t = typename program_t::inst_t;
   using hardware_t = HARDWARE_T;
   using inst_lib_t = typename HARDWARE_T::inst_lib_t;
+  using packed_program_t = PackedProgram<TAG_W>;
+  using packed_inst_t = PackedInst;
+  using shared_program_t = SharedProgram<TAG_W>;
 
   enum class MUTATION_TYPES {
     INST_ARG_SUB = 0,
@@ -57,6 +64,52 @@ public:
     FUNC_TAG_BIT_FLIP,
     FUNC_TAG_BIT_SEQ_RANDOMIZATION
   };
+  static constexpr size_t NUM_MUTATION_TYPES = (size_t)MUTATION_TYPES::FUNC_TAG_BIT_SEQ_RANDOMIZATION + 1;
+
+  /// Per-type mutation counters (indexed directly by MUTATION_TYPES).
+  struct MutationCounts {
+    std::array<int, NUM_MUTATION_TYPES> counts{};
+
+    int& operator[](MUTATION_TYPES type) { return counts[(size_t)type]; }
+    int operator[](MUTATION_TYPES type) const { return counts[(size_t)type]; }
+
+    void Reset() { counts.fill(0); }
+
+    /// Total number of mutations (across all types).
+    int GetTotal() const {
+      int total = 0;
+      for (int count : counts) total += count;
+      return total;
+    }
+
+    MutationCounts& operator+=(const MutationCounts& other) {
+      for (size_t i = 0; i < NUM_MUTATION_TYPES; ++i) counts[i] += other.counts[i];
+      return *this;
+    }
+
+    bool operator==(const MutationCounts& other) const { return counts == other.counts; }
+    bool operator!=(const MutationCounts& other) const { return counts != other.counts; }
+  };
+  using mutation_counts_t = MutationCounts;
+
+  /// Name of mutation type (e.g., for output column headers).
+  static const char* GetMutationTypeName(MUTATION_TYPES type) {
+    static constexpr std::array<const char*, NUM_MUTATION_TYPES> names = {
+      "inst_arg_sub",
+      "inst_tag_bit_flip",
+      "inst_tag_bit_seq_randomization",
+      "inst_sub",
+      "inst_ins",
+      "inst_del",
+      "seq_slip_dup",
+      "seq_slip_del",
+      "func_dup",
+      "func_del",
+      "func_tag_bit_flip",
+      "func_tag_bit_seq_randomization"
+    };
+    return names[(size_t)type];
+  }
 
 protected:
   // Need an instruction library to know valid
@@ -86,7 +139,117 @@ protected:
   double rate_func_tag_seq_rand=0.0;  ///< Per-tag
   double rate_inst_tag_seq_rand=0.0;  ///< Per-tag
 
-  std::unordered_map<MUTATION_TYPES, int> last_mutation_tracker;
+  mutation_counts_t last_mutation_tracker;
+
+  /// Single-instruction insertion (before pos) or deletion (of pos) that passed the length constraints.
+  struct InDelEdit {
+    size_t pos;   ///< Position in the function before any edits (packed programs: rewritten during application)
+    bool insert;
+  };
+
+  emp::vector<packed_inst_t> packed_insts_scratch;  ///< Scratch buffer for packed slip duplications
+  emp::vector<size_t> indel_ins_locs;               ///< Scratch: sampled insertion locations (current function)
+  emp::vector<size_t> indel_del_locs;               ///< Scratch: sampled deletion locations (current function)
+  emp::vector<InDelEdit> indel_edits;               ///< Accepted indels for the whole program (function by function, in order)
+  emp::vector<size_t> indel_edit_begin;             ///< Function f's edits are indel_edits[indel_edit_begin[f], indel_edit_begin[f+1])
+  emp::vector<size_t> indel_func_sizes;             ///< Function sizes after indels
+
+  /// Pre-sample instruction insertions/deletions for a whole program and resolve them against the
+  /// length constraints (filling indel_edits, indel_edit_begin, indel_func_sizes).
+  /// Per function, insertion count is Binomial(size, rate_inst_ins) with uniform locations and each
+  /// instruction is a deletion candidate with probability rate_inst_del (same as a per-instruction walk).
+  template<typename SIZE_FUN_T>
+  size_t SampleInDels(emp::Random& rnd, size_t num_funcs, size_t prog_len, SIZE_FUN_T&& get_func_size) {
+    size_t mut_cnt = 0;
+    size_t expected_prog_len = prog_len;
+    utils::BernoulliSkipSampler ins_sampler(rnd, rate_inst_ins);
+    utils::BernoulliSkipSampler del_sampler(rnd, rate_inst_del);
+    indel_edits.clear();
+    indel_edit_begin.assign(1, 0);
+    indel_func_sizes.resize(num_funcs);
+    for (size_t fID = 0; fID < num_funcs; ++fID) {
+      const size_t func_size = get_func_size(fID);
+      const size_t num_ins = ins_sampler.Sample(rnd, func_size, [](size_t) { ; });
+      indel_ins_locs.resize(num_ins);
+      for (size_t& loc : indel_ins_locs) loc = rnd.GetUInt(0, func_size);
+      std::sort(indel_ins_locs.begin(), indel_ins_locs.end());
+      indel_del_locs.clear();
+      del_sampler.Sample(rnd, func_size, [this](size_t i) { indel_del_locs.emplace_back(i); });
+      indel_func_sizes[fID] = func_size;
+      if (num_ins || indel_del_locs.size()) {
+        mut_cnt += ResolveInDels(func_size, indel_func_sizes[fID], expected_prog_len);
+      }
+      indel_edit_begin.emplace_back(indel_edits.size());
+    }
+    return mut_cnt;
+  }
+
+  /// Walk one function's sampled insertions/deletions in order, keeping those that respect the length
+  /// constraints. Only event positions are visited. As in a per-instruction walk, an insertion blocked
+  /// by a length limit stays pending until a deletion makes room.
+  size_t ResolveInDels(size_t func_size, size_t& expected_func_len, size_t& expected_prog_len) {
+    size_t mut_cnt = 0;
+    size_t ins_i = 0;
+    size_t del_i = 0;
+    size_t ins_floor = 0;  ///< Pending insertions can't happen before this position (func_size = blocked)
+    while (true) {
+      const size_t ins_pos = (ins_i < indel_ins_locs.size()) ? std::max(indel_ins_locs[ins_i], ins_floor) : func_size;
+      const size_t del_pos = (del_i < indel_del_locs.size()) ? indel_del_locs[del_i] : func_size;
+      const size_t pos = std::min(ins_pos, del_pos);
+      if (pos >= func_size) break;
+      // Insertions before pos come before deleting pos.
+      if (ins_pos == pos) {
+        if (expected_func_len < prog_func_inst_range.GetUpper() && expected_prog_len < prog_total_inst) {
+          indel_edits.push_back({pos, true});
+          ++mut_cnt;
+          ++last_mutation_tracker[MUTATION_TYPES::INST_INS];
+          ++expected_func_len;
+          ++expected_prog_len;
+          ++ins_i;
+        } else {
+          ins_floor = func_size;
+        }
+        continue;
+      }
+      if (expected_func_len > prog_func_inst_range.GetLower()) {
+        indel_edits.push_back({pos, false});
+        ++mut_cnt;
+        ++last_mutation_tracker[MUTATION_TYPES::INST_DEL];
+        --expected_func_len;
+        --expected_prog_len;
+        // Blocked insertions can try again at the next instruction.
+        if (ins_floor == func_size) ins_floor = pos + 1;
+      }
+      ++del_i;
+    }
+    return mut_cnt;
+  }
+
+  /// Visit each (instruction, field) position that mutates at the given per-field rate, calling fun(inst, field).
+  /// Positions are flattened across functions: (function, instruction, field). Returns number of mutations.
+  template<typename FUN_T>
+  size_t SampleInstFields(emp::Random& rnd, program_t& program, double rate, size_t num_fields, FUN_T&& fun) {
+    if (rate <= 0.0 || num_fields == 0) return 0;
+    utils::BernoulliSkipSampler sampler(rnd, rate);
+    size_t cnt = 0;
+    for (size_t fID = 0; fID < program.GetSize(); ++fID) {
+      function_t& func = program[fID];
+      cnt += sampler.Sample(rnd, func.GetSize() * num_fields, [&func, &fun, num_fields](size_t i) {
+        fun(func[i / num_fields], i % num_fields);
+      });
+    }
+    return cnt;
+  }
+
+  template<typename FUN_T>
+  size_t SampleInstFields(emp::Random& rnd, packed_program_t& program, double rate, size_t num_fields, FUN_T&& fun) {
+    if (rate <= 0.0 || num_fields == 0) return 0;
+    utils::BernoulliSkipSampler sampler(rnd, rate);
+    emp::vector<packed_inst_t>& insts = program.GetInsts();
+    return sampler.Sample(rnd, insts.size() * num_fields, [&insts, &fun, num_fields](size_t i) {
+      fun(insts[i / num_fields], i % num_fields);
+    });
+  }
 
   // emp::vector<std::function<size_t(emp::Random &, program_t &)>> active_mutations;
 
@@ -98,22 +261,13 @@ public:
   }
 
   void ResetLastMutationTracker() {
-    last_mutation_tracker[MUTATION_TYPES::INST_ARG_SUB] = 0;
-    last_mutation_tracker[MUTATION_TYPES::INST_TAG_BIT_FLIP] = 0;
-    last_mutation_tracker[MUTATION_TYPES::INST_SUB] = 0;
-    last_mutation_tracker[MUTATION_TYPES::INST_INS] = 0;
-    last_mutation_tracker[MUTATION_TYPES::INST_DEL] = 0;
-    last_mutation_tracker[MUTATION_TYPES::SEQ_SLIP_DUP] = 0;
-    last_mutation_tracker[MUTATION_TYPES::SEQ_SLIP_DEL] = 0;
-    last_mutation_tracker[MUTATION_TYPES::FUNC_DUP] = 0;
-    last_mutation_tracker[MUTATION_TYPES::FUNC_DEL] = 0;
-    last_mutation_tracker[MUTATION_TYPES::FUNC_TAG_BIT_FLIP] = 0;
-  }
-
-  const std::unordered_map<MUTATION_TYPES, int>& GetLastMutations() const {
+    last_mutation_tracker.Reset();
+  }
+
+  const mutation_counts_t& GetLastMutations() const {
     return last_mutation_tracker;
   }
-  std::unordered_map<MUTATION_TYPES, int>& GetLastMutations() {
+  mutation_counts_t& GetLastMutations() {
     return last_mutation_tracker;
   }
 
@@ -176,14 +330,9 @@ public:
 
   /// Apply bit flips to tag @ per-bit rate.
   size_t ApplyTagBitFlipsPerBit(emp::Random& rnd, tag_t& tag, double rate) {
-    size_t mut_cnt = 0;
-    for (size_t k = 0; k < tag.GetSize(); ++k) {
-      if (rnd.P(rate)) {
-        tag.Toggle(k);
-        ++mut_cnt;
-      }
-    }
-    return mut_cnt;
+    if (rate <= 0.0) return 0;
+    utils::BernoulliSkipSampler sampler(rnd, rate);
+    return sampler.Sample(rnd, tag.GetSize(), [&tag](size_t k) { tag.Toggle(k); });
   }
 
   /// Apply specified number of tag bit flips.
@@ -210,114 +359,127 @@ public:
   }
 
   /// Apply instruction substitutions (operator, argument, tag).
+  /// Each mutation type skips (geometrically) between mutated positions over the whole program,
+  /// so cost scales with the number of mutations. Per tag, mutations are applied in the same order
+  /// as before: per-bit flips, then single-bit flip, then sequence randomization.
+  /// Assumes instructions have prog_inst_num_tags tags and prog_inst_num_args arguments.
   size_t ApplyInstSubs(emp::Random& rnd, program_t& program) {
     size_t mut_cnt = 0;
-    for (size_t fID = 0; fID < program.GetSize(); ++fID) {
-      for (size_t iID = 0; iID < program[fID].GetSize(); ++iID) {
-        inst_t & inst = program[fID][iID];
-
-        // Mutate instruction tag(s).
-        size_t tag_bf_cnt = 0;
-        for (tag_t & tag : inst.GetTags()) {
-          // Apply per-bit substitution mutations
-          if (rate_inst_tag_bit_flips > 0.0) {
-            tag_bf_cnt += ApplyTagBitFlipsPerBit(rnd, tag, rate_inst_tag_bit_flips);
-          }
-          // Apply per-tag substitution mutations
-          if (rate_inst_tag_single_bit_flip > 0.0 && rnd.P(rate_inst_tag_single_bit_flip)) {
-            tag_bf_cnt += ApplyTagBitFlipsFixed(rnd, tag, 1);
-          }
-          // Apply per-tag sequence randomization mutations
-          if (rate_inst_tag_seq_rand > 0.0 && rnd.P(rate_inst_tag_seq_rand)) {
-            ApplyTagSeqRandomization(rnd, tag);
-            ++mut_cnt;  // Count this as only one mutation
-            ++last_mutation_tracker[MUTATION_TYPES::INST_TAG_BIT_SEQ_RANDOMIZATION];
-          }
-        }
-        mut_cnt += tag_bf_cnt;
-        last_mutation_tracker[MUTATION_TYPES::INST_TAG_BIT_FLIP] += tag_bf_cnt;
-
-        // Mutate instruction operation.
-        if (rnd.P(rate_inst_sub)) {
-          inst.id = rnd.GetUInt(inst_lib.GetSize());
-          ++last_mutation_tracker[MUTATION_TYPES::INST_SUB];
-          ++mut_cnt;
-        }
 
-        // Mutate instruction arguments.
-        for (size_t k = 0; k < inst.GetArgs().size(); ++k) {
-          if (rnd.P(rate_inst_arg_sub)) {
-            inst.GetArgs()[k] = rnd.GetInt(
-              prog_inst_arg_val_range.GetLower(),
-              prog_inst_arg_val_range.GetUpper()+1
-            );
-            ++mut_cnt;
-            ++last_mutation_tracker[MUTATION_TYPES::INST_ARG_SUB];
-          }
-        }
+    // Mutate instruction tag(s).
+    const size_t tag_bits = prog_inst_num_tags * TAG_W;
+    size_t tag_bf_cnt = SampleInstFields(rnd, program, rate_inst_tag_bit_flips, tag_bits,
+      [tag_bits](inst_t& inst, size_t bit) {
+        emp_assert(inst.GetTags().size() * TAG_W == tag_bits);
+        inst.GetTags()[bit / TAG_W].Toggle(bit % TAG_W);
       }
-    }
+    );
+    tag_bf_cnt += SampleInstFields(rnd, program, rate_inst_tag_single_bit_flip, prog_inst_num_tags,
+      [this, &rnd](inst_t& inst, size_t tag_id) { ApplyTagBitFlipsFixed(rnd, inst.GetTags()[tag_id], 1); }
+    );
+    mut_cnt += tag_bf_cnt;
+    last_mutation_tracker[MUTATION_TYPES::INST_TAG_BIT_FLIP] += tag_bf_cnt;
+    const size_t seq_rand_cnt = SampleInstFields(rnd, program, rate_inst_tag_seq_rand, prog_inst_num_tags,
+      [this, &rnd](inst_t& inst, size_t tag_id) { ApplyTagSeqRandomization(rnd, inst.GetTags()[tag_id]); }
+    );
+    mut_cnt += seq_rand_cnt;  // Count each as only one mutation
+    last_mutation_tracker[MUTATION_TYPES::INST_TAG_BIT_SEQ_RANDOMIZATION] += seq_rand_cnt;
+
+    // Mutate instruction operation.
+    const size_t op_cnt = SampleInstFields(rnd, program, rate_inst_sub, 1,
+      [this, &rnd](inst_t& inst, size_t) { inst.id = rnd.GetUInt(inst_lib.GetSize()); }
+    );
+    mut_cnt += op_cnt;
+    last_mutation_tracker[MUTATION_TYPES::INST_SUB] += op_cnt;
+
+    // Mutate instruction arguments.
+    const size_t arg_cnt = SampleInstFields(rnd, program, rate_inst_arg_sub, prog_inst_num_args,
+      [this, &rnd](inst_t& inst, size_t k) {
+        emp_assert(inst.GetArgs().size() == prog_inst_num_args);
+        inst.GetArgs()[k] = rnd.GetInt(
+          prog_inst_arg_val_range.GetLower(),
+          prog_inst_arg_val_range.GetUpper()+1
+        );
+      }
+    );
+    mut_cnt += arg_cnt;
+    last_mutation_tracker[MUTATION_TYPES::INST_ARG_SUB] += arg_cnt;
     return mut_cnt;
   }
 
+  /// Generate a random (SignalGP) instruction.
+  inst_t GenRandInst(emp::Random& rnd) {
+    return sgp::cpu::linprg::GenRandInst<hardware_t, TAG_W>(
+      rnd,
+      inst_lib,
+      prog_inst_num_tags,
+      prog_inst_num_args,
+      prog_inst_arg_val_range
+    );
+  }
+
   /// Apply single-instruction insertions and deletions.
+  /// Indels are pre-sampled for the whole program; functions without any are left untouched.
+  /// Functions that don't shrink are edited in place (survivors are shifted once to make room);
+  /// functions that shrink are rebuilt (SignalGP functions can only grow in place).
   size_t ApplyInstInDels(emp::Random & rnd, program_t & program) {
-    size_t mut_cnt = 0;
-    size_t expected_prog_len = program.GetInstCount();
-    // Perform single-instruction insertion/deletions.
+    const size_t mut_cnt = SampleInDels(rnd, program.GetSize(), program.GetInstCount(),
+      [&program](size_t fID) { return program[fID].GetSize(); }
+    );
     for (size_t fID = 0; fID < program.GetSize(); ++fID) {
-      function_t new_function(program[fID].GetTags()); // Copy over tags
-      size_t expected_func_len = program[fID].GetSize();
-      // Compute number and location of insertions.
-      const uint32_t num_ins = rnd.GetRandBinomial(program[fID].GetSize(), rate_inst_ins);
-      emp::vector<size_t> ins_locs;
-      if (num_ins > 0) {
-        if (program[fID].GetSize()) {
-          ins_locs = emp::RandomUIntVector(rnd, num_ins, 0, program[fID].GetSize());
-          // std::sort(ins_locs.rbegin(), ins_locs.rend());
-          std::sort(ins_locs.begin(), ins_locs.end(), std::greater<size_t>());
-        } else {
-          ins_locs.resize(num_ins, 0); // If function len is 0, just put all insertions at beginning.
-        }
-      }
-      size_t read_head = 0;
-      while (read_head < program[fID].GetSize()) {
-        // Should we insert?
-        if (ins_locs.size() > 0) {
-          if (read_head >= ins_locs.back() &&
-              expected_func_len < prog_func_inst_range.GetUpper() &&
-              expected_prog_len < prog_total_inst)
-          {
-            // Insert a new random instruction.
-            new_function.PushInst(
-              sgp::cpu::linprg::GenRandInst<hardware_t, TAG_W>(
-                rnd,
-                inst_lib,
-                prog_inst_num_tags,
-                prog_inst_num_args,
-                prog_inst_arg_val_range
-              )
-            );
-            ++mut_cnt;
-            ++last_mutation_tracker[MUTATION_TYPES::INST_INS];
-            ++expected_func_len;
-            ++expected_prog_len;
-            ins_locs.pop_back();
+      const InDelEdit* edits_begin = indel_edits.data() + indel_edit_begin[fID];
+      const InDelEdit* edits_end = indel_edits.data() + indel_edit_begin[fID + 1];
+      if (edits_begin == edits_end) continue;
+      function_t& func = program[fID];
+      const size_t old_size = func.GetSize();
+      const size_t new_size = indel_func_sizes[fID];
+      if (new_size < old_size) {
+        // Rebuild function, applying edits along the way.
+        function_t new_function(func.GetTags()); // Copy over tags
+        const InDelEdit* edit = edits_begin;
+        for (size_t read_head = 0; read_head < old_size; ++read_head) {
+          for (; edit != edits_end && edit->pos == read_head && edit->insert; ++edit) {
+            new_function.PushInst(GenRandInst(rnd));
+          }
+          if (edit != edits_end && edit->pos == read_head) {
+            emp_assert(!edit->insert);
+            ++edit;
             continue;
           }
+          new_function.PushInst(func[read_head]);
         }
-        // Should we delete this instruction?
-        if (rnd.P(rate_inst_del) && expected_func_len > prog_func_inst_range.GetLower()) {
-          ++mut_cnt;
-          ++last_mutation_tracker[MUTATION_TYPES::INST_DEL];
-          --expected_func_len;
-          --expected_prog_len;
-        } else {
-          new_function.PushInst(program[fID][read_head]);
+        program[fID] = std::move(new_function);
+        continue;
+      }
+      // (1) Compact deletions out of the function (shifting survivors left).
+      size_t write = 0;
+      size_t read = 0;
+      size_t num_dels = 0;
+      emp::vector<size_t>& ins_pos = indel_ins_locs;  // Insertion positions in the compacted function
+      ins_pos.clear();
+      for (const InDelEdit* edit = edits_begin; edit != edits_end; ++edit) {
+        if (edit->insert) {
+          ins_pos.emplace_back(edit->pos - num_dels);
+          continue;
         }
-        ++read_head;
+        for (; read < edit->pos; ++read, ++write) {
+          if (write != read) func[write] = std::move(func[read]);
+        }
+        ++read;
+        ++num_dels;
+      }
+      for (; read < old_size; ++read, ++write) {
+        if (write != read) func[write] = std::move(func[read]);
+      }
+      // (2) Grow function, then fill insertions from the back (shifting survivors right).
+      for (size_t i = old_size; i < new_size; ++i) func.PushInst(func[old_size - 1]);
+      size_t read_end = write;
+      size_t write_end = new_size;
+      for (size_t i = ins_pos.size(); i-- > 0; ) {
+        while (read_end > ins_pos[i]) func[--write_end] = std::move(func[--read_end]);
+        func[--write_end] = GenRandInst(rnd);
       }
-      program[fID] = new_function;
+      emp_assert(write_end == read_end);
     }
     return mut_cnt;
   }
@@ -415,14 +577,14 @@ public:
   /// Apply function tag bit-flip mutations.
   size_t ApplyFuncTagBF(emp::Random& rnd, program_t& program) {
     size_t mut_cnt = 0;
+    // Per-bit substitution mutations skip across all function tags.
+    utils::BernoulliSkipSampler bit_flips(rnd, rate_func_tag_bit_flips);
     // Perform function tag mutations!
     for (size_t fID = 0; fID < program.GetSize(); ++fID) {
       size_t tag_bfs = 0;
       for (tag_t & tag : program[fID].GetTags()) {
         // Apply per-bit substitution mutations
-        if (rate_func_tag_bit_flips > 0.0) {
-          tag_bfs += ApplyTagBitFlipsPerBit(rnd, tag, rate_func_tag_bit_flips);
-        }
+        tag_bfs += bit_flips.Sample(rnd, tag.GetSize(), [&tag](size_t k) { tag.Toggle(k); });
         // Apply per-tag single-bit substitutions
         if (rate_func_tag_single_bit_flip > 0.0 && rnd.P(rate_func_tag_single_bit_flip)) {
           tag_bfs += ApplyTagBitFlipsFixed(rnd, tag, 1);
@@ -458,6 +620,293 @@ public:
     }
     return true;
   }
+
+  // --- Packed program mutations ---
+  // Same operators (and rates / constraints) as above, applied directly to a PackedProgram's
+  // contiguous instruction buffer. Packed programs have exactly one tag per function/instruction.
+
+  /// Apply bit flips to packed tag @ per-bit rate.
+  size_t ApplyTagBitFlipsPerBit(emp::Random& rnd, uint32_t& tag, double rate) {
+    if (rate <= 0.0) return 0;
+    utils::BernoulliSkipSampler sampler(rnd, rate);
+    return sampler.Sample(rnd, TAG_W, [&tag](size_t k) { tag ^= (uint32_t)1 << k; });
+  }
+
+  /// Apply specified number of (distinct) bit flips to packed tag.
+  size_t ApplyTagBitFlipsFixed(emp::Random& rnd, uint32_t& tag, size_t num_flips) {
+    emp_assert(num_flips <= TAG_W);
+    uint32_t flips = 0;
+    for (size_t flip_cnt = 0; flip_cnt < num_flips; ) {
+      const uint32_t bit = (uint32_t)1 << rnd.GetUInt(TAG_W);
+      if (flips & bit) continue;
+      flips |= bit;
+      ++flip_cnt;
+    }
+    tag ^= flips;
+    return num_flips;
+  }
+
+  /// Pick two random locations in packed tag, randomize everything in between.
+  size_t ApplyTagSeqRandomization(emp::Random& rnd, uint32_t& tag) {
+    const size_t a = rnd.GetUInt(TAG_W);
+    const size_t b = rnd.GetUInt(TAG_W);
+    const size_t pos_1 = emp::Min(a, b);
+    const size_t pos_2 = emp::Max(a, b);
+    for (size_t pos = pos_1; pos <= pos_2; ++pos) {
+      const uint32_t bit = (uint32_t)1 << pos;
+      tag = rnd.P(0.5) ? (tag | bit) : (tag & ~bit);
+    }
+    return (pos_2 - pos_1) + 1;
+  }
+
+  /// Generate a random packed instruction.
+  packed_inst_t GenRandPackedInst(emp::Random& rnd) {
+    emp_assert(prog_inst_num_args <= packed_inst_t::NUM_ARGS);
+    packed_inst_t inst(
+      (uint32_t)rnd.GetUInt(inst_lib.GetSize()),
+      (uint32_t)rnd.GetUInt() & packed_program_t::TAG_MASK
+    );
+    for (size_t k = 0; k < prog_inst_num_args; ++k) {
+      inst.args[k] = (int8_t)rnd.GetInt(
+        prog_inst_arg_val_range.GetLower(),
+        prog_inst_arg_val_range.GetUpper()+1
+      );
+    }
+    return inst;
+  }
+
+  /// Applies all mutation operators at current rates.
+  size_t ApplyAll(emp::Random& rnd, packed_program_t& program) {
+    size_t mut_cnt = 0;
+    mut_cnt += ApplyInstSubs(rnd, program);
+    mut_cnt += ApplyInstInDels(rnd, program);
+    mut_cnt += ApplySeqSlips(rnd, program);
+    mut_cnt += ApplyFuncDup(rnd, program);
+    mut_cnt += ApplyFuncDel(rnd, program);
+    mut_cnt += ApplyFuncTagBF(rnd, program);
+    return mut_cnt;
+  }
+
+  /// Apply instruction substitutions (operator, argument, tag), skipping between mutated
+  /// positions in the instruction buffer (see program_t version).
+  size_t ApplyInstSubs(emp::Random& rnd, packed_program_t& program) {
+    emp_assert(prog_inst_num_args <= packed_inst_t::NUM_ARGS);
+    size_t mut_cnt = 0;
+
+    // Mutate instruction tag.
+    size_t tag_bf_cnt = SampleInstFields(rnd, program, rate_inst_tag_bit_flips, TAG_W,
+      [](packed_inst_t& inst, size_t bit) { inst.tag ^= (uint32_t)1 << bit; }
+    );
+    tag_bf_cnt += SampleInstFields(rnd, program, rate_inst_tag_single_bit_flip, 1,
+      [this, &rnd](packed_inst_t& inst, size_t) { ApplyTagBitFlipsFixed(rnd, inst.tag, 1); }
+    );
+    mut_cnt += tag_bf_cnt;
+    last_mutation_tracker[MUTATION_TYPES::INST_TAG_BIT_FLIP] += tag_bf_cnt;
+    const size_t seq_rand_cnt = SampleInstFields(rnd, program, rate_inst_tag_seq_rand, 1,
+      [this, &rnd](packed_inst_t& inst, size_t) { ApplyTagSeqRandomization(rnd, inst.tag); }
+    );
+    mut_cnt += seq_rand_cnt;
+    last_mutation_tracker[MUTATION_TYPES::INST_TAG_BIT_SEQ_RANDOMIZATION] += seq_rand_cnt;
+
+    // Mutate instruction operation.
+    const size_t op_cnt = SampleInstFields(rnd, program, rate_inst_sub, 1,
+      [this, &rnd](packed_inst_t& inst, size_t) { inst.op = (uint32_t)rnd.GetUInt(inst_lib.GetSize()); }
+    );
+    mut_cnt += op_cnt;
+    last_mutation_tracker[MUTATION_TYPES::INST_SUB] += op_cnt;
+
+    // Mutate instruction arguments.
+    const size_t arg_cnt = SampleInstFields(rnd, program, rate_inst_arg_sub, prog_inst_num_args,
+      [this, &rnd](packed_inst_t& inst, size_t k) {
+        inst.args[k] = (int8_t)rnd.GetInt(
+          prog_inst_arg_val_range.GetLower(),
+          prog_inst_arg_val_range.GetUpper()+1
+        );
+      }
+    );
+    mut_cnt += arg_cnt;
+    last_mutation_tracker[MUTATION_TYPES::INST_ARG_SUB] += arg_cnt;
+    return mut_cnt;
+  }
+
+  /// Apply single-instruction insertions and deletions in place.
+  /// Indels are pre-sampled for the whole program. Deletions are compacted out in one forward pass and
+  /// insertions are opened up in one backward pass; each pass moves each run of instructions between
+  /// edits once (instructions before the first edit are never touched).
+  size_t ApplyInstInDels(emp::Random& rnd, packed_program_t& program) {
+    const size_t mut_cnt = SampleInDels(rnd, program.GetSize(), program.GetInstCount(),
+      [&program](size_t fID) { return program.GetFunctionSize(fID); }
+    );
+    if (indel_edits.empty()) return mut_cnt;
+    emp::vector<packed_inst_t>& insts = program.GetInsts();
+    const size_t old_size = insts.size();
+    // (1) Compact deletions out of the buffer. Insertion positions are rewritten to positions in the
+    //     compacted buffer.
+    size_t write = 0;
+    size_t read = 0;
+    size_t num_dels = 0;
+    for (size_t fID = 0; fID < program.GetSize(); ++fID) {
+      const size_t func_offset = program.GetFunctionOffset(fID);
+      for (size_t edit_i = indel_edit_begin[fID]; edit_i < indel_edit_begin[fID + 1]; ++edit_i) {
+        InDelEdit& edit = indel_edits[edit_i];
+        const size_t pos = func_offset + edit.pos;
+        if (edit.insert) {
+          edit.pos = pos - num_dels;
+          continue;
+        }
+        if (write != read) std::move(insts.begin() + read, insts.begin() + pos, insts.begin() + write);
+        write += pos - read;
+        read = pos + 1;
+        ++num_dels;
+      }
+    }
+    if (write != read) std::move(insts.begin() + read, insts.end(), insts.begin() + write);
+    write += old_size - read;
+    // (2) Resize buffer, then fill insertions from the back.
+    const size_t new_size = write + (indel_edits.size() - num_dels);
+    insts.resize(new_size);
+    size_t read_end = write;
+    size_t write_end = new_size;
+    for (size_t edit_i = indel_edits.size(); edit_i-- > 0; ) {
+      const InDelEdit& edit = indel_edits[edit_i];
+      if (!edit.insert) continue;
+      if (write_end != read_end) {
+        std::move_backward(insts.begin() + edit.pos, insts.begin() + read_end, insts.begin() + write_end);
+      }
+      write_end -= read_end - edit.pos;
+      read_end = edit.pos;
+      insts[--write_end] = GenRandPackedInst(rnd);
+    }
+    emp_assert(write_end == read_end);
+    program.SetFunctionSizes(indel_func_sizes);
+    return mut_cnt;
+  }
+
+  /// Apply slip mutations to program sequences (per-function instruction sequence).
+  size_t ApplySeqSlips(emp::Random& rnd, packed_program_t& program) {
+    size_t mut_cnt = 0;
+    size_t expected_prog_len = program.GetInstCount();
+    for (size_t fID = 0; fID < program.GetSize(); ++fID) {
+      const size_t func_size = program.GetFunctionSize(fID);
+      if (!rnd.P(rate_seq_slip) || func_size == 0) continue;
+      size_t begin = rnd.GetUInt(func_size);
+      size_t end = rnd.GetUInt(func_size);
+      const bool dup = begin < end;
+      const bool del = begin > end;
+      const size_t dup_size = dup ? end - begin : 0;
+      const size_t del_size = del ? begin - end : 0;
+      if (
+        dup &&
+        (expected_prog_len + dup_size <= prog_total_inst) &&
+        (func_size + dup_size <= prog_func_inst_range.GetUpper())
+      ) {
+        // Duplicate begin:end (copy is inserted immediately after the original)
+        packed_insts_scratch.assign(program.FunctionBegin(fID) + begin, program.FunctionBegin(fID) + end);
+        program.InsertInsts(fID, end, packed_insts_scratch.data(), packed_insts_scratch.data() + dup_size);
+        ++mut_cnt;
+        ++last_mutation_tracker[MUTATION_TYPES::SEQ_SLIP_DUP];
+        expected_prog_len += dup_size;
+      } else if (del && (func_size - del_size) >= prog_func_inst_range.GetLower()) {
+        // Delete end:begin
+        program.EraseInsts(fID, end, begin);
+        ++mut_cnt;
+        ++last_mutation_tracker[MUTATION_TYPES::SEQ_SLIP_DEL];
+        expected_prog_len -= del_size;
+      }
+    }
+    return mut_cnt;
+  }
+
+  /// Apply function duplications to program (per-function).
+  size_t ApplyFuncDup(emp::Random& rnd, packed_program_t& program) {
+    size_t mut_cnt = 0;
+    size_t expected_prog_len = program.GetInstCount();
+    const size_t orig_func_wall = program.GetSize();
+    for (size_t fID = 0; fID < orig_func_wall; ++fID) {
+      if (rnd.P(rate_func_dup) &&
+          (program.GetSize() < prog_func_cnt_range.GetUpper()) &&
+          (expected_prog_len + program.GetFunctionSize(fID) <= prog_total_inst))
+      {
+        program.DuplicateFunction(fID);
+        expected_prog_len += program.GetFunctionSize(fID);
+        ++mut_cnt;
+        ++last_mutation_tracker[MUTATION_TYPES::FUNC_DUP];
+      }
+    }
+    return mut_cnt;
+  }
+
+  /// Apply function deletions to program (per-function).
+  size_t ApplyFuncDel(emp::Random& rnd, packed_program_t& program) {
+    size_t mut_cnt = 0;
+    for (int fID = 0; fID < (int)program.GetSize(); ++fID) {
+      if (rnd.P(rate_func_del) &&
+          program.GetSize() > prog_func_cnt_range.GetLower())
+      {
+        program.RemoveFunctionSwapLast((size_t)fID);
+        ++mut_cnt;
+        ++last_mutation_tracker[MUTATION_TYPES::FUNC_DEL];
+        fID -= 1;
+      }
+    }
+    return mut_cnt;
+  }
+
+  /// Apply function tag bit-flip mutations.
+  size_t ApplyFuncTagBF(emp::Random& rnd, packed_program_t& program) {
+    size_t mut_cnt = 0;
+    utils::BernoulliSkipSampler bit_flips(rnd, rate_func_tag_bit_flips);
+    for (uint32_t& tag : program.GetFunctionTags()) {
+      size_t tag_bfs = 0;
+      tag_bfs += bit_flips.Sample(rnd, TAG_W, [&tag](size_t k) { tag ^= (uint32_t)1 << k; });
+      if (rate_func_tag_single_bit_flip > 0.0 && rnd.P(rate_func_tag_single_bit_flip)) {
+        tag_bfs += ApplyTagBitFlipsFixed(rnd, tag, 1);
+      }
+      if (rate_func_tag_seq_rand > 0.0 && rnd.P(rate_func_tag_seq_rand)) {
+        ApplyTagSeqRandomization(rnd, tag);
+        ++mut_cnt;
+        ++last_mutation_tracker[MUTATION_TYPES::FUNC_TAG_BIT_SEQ_RANDOMIZATION];
+      }
+      mut_cnt += tag_bfs;
+      last_mutation_tracker[MUTATION_TYPES::FUNC_TAG_BIT_FLIP] += tag_bfs;
+    }
+    return mut_cnt;
+  }
+
+  /// Applies all mutation operators at current rates to a shared (hash-consed) program.
+  /// Mutations are applied to an unpacked copy; only functions that changed get new shared nodes.
+  size_t ApplyAll(emp::Random& rnd, shared_program_t& program) {
+    static thread_local packed_program_t unpacked;
+    const size_t mut_cnt = ApplyAllUnpacked(rnd, program, unpacked);
+    if (mut_cnt) program.Repack(unpacked);
+    return mut_cnt;
+  }
+
+  /// Mutate an unpacked copy of a shared program (if any mutations occur, commit them with
+  /// program.Repack(unpacked)). Only reads the shared function table, so several threads can do this
+  /// at once (as long as nothing is repacked in the meantime).
+  size_t ApplyAllUnpacked(emp::Random& rnd, const shared_program_t& program, packed_program_t& unpacked) {
+    program.Unpack(unpacked);
+    return ApplyAll(rnd, unpacked);
+  }
+
+  /// Verify that the given packed program is within this mutator's constraints.
+  bool VerifyProgram(const packed_program_t& prog) {
+    if (prog_func_num_tags != 1 || prog_inst_num_tags != 1) { return false; }
+    if (prog.GetInstCount() > prog_total_inst) { return false; }
+    if (!prog_func_cnt_range.Valid(prog.GetSize())) { return false; }
+    for (size_t fID = 0; fID < prog.GetSize(); ++fID) {
+      if (!prog_func_inst_range.Valid(prog.GetFunctionSize(fID))) { return false; }
+    }
+    for (const packed_inst_t& inst : prog.GetInsts()) {
+      if (inst.op >= inst_lib.GetSize()) { return false; }
+      for (size_t k = 0; k < packed_inst_t::NUM_ARGS; ++k) {
+        if (k < prog_inst_num_args && !prog_inst_arg_val_range.Valid(inst.args[k])) { return false; }
+        if (k >= prog_inst_num_args && inst.args[k] != 0) { return false; }
+      }
+    }
+    return true;
+  }
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,357 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "emp/base/vector.hpp"
+
+namespace psynth {
+
+/// Fixed-size (16 byte) instruction record.
+/// Padding is always zeroed, so records can be compared and hashed as raw bytes.
+struct PackedInst {
+  static constexpr size_t NUM_ARGS = 3;
+
+  uint32_t op = 0;                      ///< Instruction id (in instruction library)
+  uint32_t tag = 0;                     ///< Instruction tag bits
+  int8_t args[NUM_ARGS] = {0, 0, 0};    ///< Instruction arguments
+  uint8_t unused[5] = {0, 0, 0, 0, 0};  ///< Padding (always 0)
+
+  PackedInst() = default;
+  PackedInst(uint32_t a_op, uint32_t a_tag, int8_t a0=0, int8_t a1=0, int8_t a2=0)
+    : op(a_op), tag(a_tag), args{a0, a1, a2} { ; }
+
+  bool operator==(const PackedInst& other) const {
+    return std::memcmp(this, &other, sizeof(PackedInst)) == 0;
+  }
+  bool operator!=(const PackedInst& other) const { return !(*this == other); }
+  bool operator<(const PackedInst& other) const {
+    return std::tie(op, tag, args[0], args[1], args[2])
+      < std::tie(other.op, other.tag, other.args[0], other.args[1], other.args[2]);
+  }
+};
+
+static_assert(sizeof(PackedInst) == 16, "PackedInst must be exactly 16 bytes.");
+
+/// Compact linear functions program: every instruction lives in one contiguous buffer
+/// (function by function), with a function offset table marking where each function begins.
+/// Supports programs with one tag per function/instruction (TAG_W <= 32) and up to three
+/// small (int8) instruction arguments. Convert to/from the SignalGP program type with
+/// FromProgram / ToProgram.
+template<size_t TAG_W>
+class PackedProgram {
+public:
+  static_assert(TAG_W > 0 && TAG_W <= 32, "PackedProgram tags must fit in 32 bits.");
+  static constexpr uint32_t TAG_MASK = (TAG_W == 32) ? ~(uint32_t)0 : (((uint32_t)1 << TAG_W) - 1);
+
+  using this_t = PackedProgram<TAG_W>;
+  using inst_t = PackedInst;
+
+protected:
+  emp::vector<inst_t> insts;              ///< All instructions (function 0, then function 1, ...)
+  emp::vector<uint32_t> func_offsets{0};  ///< Function f occupies insts[func_offsets[f], func_offsets[f+1])
+  emp::vector<uint32_t> func_tags;        ///< Per-function tag
+
+  /// Shift offsets of all functions after fID by delta instructions.
+  void ShiftOffsets(size_t fID, int64_t delta) {
+    for (size_t i = fID + 1; i < func_offsets.size(); ++i) {
+      func_offsets[i] = (uint32_t)((int64_t)func_offsets[i] + delta);
+    }
+  }
+
+public:
+
+  void Clear() {
+    insts.clear();
+    func_offsets.assign(1, 0);
+    func_tags.clear();
+  }
+
+  /// Number of functions
+  size_t GetSize() const { return func_tags.size(); }
+  /// Total number of instructions (across all functions)
+  size_t GetInstCount() const { return insts.size(); }
+  size_t GetFunctionSize(size_t fID) const {
+    emp_assert(fID < GetSize());
+    return func_offsets[fID + 1] - func_offsets[fID];
+  }
+  size_t GetFunctionOffset(size_t fID) const {
+    emp_assert(fID < func_offsets.size());
+    return func_offsets[fID];
+  }
+
+  uint32_t GetFunctionTag(size_t fID) const {
+    emp_assert(fID < GetSize());
+    return func_tags[fID];
+  }
+  void SetFunctionTag(size_t fID, uint32_t tag) {
+    emp_assert(fID < GetSize());
+    func_tags[fID] = tag & TAG_MASK;
+  }
+
+  const inst_t& GetInst(size_t fID, size_t iID) const {
+    emp_assert(iID < GetFunctionSize(fID));
+    return insts[func_offsets[fID] + iID];
+  }
+  inst_t& GetInst(size_t fID, size_t iID) {
+    emp_assert(iID < GetFunctionSize(fID));
+    return insts[func_offsets[fID] + iID];
+  }
+
+  /// Raw instruction buffer / tables (e.g., for whole-program passes)
+  const emp::vector<inst_t>& GetInsts() const { return insts; }
+  emp::vector<inst_t>& GetInsts() { return insts; }
+  const emp::vector<uint32_t>& GetFunctionOffsets() const { return func_offsets; }
+  const emp::vector<uint32_t>& GetFunctionTags() const { return func_tags; }
+  emp::vector<uint32_t>& GetFunctionTags() { return func_tags; }
+
+  const inst_t* FunctionBegin(size_t fID) const { return insts.data() + func_offsets[fID]; }
+  const inst_t* FunctionEnd(size_t fID) const { return insts.data() + func_offsets[fID + 1]; }
+
+  /// Append an (empty) function.
+  void PushFunction(uint32_t tag) {
+    func_tags.emplace_back(tag & TAG_MASK);
+    func_offsets.emplace_back((uint32_t)insts.size());
+  }
+
+  /// Remove the last function.
+  void PopFunction() {
+    emp_assert(GetSize() > 0);
+    func_tags.pop_back();
+    func_offsets.pop_back();
+    insts.resize(func_offsets.back());
+  }
+
+  /// Append instruction to the last function.
+  void PushInst(const inst_t& inst) {
+    emp_assert(GetSize() > 0);
+    insts.emplace_back(inst);
+    ++func_offsets.back();
+  }
+
+  /// Insert instruction into function fID before position iID.
+  void InsertInst(size_t fID, size_t iID, const inst_t& inst) {
+    emp_assert(iID <= GetFunctionSize(fID));
+    insts.insert(insts.begin() + func_offsets[fID] + iID, inst);
+    ShiftOffsets(fID, 1);
+  }
+
+  /// Insert instructions [begin, end) into function fID before position iID. Range must not alias this program's buffer.
+  void InsertInsts(size_t fID, size_t iID, const inst_t* begin, const inst_t* end) {
+    emp_assert(iID <= GetFunctionSize(fID));
+    emp_assert(end <= insts.data() || begin >= insts.data() + insts.size());
+    insts.insert(insts.begin() + func_offsets[fID] + iID, begin, end);
+    ShiftOffsets(fID, (int64_t)(end - begin));
+  }
+
+  /// Erase instructions [begin, end) from function fID.
+  void EraseInsts(size_t fID, size_t begin, size_t end) {
+    emp_assert(begin <= end && end <= GetFunctionSize(fID));
+    insts.erase(insts.begin() + func_offsets[fID] + begin, insts.begin() + func_offsets[fID] + end);
+    ShiftOffsets(fID, -(int64_t)(end - begin));
+  }
+
+  /// Replace function fID's instructions with [begin, end). Range must not alias this program's buffer.
+  void SetFunctionInsts(size_t fID, const inst_t* begin, const inst_t* end) {
+    emp_assert(fID < GetSize());
+    emp_assert(end <= insts.data() || begin >= insts.data() + insts.size());
+    const size_t old_size = GetFunctionSize(fID);
+    const size_t new_size = (size_t)(end - begin);
+    auto func_begin = insts.begin() + func_offsets[fID];
+    if (new_size > old_size) {
+      insts.insert(func_begin + old_size, new_size - old_size, inst_t());
+    } else if (new_size < old_size) {
+      insts.erase(func_begin + new_size, func_begin + old_size);
+    }
+    std::copy(begin, end, insts.begin() + func_offsets[fID]);
+    ShiftOffsets(fID, (int64_t)new_size - (int64_t)old_size);
+  }
+
+  /// Swap in a rebuilt instruction buffer and offset table (same number of functions).
+  /// Previous buffers are returned through new_insts / new_offsets (e.g., for reuse as scratch space).
+  void SwapBuffers(emp::vector<inst_t>& new_insts, emp::vector<uint32_t>& new_offsets) {
+    emp_assert(new_offsets.size() == func_offsets.size());
+    emp_assert(new_offsets.back() == new_insts.size());
+    std::swap(insts, new_insts);
+    std::swap(func_offsets, new_offsets);
+  }
+
+  /// Reset function boundaries after instructions were inserted/erased in place (via GetInsts).
+  /// new_sizes[f] is function f's new size (sizes must add up to the instruction count).
+  void SetFunctionSizes(const emp::vector<size_t>& new_sizes) {
+    emp_assert(new_sizes.size() == GetSize());
+    for (size_t fID = 0; fID < new_sizes.size(); ++fID) {
+      func_offsets[fID + 1] = func_offsets[fID] + (uint32_t)new_sizes[fID];
+    }
+    emp_assert(func_offsets.back() == insts.size());
+  }
+
+  /// Append a copy of function fID to the end of the program.
+  void DuplicateFunction(size_t fID) {
+    emp_assert(fID < GetSize());
+    const size_t begin = func_offsets[fID];
+    const size_t size = GetFunctionSize(fID);
+    insts.reserve(insts.size() + size);
+    for (size_t i = 0; i < size; ++i) {
+      insts.emplace_back(insts[begin + i]);
+    }
+    func_tags.emplace_back(func_tags[fID]);
+    func_offsets.emplace_back((uint32_t)insts.size());
+  }
+
+  /// Overwrite function fID with the last function, then remove the last function.
+  void RemoveFunctionSwapLast(size_t fID) {
+    emp_assert(fID < GetSize());
+    const size_t last = GetSize() - 1;
+    if (fID != last) {
+      const emp::vector<inst_t> last_insts(FunctionBegin(last), FunctionEnd(last));
+      func_tags[fID] = func_tags[last];
+      SetFunctionInsts(fID, last_insts.data(), last_insts.data() + last_insts.size());
+    }
+    PopFunction();
+  }
+
+  bool operator==(const this_t& other) const {
+    return func_tags == other.func_tags
+      && func_offsets == other.func_offsets
+      && insts.size() == other.insts.size()
+      && (insts.empty() || std::memcmp(insts.data(), other.insts.data(), insts.size() * sizeof(inst_t)) == 0);
+  }
+  bool operator!=(const this_t& other) const { return !(*this == other); }
+  bool operator<(const this_t& other) const {
+    return std::tie(func_tags, func_offsets, insts)
+      < std::tie(other.func_tags, other.func_offsets, other.insts);
+  }
+
+  /// FNV-1a hash over the function table and instruction buffer.
+  size_t Hash() const {
+    uint64_t hash = 14695981039346656037ULL;
+    auto mix = [&hash](uint64_t word) {
+      hash ^= word;
+      hash *= 1099511628211ULL;
+    };
+    mix(func_tags.size());
+    for (size_t fID = 0; fID < func_tags.size(); ++fID) {
+      mix(((uint64_t)func_tags[fID] << 32) | func_offsets[fID + 1]);
+    }
+    for (const inst_t& inst : insts) {
+      uint64_t words[2];
+      std::memcpy(words, &inst, sizeof(inst_t));
+      mix(words[0]);
+      mix(words[1]);
+    }
+    return (size_t)hash;
+  }
+
+  /// Print program in the (SignalGP) print format read by LoadLinearFunctionsProgram_PrintFormat.
+  template<typename INST_LIB_T>
+  void Print(std::ostream& out, const INST_LIB_T& ilib) const {
+    for (size_t fID = 0; fID < GetSize(); ++fID) {
+      out << "(";
+      PrintTag(out, func_tags[fID]);
+      out << ") Fn-" << fID << "\n";
+      for (const inst_t* inst = FunctionBegin(fID); inst != FunctionEnd(fID); ++inst) {
+        out << "  (";
+        PrintTag(out, inst->tag);
+        out << ") " << ilib.GetName(inst->op) << " [";
+        for (size_t k = 0; k < inst_t::NUM_ARGS; ++k) {
+          if (k) out << ", ";
+          out << (int)inst->args[k];
+        }
+        out << "]\n";
+      }
+    }
+  }
+
+  /// Print tag bits (highest bit first, as BitSet does).
+  static void PrintTag(std::ostream& out, uint32_t tag) {
+    for (size_t i = TAG_W; i > 0; --i) {
+      out << (((tag >> (i - 1)) & 1) ? '1' : '0');
+    }
+  }
+
+  /// Pack a tag (e.g., emp::BitSet<TAG_W>).
+  template<typename TAG_T>
+  static uint32_t PackTag(const TAG_T& tag) {
+    uint32_t packed = 0;
+    for (size_t i = 0; i < TAG_W; ++i) {
+      if (tag.Get(i)) packed |= (uint32_t)1 << i;
+    }
+    return packed;
+  }
+
+  /// Unpack a tag (e.g., into emp::BitSet<TAG_W>).
+  template<typename TAG_T>
+  static TAG_T UnpackTag(uint32_t packed) {
+    TAG_T tag;
+    tag.Clear();
+    for (size_t i = 0; i < TAG_W; ++i) {
+      tag.Set(i, (packed >> i) & 1);
+    }
+    return tag;
+  }
+
+  /// Build packed program from a SignalGP linear functions program (one tag per function/instruction,
+  /// at most three int8-ranged arguments per instruction).
+  template<typename PROGRAM_T>
+  static this_t FromProgram(const PROGRAM_T& program) {
+    this_t packed;
+    packed.insts.reserve(program.GetInstCount());
+    for (size_t fID = 0; fID < program.GetSize(); ++fID) {
+      const auto& func = program[fID];
+      emp_assert(func.GetTags().size() <= 1, "PackedProgram supports one tag per function.");
+      packed.PushFunction(func.GetTags().size() ? PackTag(func.GetTags()[0]) : 0);
+      for (size_t iID = 0; iID < func.GetSize(); ++iID) {
+        const auto& inst = func[iID];
+        emp_assert(inst.GetTags().size() <= 1, "PackedProgram supports one tag per instruction.");
+        emp_assert(inst.GetArgs().size() <= inst_t::NUM_ARGS);
+        inst_t packed_inst((uint32_t)inst.GetID(), inst.GetTags().size() ? PackTag(inst.GetTags()[0]) : 0);
+        for (size_t k = 0; k < inst.GetArgs().size(); ++k) {
+          emp_assert(inst.GetArgs()[k] >= INT8_MIN && inst.GetArgs()[k] <= INT8_MAX);
+          packed_inst.args[k] = (int8_t)inst.GetArgs()[k];
+        }
+        packed.PushInst(packed_inst);
+      }
+    }
+    return packed;
+  }
+
+  /// Build a SignalGP linear functions program (one tag per function/instruction, three arguments per instruction).
+  template<typename PROGRAM_T>
+  PROGRAM_T ToProgram() const {
+    using function_t = typename PROGRAM_T::function_t;
+    using sgp_inst_t = typename PROGRAM_T::inst_t;
+    using tag_t = typename std::decay<decltype(std::declval<function_t>().GetTags()[0])>::type;
+    PROGRAM_T program;
+    for (size_t fID = 0; fID < GetSize(); ++fID) {
+      function_t func(emp::vector<tag_t>{UnpackTag<tag_t>(func_tags[fID])});
+      for (const inst_t* inst = FunctionBegin(fID); inst != FunctionEnd(fID); ++inst) {
+        sgp_inst_t sgp_inst;
+        sgp_inst.id = inst->op;
+        sgp_inst.GetArgs().assign(inst->args, inst->args + inst_t::NUM_ARGS);
+        sgp_inst.GetTags().assign(1, UnpackTag<tag_t>(inst->tag));
+        func.PushInst(sgp_inst);
+      }
+      program.PushFunction(func);
+    }
+    return program;
+  }
+
+};
+
+}
+
+namespace std {
+
+template<size_t TAG_W>
+struct hash<psynth::PackedProgram<TAG_W>> {
+  size_t operator()(const psynth::PackedProgram<TAG_W>& program) const { return program.Hash(); }
+};
+
+}
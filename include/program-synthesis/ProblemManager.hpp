@@ -18,14 +18,17 @@
 
 namespace psynth {
 
-template<typename HARDWARE_T>
+template<
+  typename HARDWARE_T,
+  typename ORG_T=ProgSynthOrg<typename HARDWARE_T::program_t>
+>
 class ProblemManager {
 public:
 
   using sgp_hardware_t = HARDWARE_T;
   using inst_lib_t = typename sgp_hardware_t::inst_lib_t;
   using sgp_program_t = typename sgp_hardware_t::program_t;
-  using org_t = ProgSynthOrg<sgp_program_t>;
+  using org_t = ORG_T;
   using event_lib_t = typename sgp_hardware_t::event_lib_t;
 
   template<typename PROBLEM_T>
@@ -15,7 +15,14 @@ EMP_BUILD_CONFIG(ProgSynthConfig,
   GROUP(SELECTION, "Selection settings"),
   VALUE(SELECTION, std::string, "tournament", "Selection scheme to use"),
   VALUE(TOURNAMENT_SIZE, size_t, 4, "Tournament size for selection schemes that use tournaments"),
-  VALUE(AGE_LEX_AGE_ORDER_LIMIT, size_t, 100, "Age functions must appear within this limit in the shuffled order of eval criteria."),
+  VALUE(TRUNCATION_SIZE, size_t, 8, "Number of top-scoring candidates kept by truncation selection"),
+  VALUE(AGE_LEX_AGE_ORDER_LIMIT, size_t, 100, "Age (or novelty) functions must appear within this limit in the shuffled order of eval criteria."),
+  VALUE(LEXICASE_BATCH_SIZE, size_t, 1, "Maximum number of parents selected from each shuffled lexicase ordering (1 = standard lexicase)."),
+  VALUE(LEXICASE_RANK_COMPRESSION, bool, true, "Should lexicase filter on dense per-test score ranks (falls back to raw scores for tests with too many distinct values)?"),
+  VALUE(NOVELTY_K, size_t, 15, "Novelty: number of nearest neighbours (in test pass space) used to compute an organism's novelty"),
+  VALUE(NOVELTY_ARCHIVE_SIZE, size_t, 1000, "Novelty: maximum number of archived phenotypes"),
+  VALUE(NOVELTY_ARCHIVE_ADD_RATE, double, 0.01, "Novelty: per-organism probability of being added to the novelty archive each generation"),
+  VALUE(NOVELTY_MAX_CHECKS, size_t, 1024, "Novelty: maximum distance computations per organism when finding nearest neighbours (0 = exact search)"),
 
   GROUP(ORG_INJECTION, "Org injection settings"),
   VALUE(ORG_INJECTION_MODE, std::string, "none", "Should we inject new organisms every X generations?"),
@@ -33,10 +40,13 @@ EMP_BUILD_CONFIG(ProgSynthConfig,
   VALUE(ANCESTOR_FILE_PATH, std::string, "ancestor.json", "Path to ancestor file"),
 
   GROUP(EVALUATION, "How are organisms evaluated?"),
-  VALUE(EVAL_MODE, std::string, "full", "Evaluation mode. Options:\nfull\ncohort\ndown-sample"),
+  VALUE(EVAL_MODE, std::string, "full", "Evaluation mode. Options:\nfull\ncohort\ndown-sample\ninformed-down-sample\nlazy (lexicase only; training cases evaluated as selection looks at them)"),
   VALUE(EVAL_CPU_CYCLES_PER_TEST, size_t, 128, "Maximum number of CPU cycles programs are run for single test case."),
   VALUE(NUM_COHORTS, size_t, 2, "How many cohorts should we divide the tests and organisms into?"),
   VALUE(TEST_DOWNSAMPLE_RATE, double, 0.5, "Proportion of training cases to down-sample each generation"),
+  VALUE(IDS_PARENT_SAMPLE_RATE, double, 0.01, "Informed down-sampling: proportion of the population evaluated on all training cases to build test distances"),
+  VALUE(IDS_REFRESH_INTERVAL, size_t, 10, "Informed down-sampling: how often (in generations) should test distances be rebuilt?"),
+  VALUE(LAZY_EVAL_BATCH_SIZE, size_t, 1, "Lazy evaluation: when selection needs a program's score on a training case, also evaluate it on this many upcoming cases (including the current one) before loading the next program. Values > 1 reload programs less often, but look-ahead evaluations count toward MAX_EVALS even if selection never looks at them (1 = only evaluate what selection looks at)."),
 
   GROUP(SGP_CPU, "SignalGP Virtual CPU"),
   VALUE(MAX_ACTIVE_THREAD_CNT, size_t, 8, "Maximum number of active threads that can run simultaneously on a SGP virtual CPU."),
@@ -64,6 +74,7 @@ EMP_BUILD_CONFIG(ProgSynthConfig,
   VALUE(MUT_RATE_FUNC_TAG_SINGLE_BF, double, 0.0, "Per-tag single bit flip rate"),
   VALUE(MUT_RATE_INST_TAG_SEQ_RAND, double, 0.0, "Per-tag sequence randomization rate"),
   VALUE(MUT_RATE_FUNC_TAG_SEQ_RAND, double, 0.0, "Per-tag sequence randomization rate"),
+  VALUE(MUT_THREADS, size_t, 1, "Number of threads used to mutate offspring (1 = mutate serially during birth). Results are reproducible for a given seed and thread count."),
 
   GROUP(OUTPUT, "Output settings"),
   VALUE(OUTPUT_DIR, std::string, "./output/", "What directory are we dumping all this data"),
@@ -72,6 +83,7 @@ EMP_BUILD_CONFIG(ProgSynthConfig,
   VALUE(SNAPSHOT_INTERVAL, size_t, 100, "How often should we snapshot?"),
   VALUE(TRACK_PHYLOGENY, bool, false, "Track phylogenies?"),
   VALUE(RECORD_PHYLO_GENOTYPES, bool, false, "Output phylogeny genotypes when taking a phylogeny snapshot?"),
+  VALUE(OUTPUT_SELECTION_PROFILE, bool, true, "Output lexicase selection profile (selection_profile.csv)? Only applies to lexicase-based selection schemes."),
 
   GROUP(MUTATION_ANALYSIS, "Mutation analysis settings"),
   VALUE(MUTATION_ANALYSIS_MODE, bool, false, "Run in mutation analysis mode?"),
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <utility>
+
 namespace psynth {
 
 template<typename PROGRAM_T>
@@ -11,8 +13,11 @@ struct ProgSynthGenome {
   size_t age; ///< Not used for equality check (age shouldn't determine equality of two genotypes)
 
   ProgSynthGenome(const program_t& p) : program(p), age(0) {}
+  ProgSynthGenome(program_t&& p) : program(std::move(p)), age(0) {}
   ProgSynthGenome(const this_t&) = default;
   ProgSynthGenome(this_t&&) = default;
+  this_t& operator=(const this_t&) = default; ///< Reuses this genome's program storage
+  this_t& operator=(this_t&&) = default;
 
   // NOTE: Operator == does not use age for equality
   bool operator==(const this_t& other) const {
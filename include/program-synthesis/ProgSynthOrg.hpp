@@ -2,9 +2,12 @@
 
 #include <algorithm>
 #include <tuple>
+#include <utility>
 
 #include "emp/base/vector.hpp"
 
+#include "../utility/ObjectPool.hpp"
+
 #include "ProgSynthGenome.hpp"
 #include "ProgSynthPhenotype.hpp"
 #include "TestResult.hpp"
@@ -18,8 +21,11 @@ public:
   using program_t = PROGRAM_T;
   using phenotype_t = ProgSynthPhenotype;
   using genome_t = ProgSynthGenome<PROGRAM_T>;
+  using pool_t = utils::ObjectPool<this_t>;
 
 protected:
+  static inline pool_t* pool = nullptr; ///< Where organisms are allocated (nullptr = global heap)
+
   phenotype_t phenotype;
   genome_t genome;
 
@@ -32,9 +38,32 @@ public:
     genome(g)
   { ; }
 
+  ProgSynthOrg(genome_t&& g) :
+    phenotype(),
+    genome(std::move(g))
+  { ; }
+
   ProgSynthOrg(const ProgSynthOrg&) = default;
   ProgSynthOrg(ProgSynthOrg&&) = default;
 
+  /// Route organism allocation through a_pool (nullptr to use the global heap).
+  /// Organisms already allocated elsewhere are still released to wherever they came from.
+  static void SetPool(pool_t* a_pool) { pool = a_pool; }
+  static pool_t* GetPool() { return pool; }
+
+  static void* operator new(size_t size) {
+    if (pool != nullptr && size == sizeof(this_t)) return pool->Allocate();
+    return ::operator new(size);
+  }
+
+  static void operator delete(void* ptr) {
+    if (pool != nullptr && pool->Owns(ptr)) {
+      pool->Deallocate(ptr);
+      return;
+    }
+    ::operator delete(ptr);
+  }
+
   genome_t& GetGenome() { return genome; }
   const genome_t& GetGenome() const { return genome; }
 
@@ -44,12 +73,9 @@ public:
   size_t GetPopID() const { return pop_id; }
   void SetPopID(size_t id) { pop_id = id; }
 
-  void ResetPhenotype(size_t num_tests=1) {
-    phenotype.Reset(num_tests);
-  }
-
-  void UpdatePhenotype(size_t test_id, const TestResult& test_result) {
-    phenotype.Update(test_id, test_result);
+  /// Point organism's phenotype at row in store (phenotype data lives in the store).
+  void BindPhenotype(const ScoreStore& store, size_t row) {
+    phenotype.Bind(store, row);
   }
 
 };
@@ -2,114 +2,87 @@
 
 #include <utility>
 #include <algorithm>
+#include <cstdint>
 
 #include "emp/base/vector.hpp"
+#include "emp/bits/BitVector.hpp"
 
-#include "TestResult.hpp"
+#include "ScoreStore.hpp"
 
 namespace psynth {
 
+/// Organism phenotype: a handle to the organism's row in the population's ScoreStore.
+/// Phenotype data (scores, passes, evaluated tests, aggregate score) lives in the store;
+/// binding, copying, and moving a phenotype are O(1).
 class ProgSynthPhenotype {
 public:
   using this_t = ProgSynthPhenotype;
 protected:
-
-  emp::vector<double> test_scores;   ///< Scores on tests.
-  // emp::vector<bool> test_passes;     ///< Pass/fail on tests
-  emp::BitVector test_passes;
-  emp::vector<bool> test_evaluated;  ///< Whether a test has been evaluated.
-
-  double aggregate_score = 0.0;
-  size_t num_passes = 0;
-  bool is_solution = false;
+  const ScoreStore* store = nullptr;  ///< Store holding this phenotype (nullptr = unbound)
+  size_t row = 0;                     ///< Row (organism id) in store
 
 public:
-  void Reset(size_t num_tests=1) {
-    aggregate_score = 0.0;
-    num_passes = 0;
-    is_solution = false;
-
-    test_scores.resize(num_tests);
-    std::fill(
-      test_scores.begin(),
-      test_scores.end(),
-      0
-    );
-
-    test_evaluated.resize(num_tests);
-    std::fill(
-      test_evaluated.begin(),
-      test_evaluated.end(),
-      false
-    );
-
-    test_passes.resize(num_tests);
-    test_passes.Clear();
-    // std::fill(
-    //   test_passes.begin(),
-    //   test_passes.end(),
-    //   false
-    // );
+  /// Point phenotype at row a_row of a_store.
+  void Bind(const ScoreStore& a_store, size_t a_row) {
+    emp_assert(a_row < a_store.GetNumOrgs());
+    store = &a_store;
+    row = a_row;
   }
 
-  void Update(size_t test_id, const TestResult& test_result, bool evaluated=true) {
-    test_scores[test_id] = test_result.score;
-    test_passes[test_id] = test_result.is_correct;
-    test_evaluated[test_id] = evaluated;
-    num_passes += (size_t)test_result.is_correct;
-    aggregate_score += test_result.score;
-  }
+  bool IsBound() const { return store != nullptr; }
+  size_t GetRow() const { return row; }
 
-  bool operator==(const this_t& o) const {
-    // Only use scores and is solution to test equality
-    return std::tie(
-      test_scores,
-      is_solution
-    ) == std::tie(
-      o.test_scores,
-      o.is_solution
-    );
+  size_t GetNumTests() const {
+    emp_assert(IsBound());
+    return store->GetNumTests();
   }
 
-  bool operator!=(const this_t& o) const {
-    return !(*this == o);
-  }
-
-  bool operator<(const this_t& o) const {
-    // Only use scores and is solution for comparison
-    return std::tie(
-      test_scores,
-      is_solution
-    ) < std::tie(
-      o.test_scores,
-      o.is_solution
-    );
+  double GetAggregateScore() const {
+    emp_assert(IsBound());
+    return store->GetAggregate(row);
   }
 
-  double GetAggregateScore() const {
-    return aggregate_score;
+  size_t GetNumPasses() const {
+    emp_assert(IsBound());
+    return store->GetNumPassed(row);
   }
 
   bool PassedTest(size_t test_id) const {
-    return test_passes[test_id];
+    emp_assert(IsBound());
+    return store->Passed(row, test_id);
   }
 
   double GetTestScore(size_t test_id) const {
-    return test_scores[test_id];
+    emp_assert(IsBound());
+    return store->GetScore(row, test_id);
   }
 
   bool TestEvaluated(size_t test_id) const {
-    return test_evaluated[test_id];
+    emp_assert(IsBound());
+    return store->IsEvaluated(row, test_id);
   }
 
-  const emp::vector<double>& GetTestScores() const {
-    return test_scores;
+  /// Copy of test scores
+  emp::vector<double> GetTestScores() const {
+    emp_assert(IsBound());
+    return store->GetScores(row);
   }
 
-  const emp::BitVector& GetTestPasses() const {
-    return test_passes;
+  /// Copy of test passes
+  emp::BitVector GetTestPasses() const {
+    emp_assert(IsBound());
+    emp::BitVector passes(store->GetNumTests());
+    const uint64_t* pass_row = store->PassRow(row);
+    for (size_t w = 0; w < store->GetNumWords(); ++w) {
+      uint64_t word = pass_row[w];
+      while (word) {
+        passes.Set((w * 64) + (size_t)__builtin_ctzll(word));
+        word &= word - 1;
+      }
+    }
+    return passes;
   }
 
 };
 
-}
\ No newline at end of file
+}
@@ -30,6 +30,9 @@
 #include "../utility/printing.hpp"
 #include "../selection/SelectionSchemes.hpp"
 #include "../utility/pareto.hpp"
+#include "../utility/memory.hpp"
+#include "../utility/AllocationTracker.hpp"
+#include "../utility/ThreadPool.hpp"
 
 #include "ProgSynthConfig.hpp"
 #include "ProgSynthOrg.hpp"
@@ -41,6 +44,8 @@
 #include "program_utils.hpp"
 #include "ProgSynthTaxonInfo.hpp"
 #include "RecombinerLinearFunctionsProgram.hpp"
+#include "ScoreStore.hpp"
+#include "SharedProgram.hpp"
 
 // TODO - Allow for non-functional fitness functions to be used in lexicase selection
 // Features:
@@ -60,7 +65,15 @@ constexpr size_t INST_ARG_CNT = 3;
 using TAG_T = emp::BitSet<TAG_SIZE>;
 using INST_ARG_T = int;
 using PROGRAM_T = sgp::cpu::lfunprg::LinearFunctionsProgram<TAG_T, INST_ARG_T>;
-using ORGANISM_T = ProgSynthOrg<PROGRAM_T>;
+// Genome program representation. PROGRAM_T (above) is always used for execution.
+// PSYNTH_SHARED_GENOMES: genomes are hash-consed SharedPrograms (functions shared across the
+// population and phylogeny; copies are cheap, mutation only re-creates changed functions).
+#ifdef PSYNTH_SHARED_GENOMES
+using GENOME_PROGRAM_T = SharedProgram<TAG_SIZE>;
+#else
+using GENOME_PROGRAM_T = PROGRAM_T;
+#endif
+using ORGANISM_T = ProgSynthOrg<GENOME_PROGRAM_T>;
 using MEMORY_MODEL_T = sgp::cpu::mem::BasicMemoryModel;
 using MATCHBIN_T = emp::MatchBin<
   size_t,
@@ -81,6 +94,7 @@ public:
   using hw_memory_model_t = world_defs::MEMORY_MODEL_T;
   using hw_matchbin_t = world_defs::MATCHBIN_T;
   using program_t = world_defs::PROGRAM_T;
+  using genome_program_t = world_defs::GENOME_PROGRAM_T;
   using inst_t = typename program_t::inst_t;
   using inst_arg_t = world_defs::INST_ARG_T;
   using tag_t = world_defs::TAG_T;
@@ -123,18 +137,57 @@ public:
   static constexpr size_t INST_TAG_CNT = world_defs::INST_TAG_CNT;
   static constexpr size_t INST_ARG_CNT = world_defs::INST_ARG_CNT;
 
-  struct PhenUnionInfo {
-    emp::BitVector phen_union;
-    std::pair<size_t, size_t> org_ids;
-    PhenUnionInfo(
-      size_t org_a_id,
-      const emp::BitVector& org_a_phen,
-      size_t org_b_id,
-      const emp::BitVector& org_b_phen
-    ) :
-      phen_union(org_a_phen.OR(org_b_phen)),
-      org_ids(org_a_id, org_b_id)
-    { ; }
+  /// Heap allocations made during each phase of a generation (see RunStep; requires PSYNTH_TRACK_ALLOCATIONS)
+  struct PhaseAllocations {
+    utils::AllocationCounts evaluation;
+    utils::AllocationCounts selection;  ///< Selection and births (includes offspring mutation)
+    utils::AllocationCounts injection;
+    utils::AllocationCounts update;     ///< Output and population update (recorded for the previous generation)
+  };
+
+  /// Mutations applied to the offspring of a single generation (reset each generation in DoSelection)
+  struct MutationStats {
+    mutator_t::mutation_counts_t counts;  ///< Mutations applied (by type)
+    size_t num_offspring = 0;
+    size_t num_unmutated = 0;             ///< Offspring with no mutations (i.e., copies of their parent)
+    size_t total_mutations = 0;
+
+    void Reset() {
+      counts.Reset();
+      num_offspring = 0;
+      num_unmutated = 0;
+      total_mutations = 0;
+    }
+
+    /// Record a single offspring (mut_cnt: mutations applied to it).
+    void RecordOffspring(size_t mut_cnt) {
+      ++num_offspring;
+      total_mutations += mut_cnt;
+      if (!mut_cnt) ++num_unmutated;
+    }
+
+    double GetMeanMutations() const {
+      return (num_offspring) ? (double)total_mutations / (double)num_offspring : 0.0;
+    }
+
+    double GetUnmutatedFraction() const {
+      return (num_offspring) ? (double)num_unmutated / (double)num_offspring : 0.0;
+    }
+  };
+
+  /// Bytes held by each world subsystem (see UpdateMemoryStats)
+  struct MemoryStats {
+    size_t genome_bytes = 0;           ///< Population (and recycled) genome programs
+    size_t shared_function_bytes = 0;  ///< Shared function table (only used with PSYNTH_SHARED_GENOMES)
+    size_t org_pool_bytes = 0;         ///< Organism pool slots
+    size_t phenotype_bytes = 0;        ///< Organism phenotype handles and per-organism ages
+    size_t score_table_bytes = 0;      ///< Score store and per-organism, per-test fitness functions
+    size_t selection_bytes = 0;        ///< Selector, novelty archive, and selection id buffers
+    size_t systematics_bytes = 0;      ///< Phylogeny taxa (genomes, phenotypes, true scores)
+    size_t num_taxa = 0;               ///< Taxa tracked by systematics
+    size_t injection_bytes = 0;        ///< Org injection buffers (including pair analysis scratch)
+    size_t rss_bytes = 0;              ///< Process resident set size
+    size_t peak_rss_bytes = 0;         ///< Process peak resident set size
   };
 
 protected:
@@ -146,8 +199,12 @@ protected:
   inst_lib_t inst_lib;                          ///< SGP instruction library
   event_lib_t event_lib;                        ///< SGP event library
   emp::Ptr<mutator_t> mutator = nullptr;        ///< Handles SGP program mutation
+  emp::vector<mutator_t> thread_mutators;       ///< Per-thread mutator clones (parallel offspring mutation only)
+  emp::vector<emp::Random> thread_randoms;      ///< Per-thread random streams (reseeded from random_ptr every generation)
+  utils::ThreadPool mutation_threads;           ///< Persistent worker threads for parallel offspring mutation
+  MutationStats mutation_stats;                 ///< Mutations applied to this generation's offspring
 
-  ProblemManager<hardware_t> problem_manager; ///< Manages interface to program synthesis problem
+  ProblemManager<hardware_t, org_t> problem_manager; ///< Manages interface to program synthesis problem
   size_t event_id_numeric_input_sig = 0;      ///< SGP event ID for numeric input signals
 
   size_t total_training_cases = 0;   ///< Tracks the total number of training cases being used
@@ -160,16 +217,42 @@ protected:
 
   size_t test_order_barrier = 0; ///< Used to mark which tests have been moved to front this generation
 
+  bool warned_inexact_scores = false;           ///< Have we warned that score storage changed a recorded score?
+  bool lazy_evaluation = false;                 ///< Are training cases evaluated on demand (during selection) instead of in DoEvaluation?
+  size_t eval_hardware_org_id = (size_t)-1;     ///< Population ID of organism whose program is loaded on eval hardware ((size_t)-1 = unknown)
+  program_t exec_program;                       ///< Execution form of a (shared) genome program (only used with PSYNTH_SHARED_GENOMES)
+
   size_t max_fit_id = 0;     ///< Tracks the "elite" organism each generation (based on trait estimates)
   double max_fit = 0.0;      ///< Tracks the "elite" organism aggregate score each generation (based on trait estimates)
 
   std::function<bool(void)> stop_run;               ///< Returns whether we've hit configured stopping condition
+
+  /// Genome program in execution (SignalGP) form
+  const program_t& GetExecProgram(const genome_program_t& program) {
+    #ifdef PSYNTH_SHARED_GENOMES
+    exec_program = program.template ToProgram<program_t>();
+    return exec_program;
+    #else
+    return program;
+    #endif
+  }
+
+  /// Genome program from execution (SignalGP) form
+  static genome_program_t ToGenomeProgram(const program_t& program) {
+    #ifdef PSYNTH_SHARED_GENOMES
+    return genome_program_t::FromProgram(program);
+    #else
+    return program;
+    #endif
+  }
   std::function<bool(void)> is_final_update;        ///< Returns whether we're on the final update for this run
   std::function<bool(size_t)> check_org_solution;   ///< Checks whether a given organism is a solution (needs to be configured based on evalution mode)
 
+  emp::Signal<void(void)> begin_pop_evaluation_sig;   ///< Triggered at beginning of population evaluation (in DoEvaluation), before groupings are updated
   emp::Signal<void(size_t)> begin_org_evaluation_sig; ///< Triggered at beginning of an organism's evaluation (in DoEvaluation). Handles phenotype / internal tracking resets
   emp::Signal<void(size_t)> do_org_evaluation_sig;    ///< Evaluates organism on trigger
   emp::Signal<void(size_t)> end_org_evaluation_sig;
+  emp::Signal<void(void)> end_pop_evaluation_sig;     ///< Triggered at end of population evaluation (in DoEvaluation), after aggregate scores are computed
 
   emp::Signal<void(org_t&)> begin_program_eval_sig; ///< Triggered at beginning of program evaluation (program loaded on hardware).
 
@@ -185,21 +268,19 @@ protected:
     emp::vector< std::function<double(void)> >
   > fit_fun_set;       ///< Per-organism, per-test
 
-  emp::vector<
-    std::function<double(void)>
-  > agg_score_fun_set; ///< Per-organism, aggregate score
-
   // std::function<double(size_t, size_t)> estimate_test_score; ///< Estimates test score
   // std::function<double(const phylo::TraitEstInfo&)> adjust_estimate;
 
-  emp::vector<bool> pop_training_coverage;    ///< Per-trait population coverage
   double pop_num_training_cases_covered;
-  emp::vector<double> org_aggregate_scores;   ///< Per-organism aggregate scores (using estimated score)
-  emp::vector<size_t> org_training_coverage;  ///< Per-organism training case coverage
-  emp::vector<size_t> org_num_training_cases; ///< Per-organism number of training cases organism has been evaluated against
-  emp::vector< emp::vector<double> > org_training_scores;    ///< Per-organism, scores for each training case
-  emp::vector< emp::vector<bool> > org_training_evaluations; ///< Per-organism, evaluated on training case?
-  // emp::vector<emp::BitVector> org_training_passes;
+  ScoreStore score_store;                     ///< Per-organism training case scores, evaluations, passes, aggregates; population coverage
+  emp::vector<size_t> org_ages;               ///< Per-organism genome age (maintained on placement)
+  emp::vector<genome_t> spare_genomes;        ///< Genome storage harvested from the previous generation (reused by births and injections)
+  org_t::pool_t org_pool;                     ///< Organism storage for the current and next populations (2x POP_SIZE)
+  emp::vector<genome_t> offspring_genomes;    ///< Parallel mutation: offspring genomes (mutated before birth)
+  emp::vector<size_t> offspring_mut_counts;   ///< Parallel mutation: mutations applied to each offspring
+  #ifdef PSYNTH_SHARED_GENOMES
+  emp::vector<typename mutator_t::packed_program_t> offspring_unpacked; ///< Parallel mutation: mutable offspring programs (repacked serially)
+  #endif
 
   // std::unordered_set<size_t> performance_criteria_ids;
   std::unordered_set<size_t> nonperformance_criteria_ids;
@@ -210,8 +291,10 @@ protected:
   emp::vector<size_t> all_org_ids;
   emp::vector<size_t> all_training_case_ids;            ///< Contains ids of all training cases
   emp::Ptr<selection::BaseSelect> selector = nullptr;   ///< Pointer to selector
+  emp::Ptr<selection::NoveltyArchive> novelty_archive = nullptr; ///< Tracks organism novelty (only used by novelty-based selection)
   emp::vector<size_t> selected_parent_ids;              ///< Contains ids of all selected organisms
   emp::vector<size_t> all_testing_case_ids;             ///< Contains ids of all testing cases (order will be manipualted as we go)
+  emp::vector<size_t> ids_profile_org_ids;              ///< Used by informed down-sampling to sample organisms for building test profiles
 
   std::function<void(void)> run_selection_routine;      ///< Runs selection (needs to be configured differently depending on whether we're estimating fitness or not). Calls selection_fun.
   selection_fun_t selection_fun;                        ///< Interface to selection call
@@ -224,8 +307,18 @@ protected:
   emp::Ptr<emp::DataFile> summary_file_ptr = nullptr;         ///< Manages summary output file
   emp::Ptr<emp::DataFile> phylodiversity_file_ptr = nullptr;  ///< Manages phylodiversity output file
   emp::Ptr<emp::DataFile> elite_file_ptr = nullptr;           ///< Manages elite output file
+  emp::Ptr<emp::DataFile> selection_profile_file_ptr = nullptr; ///< Manages selection profile output file
+  emp::Ptr<emp::DataFile> memory_file_ptr = nullptr;          ///< Manages memory accounting output file
+  emp::Ptr<emp::DataFile> allocations_file_ptr = nullptr;     ///< Manages allocation tracking output file (PSYNTH_TRACK_ALLOCATIONS only)
+  emp::Ptr<emp::DataFile> mutations_file_ptr = nullptr;       ///< Manages mutation spectrum output file
 
   SelectedStatistics selection_stats; ///< Utility struct that manages selection statistics
+  selection::SelectionProfile selection_profile; ///< Lexicase selection event histograms (reset each generation)
+  bool profile_selection = false;                ///< Is the configured selector recording into selection_profile?
+
+  MemoryStats memory_stats;          ///< Bytes held per subsystem (updated at each summary data interval)
+  PhaseAllocations phase_allocations; ///< Heap allocations per phase of the most recent generation
+  utils::AllocationStopwatch allocation_stopwatch;
 
   size_t num_to_inject = 0; ///< How many new organisms to inject this generation?
   size_t num_to_select = 0;
@@ -236,6 +329,10 @@ protected:
   // emp::vector<std::pair<size_t, size_t>> complementary_phen_pairs;
   emp::vector<size_t> complementary_pair_ids; // Ids meaningful only in context of inject_org function
   emp::vector<size_t> front_pair_ids;
+  emp::vector<uint64_t> pair_union_rows;                   ///< Unique phenotype unions of population pairs (row-major, score store words per row)
+  emp::vector<std::pair<size_t, size_t>> pair_org_ids;     ///< Population ids of each unique-union pair
+  emp::vector<size_t> pair_union_slots;                    ///< Open-addressing table of pair ids (+1) used to find duplicate unions (load factor <= 0.5)
+  emp::vector<uint64_t> pair_union_scratch;                ///< Union of the pair currently being analyzed
 
   // emp::vector<size_t> recombine_sources; ///< IDs of orgs to recombine
   // std::function<void(void)> identify_
@@ -263,6 +360,8 @@ protected:
   void SetupEvaluation_Full();
   void SetupEvaluation_Cohort();
   void SetupEvaluation_DownSample();
+  void SetupEvaluation_InformedDownSample();
+  void SetupEvaluation_Lazy();
 
   void SetupSelection_Lexicase();
   void SetupSelection_AgeLexicase();
@@ -270,6 +369,8 @@ protected:
   void SetupSelection_Truncation();
   void SetupSelection_None();
   void SetupSelection_Random();
+  void SetupSelection_NSGA2();
+  void SetupSelection_NoveltyLexicase();
 
   void SetupStoppingCondition_Generations();
   void SetupStoppingCondition_Evaluations();
@@ -277,6 +378,11 @@ protected:
   void SetupDataCollection_Phylodiversity();
   void SetupDataCollection_Summary();
   void SetupDataCollection_Elite();
+  void SetupDataCollection_SelectionProfile();
+  void SetupDataCollection_Memory();
+  void SetupDataCollection_Allocations();
+  void SetupDataCollection_Mutations();
+  void UpdateMemoryStats();
 
   void InitializePopulation();
   void InitializePopulation_LoadSingle();
@@ -287,12 +393,23 @@ protected:
   void DoUpdate();
   void DoInjections();
 
+  genome_t CopyGenome(const genome_t& src);
+  void DoBirthFrom(genome_t&& genome, size_t parent_pos);
+  void InjectFrom(genome_t&& genome, emp::WorldPosition pos);
+  void RecycleGenomes();
+  void MutateOffspringParallel();
+
   void SnapshotConfig();
   void SnapshotSolution();
   void SnapshotPhylogeny();
   void SnapshotPhyloGenotypes();
 
-  void FindParetoFrontPairs(const emp::vector< ProgSynthWorld::PhenUnionInfo >& phen_pairs);
+  void UpdateTestProfiles();
+  void EvaluateTrainingCase(size_t org_id, size_t test_id);
+  void UpdateElite();
+  void FinishLazyEvaluation();
+
+  void FindParetoFrontPairs();
 
 public:
 
@@ -307,12 +424,20 @@ public:
   }
 
   ~ProgSynthWorld() {
+    // Return all organisms to the pool before it goes away.
+    Clear();
+    if (org_t::GetPool() == &org_pool) { org_t::SetPool(nullptr); }
     if (eval_hardware != nullptr) { eval_hardware.Delete(); }
     if (mutator != nullptr) { mutator.Delete(); }
     if (selector != nullptr) { selector.Delete(); }
+    if (novelty_archive != nullptr) { novelty_archive.Delete(); }
     if (phylodiversity_file_ptr != nullptr) { phylodiversity_file_ptr.Delete(); }
     if (summary_file_ptr != nullptr) { summary_file_ptr.Delete(); }
     if (elite_file_ptr != nullptr) { elite_file_ptr.Delete(); }
+    if (selection_profile_file_ptr != nullptr) { selection_profile_file_ptr.Delete(); }
+    if (memory_file_ptr != nullptr) { memory_file_ptr.Delete(); }
+    if (allocations_file_ptr != nullptr) { allocations_file_ptr.Delete(); }
+    if (mutations_file_ptr != nullptr) { mutations_file_ptr.Delete(); }
     if (org_groupings != nullptr) { org_groupings.Delete(); }
     if (test_groupings != nullptr) { test_groupings.Delete(); }
   }
@@ -334,15 +459,29 @@ public:
     return total_training_cases;
   }
 
+  /// @brief Per-organism genome ages (population-indexed)
+  const emp::vector<size_t>& GetOrgAges() const { return org_ages; }
+
+  size_t GetOrgAge(size_t org_id) const {
+    emp_assert(org_id < org_ages.size());
+    emp_assert(org_ages[org_id] == GetOrg(org_id).GetGenome().GetAge());
+    return org_ages[org_id];
+  }
+
 };
 
 void ProgSynthWorld::RunStep() {
   emp_assert(world_configured);
+  // Previous lap covers the previous generation's update phase (or setup)
+  phase_allocations.update = allocation_stopwatch.Lap();
   calc_next_gen_sources(); // Compute num to select vs inject
   emp_assert((num_to_select + num_to_inject) == config.POP_SIZE());
   DoEvaluation();
+  phase_allocations.evaluation = allocation_stopwatch.Lap();
   DoSelection();
+  phase_allocations.selection = allocation_stopwatch.Lap();
   DoInjections();
+  phase_allocations.injection = allocation_stopwatch.Lap();
   DoUpdate();
 }
 
@@ -360,28 +499,22 @@ void ProgSynthWorld::Run() {
 }
 
 void ProgSynthWorld::DoEvaluation() {
-  emp_assert(pop_training_coverage.size() == total_training_cases);
-  emp_assert(org_aggregate_scores.size() == config.POP_SIZE());
+  emp_assert(score_store.GetNumTests() == total_training_cases);
+  emp_assert(score_store.GetNumOrgs() == config.POP_SIZE());
   emp_assert(fit_fun_set.size() == config.POP_SIZE());
-  emp_assert(org_training_scores.size() == config.POP_SIZE());
-  // emp_assert(org_training_passes.size() == config.POP_SIZE());
-  emp_assert(org_training_coverage.size() == config.POP_SIZE());
-  emp_assert(org_num_training_cases.size() == config.POP_SIZE());
 
   // Reset ID of true max fitness organism
   max_fit_id = config.POP_SIZE() + 1;
   max_fit = 0.0;
 
+  begin_pop_evaluation_sig.Trigger();
+
   // Update test and organism groupings
   org_groupings->UpdateGroupings();
   test_groupings->UpdateGroupings();
 
   // Reset population-level training case coverage
-  std::fill(
-    pop_training_coverage.begin(),
-    pop_training_coverage.end(),
-    false
-  );
+  score_store.ResetPopCoverage();
 
   pop_num_training_cases_covered = 0.0;
 
@@ -390,11 +523,8 @@ void ProgSynthWorld::DoEvaluation() {
   // Evaluate each organism
   for (size_t org_id = 0; org_id < GetSize(); ++org_id) {
     // --- Begin organism evaluation: ---
-    // - Reset org aggregate score (world)
-    // - Reset org training coverage (world)
-    // - Reset org num training cases (world)
-    // - Reset org training scores (world)
-    // - Reset org phenotype (org)
+    // - Reset org's score store row (world); i.e., the org's phenotype:
+    //   - training scores, evaluated / passed bits, aggregate score
     begin_org_evaluation_sig.Trigger(org_id);
 
     // --- Do organism evaluation: ---
@@ -410,13 +540,9 @@ void ProgSynthWorld::DoEvaluation() {
     //     - Execute program for configured number of CPU cycles
     //   - Trigger end_program_test_sig
     //     - Use problem manager to evaluate hardware output
-    //     - org.UpdatePhenotype()
-    //     - Update world performance tracking:
-    //       - org_training_scores
-    //       - org_training_evaluations
-    //       - org_training_coverage
-    //       - org_num_training_cases
-    //       - pop_training_coverage
+    //     - Update world performance tracking (score_store):
+    //       - scores, evaluated / passed bits, aggregate score
+    //       - population coverage
     // - Increment total test evaluations
     do_org_evaluation_sig.Trigger(org_id);
 
@@ -425,21 +551,24 @@ void ProgSynthWorld::DoEvaluation() {
     // - Check if need to check candidate against testing set
     //   - If so, check if organism is a solution using the testing set
     // Record taxon information
-    end_org_evaluation_sig.Trigger(org_id);
+    // (Lazy evaluation: organisms haven't been run yet; see FinishLazyEvaluation)
+    if (!lazy_evaluation) end_org_evaluation_sig.Trigger(org_id);
   }
 
-  // Estimate aggregate fitness for each organism
-  // Need to do this separately to ensure all possible descendants of current taxa have been evaluated
-  // Otherwise, estimation can crash
+  // Lazy evaluation: training cases are evaluated as selection looks at them.
+  if (lazy_evaluation) return;
 
-  // org_training_scores
-  // org_training_evaluations
+  UpdateElite();
+
+  end_pop_evaluation_sig.Trigger();
+
+}
+
+// Find the elite organism. Aggregate scores are maintained by the score store as results are recorded.
+// Need to do this after all organisms have been evaluated.
+void ProgSynthWorld::UpdateElite() {
   for (size_t org_id = 0; org_id < GetSize(); ++org_id) {
-    double agg_score = 0.0;
-    for (size_t test_id = 0; test_id < total_training_cases; ++test_id) {
-      agg_score += org_training_scores[org_id][test_id] * (size_t)org_training_evaluations[org_id][test_id];
-    }
-    org_aggregate_scores[org_id] = agg_score;
+    const double agg_score = score_store.GetAggregate(org_id);
 
     // Update identity of elite organism if necessary
     if ((agg_score > max_fit) || (max_fit_id >= config.POP_SIZE()) ) {
@@ -451,20 +580,97 @@ void ProgSynthWorld::DoEvaluation() {
   // If we found a solution, guarantee that the found solution is marked as the elite organism
   if (found_solution) {
     max_fit_id = solution_id;
-    max_fit = org_aggregate_scores[solution_id];
+    max_fit = score_store.GetAggregate(solution_id);
   }
+}
 
+// Wrap up a lazily evaluated generation (after selection has evaluated the training cases it needed).
+void ProgSynthWorld::FinishLazyEvaluation() {
+  emp_assert(lazy_evaluation);
+  for (size_t org_id = 0; org_id < GetSize(); ++org_id) {
+    end_org_evaluation_sig.Trigger(org_id);
+  }
+  UpdateElite();
+  end_pop_evaluation_sig.Trigger();
 }
 
 void ProgSynthWorld::DoSelection() {
   // Run configured selection routine
   run_selection_routine();
+  if (lazy_evaluation) {
+    FinishLazyEvaluation();
+  }
   emp_assert(selected_parent_ids.size() + num_to_inject == config.POP_SIZE());
   // std::cout << "DoSelection(): " << selected_parent_ids.size() << std::endl;
+  mutation_stats.Reset();
   // Each selected parent id reproduces
+  // NOTE: parents cannot donate their genomes here; end-of-generation output still reads them.
+  if (thread_mutators.size()) {
+    // Mutate all offspring up front (in parallel), then place them.
+    MutateOffspringParallel();
+    for (size_t i = 0; i < selected_parent_ids.size(); ++i) {
+      DoBirthFrom(std::move(offspring_genomes[i]), selected_parent_ids[i]);
+    }
+  } else {
+    // Offspring are mutated as they are born (see SetupMutator).
+    for (size_t id : selected_parent_ids) {
+      DoBirthFrom(CopyGenome(GetGenomeAt(id)), id);
+    }
+  }
+}
+
+/// Copy and mutate the genomes of all selected parents' offspring (into offspring_genomes) using
+/// MUT_THREADS threads (mutation_threads, whose workers persist across generations). Offspring are
+/// split into contiguous blocks (one per thread); each thread has its own mutator clone and random
+/// stream (reseeded from the world's random number generator each generation), so results are
+/// reproducible for a given seed and thread count.
+void ProgSynthWorld::MutateOffspringParallel() {
+  const size_t num_offspring = selected_parent_ids.size();
+  const size_t num_threads = thread_mutators.size();
+  // Genome copies (and shared genome function table updates) happen serially.
+  offspring_genomes.clear();
   for (size_t id : selected_parent_ids) {
-    DoBirth(GetGenomeAt(id), id);
+    offspring_genomes.emplace_back(CopyGenome(GetGenomeAt(id)));
+  }
+  offspring_mut_counts.resize(num_offspring);
+  #ifdef PSYNTH_SHARED_GENOMES
+  if (offspring_unpacked.size() < num_offspring) offspring_unpacked.resize(num_offspring);
+  #endif
+  for (emp::Random& rnd : thread_randoms) {
+    rnd.ResetSeed(random_ptr->GetInt(1, std::numeric_limits<int>::max()));
+  }
+
+  auto mutate_block = [this, num_offspring, num_threads](size_t thread_id) {
+    const size_t begin = (num_offspring * thread_id) / num_threads;
+    const size_t end = (num_offspring * (thread_id + 1)) / num_threads;
+    mutator_t& thread_mutator = thread_mutators[thread_id];
+    emp::Random& rnd = thread_randoms[thread_id];
+    thread_mutator.ResetLastMutationTracker(); // Accumulates over this thread's block
+    for (size_t i = begin; i < end; ++i) {
+      genome_t& genome = offspring_genomes[i];
+      #ifdef PSYNTH_SHARED_GENOMES
+      offspring_mut_counts[i] = thread_mutator.ApplyAllUnpacked(rnd, genome.GetProgram(), offspring_unpacked[i]);
+      #else
+      offspring_mut_counts[i] = thread_mutator.ApplyAll(rnd, genome.GetProgram());
+      #endif
+      genome.IncAge(1);
+    }
+  };
+  emp_assert(mutation_threads.GetNumThreads() == num_threads);
+  mutation_threads.Run(mutate_block);
+
+  // Merge per-thread mutation counts
+  for (const mutator_t& thread_mutator : thread_mutators) {
+    mutation_stats.counts += thread_mutator.GetLastMutations();
+  }
+  for (size_t mut_cnt : offspring_mut_counts) {
+    mutation_stats.RecordOffspring(mut_cnt);
+  }
+  #ifdef PSYNTH_SHARED_GENOMES
+  for (size_t i = 0; i < num_offspring; ++i) {
+    if (offspring_mut_counts[i]) offspring_genomes[i].GetProgram().Repack(offspring_unpacked[i]);
   }
+  #endif
 }
 
 void ProgSynthWorld::DoInjections() {
@@ -474,6 +680,49 @@ void ProgSynthWorld::DoInjections() {
   }
 }
 
+/// Copy src into genome storage recycled from the previous generation (if any is available).
+ProgSynthWorld::genome_t ProgSynthWorld::CopyGenome(const genome_t& src) {
+  if (spare_genomes.empty()) return genome_t(src);
+  genome_t genome(std::move(spare_genomes.back()));
+  spare_genomes.pop_back();
+  genome = src;
+  return genome;
+}
+
+/// Move-based equivalent of emp::World::DoBirth (single offspring).
+void ProgSynthWorld::DoBirthFrom(genome_t&& genome, size_t parent_pos) {
+  before_repro_sig.Trigger(parent_pos);
+  emp::Ptr<org_t> new_org = emp::NewPtr<org_t>(std::move(genome));
+  offspring_ready_sig.Trigger(*new_org, parent_pos);
+  const emp::WorldPosition pos = fun_find_birth_pos(new_org, parent_pos);
+  if (pos.IsValid()) {
+    for (auto s : systematics) {
+      s->SetNextParent(parent_pos);
+    }
+    AddOrgAt(new_org, pos, parent_pos);
+  } else {
+    new_org.Delete();
+  }
+}
+
+/// Move-based equivalent of emp::World::InjectAt.
+void ProgSynthWorld::InjectFrom(genome_t&& genome, emp::WorldPosition pos) {
+  emp_assert(pos.IsValid());
+  emp::Ptr<org_t> new_org = emp::NewPtr<org_t>(std::move(genome));
+  inject_ready_sig.Trigger(*new_org);
+  AddOrgAt(new_org, pos);
+}
+
+/// Harvest genome storage from the outgoing generation (call right before a synchronous Update).
+void ProgSynthWorld::RecycleGenomes() {
+  if (pops[1].size() == 0) return;
+  for (size_t pos = 0; pos < pops[0].size(); ++pos) {
+    if (spare_genomes.size() >= config.POP_SIZE()) break;
+    if (!IsOccupied(pos)) continue;
+    spare_genomes.emplace_back(std::move(GetOrg(pos).GetGenome()));
+  }
+}
+
 void ProgSynthWorld::DoUpdate() {
   // (1) Compute any per-generation statistics / intervals?
   emp_assert(config.PRINT_INTERVAL() > 0);
@@ -491,14 +740,24 @@ void ProgSynthWorld::DoUpdate() {
       selected_parent_ids,
       *this
     );
-    pop_num_training_cases_covered = std::accumulate(
-      pop_training_coverage.begin(),
-      pop_training_coverage.end(),
-      0
-    );
+    pop_num_training_cases_covered = score_store.GetPopCoverage();
+    if (!warned_inexact_scores && score_store.GetNumInexact() > 0) {
+      std::cout << "Warning: " << ScoreStore::codec_t::name << " score storage has changed " << score_store.GetNumInexact();
+      std::cout << " recorded score(s) (" << ScoreStore::codec_t::caveat << ")." << std::endl;
+      warned_inexact_scores = true;
+    }
     // Update summary file
     summary_file_ptr->Update();
     elite_file_ptr->Update();
+    if (selection_profile_file_ptr != nullptr) {
+      selection_profile_file_ptr->Update();
+    }
+    UpdateMemoryStats();
+    memory_file_ptr->Update();
+    if (allocations_file_ptr != nullptr) {
+      allocations_file_ptr->Update();
+    }
+    mutations_file_ptr->Update();
     if (track_phylo) {
       phylodiversity_file_ptr->Update();
     }
@@ -526,6 +785,7 @@ void ProgSynthWorld::DoUpdate() {
   }
 
   // (4) Update!
+  RecycleGenomes();
   Update();
 }
 
@@ -548,13 +808,21 @@ void ProgSynthWorld::Setup() {
   // Setup the population structure
   SetPopStruct_Mixed(true);
 
+  // Organisms (current + next population) are allocated from the world's pool
+  org_pool.Reserve(2 * config.POP_SIZE());
+  org_t::SetPool(&org_pool);
+
 
   // Configure world to set organism ID on placement
   OnPlacement(
     [this](size_t pos) {
       auto& org = GetOrg(pos);
       org.SetPopID(pos);
-      org.ResetPhenotype(total_training_cases);
+      // Phenotype is a handle to the organism's score store row (reset at the start of evaluation)
+      org.BindPhenotype(score_store, pos);
+      // Births and injections both land here (ages are final by the time an organism is placed).
+      if (pos >= org_ages.size()) org_ages.resize(pos + 1, 0);
+      org_ages[pos] = org.GetGenome().GetAge();
       emp_assert(org.GetPopID() == pos);
     }
   );
@@ -585,8 +853,10 @@ void ProgSynthWorld::Setup() {
   SetupDataCollection();
   // Initialize population!
   InitializePopulation();
-  // SetAutoMutate!
-  SetAutoMutate();
+  // SetAutoMutate! (parallel mutation happens before birth; see DoSelection)
+  if (thread_mutators.empty()) {
+    SetAutoMutate();
+  }
   // Output a snapshot of the run configuration
   SnapshotConfig();
   world_configured = true;
@@ -723,10 +993,25 @@ void ProgSynthWorld::SetupMutator() {
         rnd,
         org.GetGenome().GetProgram()
       );
+      mutation_stats.counts += mutator->GetLastMutations();
+      mutation_stats.RecordOffspring(mut_cnt);
       org.GetGenome().IncAge(1);
       return mut_cnt;
     }
   );
+
+  // Parallel offspring mutation: one mutator clone (with its own scratch space) per thread
+  thread_mutators.clear();
+  thread_randoms.clear();
+  mutation_threads.Stop();
+  if (config.MUT_THREADS() > 1) {
+    std::cout << "  - Mutating offspring with " << config.MUT_THREADS() << " threads." << std::endl;
+    for (size_t thread_id = 0; thread_id < config.MUT_THREADS(); ++thread_id) {
+      thread_mutators.emplace_back(*mutator);
+      thread_randoms.emplace_back(1);
+    }
+    mutation_threads.Start(config.MUT_THREADS());
+  }
 }
 
 // TODO - if using age, add non-performance criteria to all test groupings
@@ -741,39 +1026,18 @@ void ProgSynthWorld::SetupEvaluation() {
 
   org_groupings = emp::NewPtr<utils::GroupManager>(*random_ptr);
   test_groupings = emp::NewPtr<utils::GroupManager>(*random_ptr);
+  lazy_evaluation = false;
 
   // Total tests is equal to number of tests we loaded into the testing set.
   total_training_cases = problem_manager.GetTrainingSetSize();
   total_testing_cases = problem_manager.GetTestingSetSize();
-  // Allocate space for tracking organism training coverage
-  org_training_coverage.clear();
-  org_training_coverage.resize(config.POP_SIZE(), 0);
-  // Allocate space for tracking number of training cases an organism is evaluated against
-  org_num_training_cases.clear();
-  org_num_training_cases.resize(config.POP_SIZE(), 0);
-  // Allocate space for tracking organism aggregate scores
-  org_aggregate_scores.clear();
-  org_aggregate_scores.resize(config.POP_SIZE(), 0.0);
-  // Allocate space for tracking population-wide test coverage
-  pop_training_coverage.clear();
-  pop_training_coverage.resize(total_training_cases, false);
-  // Allocate space for tracking organism test scores
-  org_training_scores.clear();
-  org_training_scores.resize(
-    config.POP_SIZE(),
-    emp::vector<double>(total_training_cases, 0.0)
-  );
-  // org_training_passes.clear();
-  // org_training_passes.resize(
-  //   config.POP_SIZE(),
-  //   emp::BitVector(total_training_cases, false)
-  // );
-  // Allocate space for tracking organism test evaluations
-  org_training_evaluations.clear();
-  org_training_evaluations.resize(
-    config.POP_SIZE(),
-    emp::vector<bool>(total_training_cases, false)
-  );
+  // Allocate space for tracking organism training case results (scores, evaluations, passes,
+  // aggregate scores) and population-wide training case coverage
+  score_store.Resize(config.POP_SIZE(), total_training_cases);
+  if (std::string(ScoreStore::codec_t::caveat) != "") {
+    std::cout << "Warning: score storage type " << ScoreStore::codec_t::name << " is lossy: " << ScoreStore::codec_t::caveat << "." << std::endl;
+    std::cout << "  This can change which candidates tie (and therefore selection outcomes) on problems with non-discrete scores." << std::endl;
+  }
 
   // Create vector with all ids for population
   all_org_ids.resize(config.POP_SIZE());
@@ -811,9 +1075,11 @@ void ProgSynthWorld::SetupEvaluation() {
   );
 
   // Clear out all actions associated with organism evaluation.
+  begin_pop_evaluation_sig.Clear();
   begin_org_evaluation_sig.Clear();
   do_org_evaluation_sig.Clear();
   end_org_evaluation_sig.Clear();
+  end_pop_evaluation_sig.Clear();
 
   begin_program_eval_sig.Clear();
   begin_program_test_sig.Clear();
@@ -823,22 +1089,8 @@ void ProgSynthWorld::SetupEvaluation() {
   // Configure organism evaluation signals
   begin_org_evaluation_sig.AddAction(
     [this](size_t org_id) {
-      // 0-out aggregate score
-      org_aggregate_scores[org_id] = 0.0;
-      // 0-out training coverage
-      org_training_coverage[org_id] = 0;
-      // 0-out num training cases evaluated against
-      org_num_training_cases[org_id] = 0;
-      // 0 out organism's training score
-      std::fill(
-        org_training_scores[org_id].begin(),
-        org_training_scores[org_id].end(),
-        0.0
-      );
-
-      // Reset phenotype
-      auto& org = GetOrg(org_id);
-      org.ResetPhenotype(total_training_cases);
+      // 0-out training scores, evaluations, coverage, and aggregate score (i.e., reset phenotype)
+      score_store.ResetOrg(org_id);
     }
   );
 
@@ -851,8 +1103,8 @@ void ProgSynthWorld::SetupEvaluation() {
         taxon_t& taxon = *(systematics_ptr->GetTaxonAt(org_id));
         taxon.GetData().RecordFitness(org.GetPhenotype().GetAggregateScore());
         taxon.GetData().RecordPhenotype(
-          org.GetPhenotype().GetTestScores(),
-          org_training_evaluations[org_id]
+          score_store.GetStoredScores(org_id),
+          score_store.GetEvaluated(org_id)
         );
       }
 
@@ -860,7 +1112,8 @@ void ProgSynthWorld::SetupEvaluation() {
       // - Need to check if num_passes == number of tests evaluated on
       // - If so, add to vector of ids to be tested whether they are solutions
       // - Allow each evaluation mode to implement the actual testing
-      if ((org_training_coverage[org_id] == org_num_training_cases[org_id]) && !found_solution) {
+      const size_t num_evaluated = score_store.GetNumEvaluated(org_id);
+      if ((num_evaluated > 0) && (score_store.GetNumPassed(org_id) == num_evaluated) && !found_solution) {
         found_solution = check_org_solution(org_id);
         solution_id = org_id;
       }
@@ -871,7 +1124,8 @@ void ProgSynthWorld::SetupEvaluation() {
   begin_program_eval_sig.AddAction(
     [this](org_t& org) {
       // Load program onto evaluation hardware unit
-      eval_hardware->SetProgram(org.GetGenome().GetProgram());
+      eval_hardware->SetProgram(GetExecProgram(org.GetGenome().GetProgram()));
+      eval_hardware_org_id = org.GetPopID();
     }
   );
 
@@ -917,27 +1171,11 @@ void ProgSynthWorld::SetupEvaluation() {
         test_id,
         true
       );
-      // Record result on organism phenotype
-      org.UpdatePhenotype(test_id, result);
-      // World performance tracking
-      org_training_scores[org_id][test_id] = result.score;
-      org_training_evaluations[org_id][test_id] = true;
-      org_training_coverage[org_id] += (size_t)result.is_correct;
-      org_num_training_cases[org_id] += 1;
-      pop_training_coverage[test_id] = pop_training_coverage[test_id] || result.is_correct;
+      // Record result (organism phenotype + world performance tracking)
+      score_store.Record(org_id, test_id, result.score, result.is_correct);
     }
   );
 
-  // Configure the aggregate score functions
-  agg_score_fun_set.clear();
-  for (size_t org_id = 0; org_id < config.POP_SIZE(); ++org_id) {
-    agg_score_fun_set.emplace_back(
-      [this, org_id]() {
-        emp_assert(org_id < org_aggregate_scores.size());
-        return org_aggregate_scores[org_id];
-      }
-    );
-  }
   // std::cout << "Non perf shared ids: " << nonperf_fit_fun_shared_ids << std::endl;
   // Configure the fitness functions (per-organism, per-test)
   fit_fun_set.clear();
@@ -946,12 +1184,14 @@ void ProgSynthWorld::SetupEvaluation() {
     for (size_t test_id = 0; test_id < total_training_cases; ++test_id) {
       fit_fun_set[org_id].emplace_back(
         [this, org_id, test_id]() -> double {
-          emp_assert(org_id < org_training_evaluations.size());
-          emp_assert(org_id < org_training_scores.size());
-          emp_assert(test_id < org_training_evaluations[org_id].size());
-          emp_assert(test_id < org_training_scores[org_id].size());
-          if (org_training_evaluations[org_id][test_id]) {
-            return org_training_scores[org_id][test_id];
+          emp_assert(org_id < score_store.GetNumOrgs());
+          emp_assert(test_id < score_store.GetNumTests());
+          if (score_store.IsEvaluated(org_id, test_id)) {
+            return score_store.GetScore(org_id, test_id);
+          } else if (lazy_evaluation) {
+            // Evaluate on first access (memoized in score_store)
+            EvaluateTrainingCase(org_id, test_id);
+            return score_store.GetScore(org_id, test_id);
           } else {
             return 0.0;
           }
@@ -979,6 +1219,10 @@ void ProgSynthWorld::SetupEvaluation() {
     SetupEvaluation_Cohort();
   } else if (config.EVAL_MODE() == "down-sample") {
     SetupEvaluation_DownSample();
+  } else if (config.EVAL_MODE() == "informed-down-sample") {
+    SetupEvaluation_InformedDownSample();
+  } else if (config.EVAL_MODE() == "lazy") {
+    SetupEvaluation_Lazy();
   } else {
     std::cout << "Unknown EVAL_MODE: " << config.EVAL_MODE() << std::endl;
     exit(-1);
@@ -1086,7 +1330,7 @@ void ProgSynthWorld::SetupEvaluation_Cohort() {
       const auto& cohort_test_ids = test_group.GetMembers();
       for (size_t i = 0; i < cohort_test_ids.size(); ++i) {
         const size_t test_id = cohort_test_ids[i];
-        emp_assert(test_id < org.GetPhenotype().GetTestScores().size());
+        emp_assert(test_id < org.GetPhenotype().GetNumTests());
         begin_program_test_sig.Trigger(org, test_id, true);
         do_program_test_sig.Trigger(org, test_id);
         end_program_test_sig.Trigger(org, test_id);
@@ -1142,6 +1386,141 @@ void ProgSynthWorld::SetupEvaluation_DownSample() {
   );
 }
 
+void ProgSynthWorld::SetupEvaluation_InformedDownSample() {
+  std::cout << "Configuring evaluation mode: informed-down-sample" << std::endl;
+  emp_assert(config.TEST_DOWNSAMPLE_RATE() > 0);
+  emp_assert(config.TEST_DOWNSAMPLE_RATE() <= 1.0);
+  emp_assert(config.IDS_REFRESH_INTERVAL() > 0);
+  emp_assert(total_training_cases > 0);
+
+  size_t sample_size = (size_t)(config.TEST_DOWNSAMPLE_RATE() * (double)total_training_cases);
+  sample_size = (sample_size == 0) ? sample_size + 1 : sample_size;
+  emp_assert(sample_size > 0);
+  emp_assert(sample_size <= total_training_cases);
+
+  size_t num_profile_orgs = (size_t)(config.IDS_PARENT_SAMPLE_RATE() * (double)config.POP_SIZE());
+  num_profile_orgs = emp::Max(num_profile_orgs, (size_t)1);
+  num_profile_orgs = emp::Min(num_profile_orgs, config.POP_SIZE());
+  ids_profile_org_ids.resize(config.POP_SIZE());
+  std::iota(
+    ids_profile_org_ids.begin(),
+    ids_profile_org_ids.end(),
+    0
+  );
+
+  std::cout << "Informed down-sample: sample_size = " << sample_size << std::endl;
+  std::cout << "Informed down-sample: " << num_profile_orgs << " organisms profiled every " << config.IDS_REFRESH_INTERVAL() << " generations" << std::endl;
+  std::cout << "  - Profile evaluations per refresh: " << num_profile_orgs * total_training_cases << std::endl;
+  std::cout << "  - Evaluations saved per generation: " << config.POP_SIZE() * (total_training_cases - sample_size) << std::endl;
+
+  // Configure test groupings
+  test_groupings->SetInformedDownSampleMode(sample_size);
+  // Configure organism groupings
+  org_groupings->SetSingleGroupMode();
+
+  // Rebuild test profiles every IDS_REFRESH_INTERVAL generations (before groupings are updated)
+  begin_pop_evaluation_sig.AddAction(
+    [this]() {
+      if (GetUpdate() % config.IDS_REFRESH_INTERVAL()) return;
+      UpdateTestProfiles();
+    }
+  );
+
+  // Configure organism evaluation
+  do_org_evaluation_sig.AddAction(
+    [this](size_t org_id) {
+      emp_assert(org_id < GetSize());
+      auto& org = GetOrg(org_id);
+      begin_program_eval_sig.Trigger(org);
+      const auto& test_group = test_groupings->GetGroup(0);
+      const auto& test_ids = test_group.GetMembers();
+      for (size_t i = 0; i < test_ids.size(); ++i) {
+        const size_t test_id = test_ids[i]; // Test test id from group
+        // Handles test input:
+        begin_program_test_sig.Trigger(org, test_id, true);
+        // Runs the program:
+        do_program_test_sig.Trigger(org, test_id);
+        // Handles test output evaluation, updates phenotype:
+        end_program_test_sig.Trigger(org, test_id);
+        ++total_test_evaluations;
+      }
+    }
+  );
+}
+
+void ProgSynthWorld::SetupEvaluation_Lazy() {
+  std::cout << "Configuring evaluation mode: lazy" << std::endl;
+  emp_assert(total_training_cases > 0);
+  // Only lexicase selection knows which scores it needs.
+  if (config.SELECTION() != "lexicase") {
+    std::cout << "Lazy evaluation requires lexicase selection (SELECTION = " << config.SELECTION() << ")" << std::endl;
+    exit(-1);
+  }
+  lazy_evaluation = true;
+
+  // Selection sees all organisms and all training cases (as in full evaluation).
+  test_groupings->SetSingleGroupMode();
+  org_groupings->SetSingleGroupMode();
+  emp_assert(test_groupings->GetNumGroups() == org_groupings->GetNumGroups());
+
+  // Population changed since programs were last loaded
+  begin_pop_evaluation_sig.AddAction(
+    [this]() {
+      eval_hardware_org_id = (size_t)-1;
+    }
+  );
+
+  // No do_org_evaluation actions: training cases are evaluated (via fit_fun_set) when lexicase first looks at them.
+}
+
+// Evaluate organism on a single training case (lazy evaluation), loading its program only if it
+// isn't already on the evaluation hardware.
+void ProgSynthWorld::EvaluateTrainingCase(size_t org_id, size_t test_id) {
+  emp_assert(org_id < GetSize());
+  emp_assert(!score_store.IsEvaluated(org_id, test_id));
+  auto& org = GetOrg(org_id);
+  if (eval_hardware_org_id != org_id) {
+    begin_program_eval_sig.Trigger(org);
+  }
+  emp_assert(eval_hardware_org_id == org_id);
+  begin_program_test_sig.Trigger(org, test_id, true);
+  do_program_test_sig.Trigger(org, test_id);
+  end_program_test_sig.Trigger(org, test_id);
+  ++total_test_evaluations;
+}
+
+// Evaluate a small random sample of the population on all training cases, recording
+// which sampled organisms pass each training case as that training case's profile.
+// Does not modify organism phenotypes or world performance tracking.
+void ProgSynthWorld::UpdateTestProfiles() {
+  emp_assert(ids_profile_org_ids.size() == GetSize());
+  size_t num_profile_orgs = (size_t)(config.IDS_PARENT_SAMPLE_RATE() * (double)GetSize());
+  num_profile_orgs = emp::Max(num_profile_orgs, (size_t)1);
+  num_profile_orgs = emp::Min(num_profile_orgs, GetSize());
+  test_groupings->ResetMemberProfiles(num_profile_orgs);
+  // Partial shuffle to choose organisms to profile
+  for (size_t i = 0; i < num_profile_orgs; ++i) {
+    const size_t j = i + random_ptr->GetUInt(ids_profile_org_ids.size() - i);
+    std::swap(ids_profile_org_ids[i], ids_profile_org_ids[j]);
+  }
+  for (size_t profile_i = 0; profile_i < num_profile_orgs; ++profile_i) {
+    auto& org = GetOrg(ids_profile_org_ids[profile_i]);
+    begin_program_eval_sig.Trigger(org);
+    for (size_t test_id : all_training_case_ids) {
+      begin_program_test_sig.Trigger(org, test_id, true);
+      do_program_test_sig.Trigger(org, test_id);
+      TestResult result = problem_manager.EvaluateOutput(
+        *eval_hardware,
+        org,
+        test_id,
+        true
+      );
+      test_groupings->SetMemberProfileBit(test_id, profile_i, result.is_correct);
+      ++total_test_evaluations;
+    }
+  }
+}
+
 void ProgSynthWorld::SetupSelection() {
   std::cout << "Configuring parent selection routine" << std::endl;
   // TODO - Can I have different worlds share selection routine setups?
@@ -1150,6 +1529,8 @@ void ProgSynthWorld::SetupSelection() {
   run_selection_routine = [this]() {
     // Resize parent ids to hold pop_size parents
     selected_parent_ids.resize(num_to_select, 0);
+    // Selection profile covers a single generation
+    selection_profile.Reset();
     emp_assert(test_groupings->GetNumGroups() == org_groupings->GetNumGroups());
     const size_t num_groups = org_groupings->GetNumGroups();
     // For each grouping, select a number of parents equal to group size
@@ -1196,6 +1577,10 @@ void ProgSynthWorld::SetupSelection() {
     SetupSelection_None();
   } else if (config.SELECTION() == "random" ) {
     SetupSelection_Random();
+  } else if (config.SELECTION() == "nsga2" ) {
+    SetupSelection_NSGA2();
+  } else if (config.SELECTION() == "novelty-lexicase" ) {
+    SetupSelection_NoveltyLexicase();
   } else {
     std::cout << "Unknown selection scheme: " << config.SELECTION() << std::endl;
     exit(-1);
@@ -1208,6 +1593,14 @@ void ProgSynthWorld::SetupSelection_Lexicase() {
     fit_fun_set,
     *random_ptr
   );
+  selector.Cast<selection::LexicaseSelect>()->SetRankCompression(config.LEXICASE_RANK_COMPRESSION());
+  selector.Cast<selection::LexicaseSelect>()->SetBatchSize(config.LEXICASE_BATCH_SIZE());
+  selector.Cast<selection::LexicaseSelect>()->SetLazyScores(lazy_evaluation);
+  selector.Cast<selection::LexicaseSelect>()->SetLazyBatchSize(config.LAZY_EVAL_BATCH_SIZE());
+  if (config.OUTPUT_SELECTION_PROFILE()) {
+    selector.Cast<selection::LexicaseSelect>()->SetProfile(&selection_profile);
+    profile_selection = true;
+  }
 
   selection_fun = [this](
     size_t n,
@@ -1233,7 +1626,7 @@ void ProgSynthWorld::SetupSelection_AgeLexicase() {
   for (size_t org_id = 0; org_id < config.POP_SIZE(); ++org_id) {
     nonperf_fit_funs[org_id].emplace_back(
       [this, org_id]() -> double {
-        return -1.0 * (double)GetOrg(org_id).GetGenome().GetAge();
+        return -1.0 * (double)org_ages[org_id];
       }
     );
   }
@@ -1246,6 +1639,13 @@ void ProgSynthWorld::SetupSelection_AgeLexicase() {
 
   auto& sel = *(selector.Cast<selection::AgeLexicaseSelect>());
   sel.SetAgeFunOrderLimit(config.AGE_LEX_AGE_ORDER_LIMIT());
+  sel.SetRankCompression(config.LEXICASE_RANK_COMPRESSION());
+  sel.SetBatchSize(config.LEXICASE_BATCH_SIZE());
+  sel.SetAgeSource(&org_ages);
+  if (config.OUTPUT_SELECTION_PROFILE()) {
+    sel.SetProfile(&selection_profile);
+    profile_selection = true;
+  }
 
   selection_fun = [this](
     size_t n,
@@ -1261,7 +1661,7 @@ void ProgSynthWorld::SetupSelection_AgeLexicase() {
 
 void ProgSynthWorld::SetupSelection_Tournament() {
   selector = emp::NewPtr<selection::TournamentSelect>(
-    agg_score_fun_set,
+    score_store.GetAggregates(),
     *random_ptr,
     config.TOURNAMENT_SIZE()
   );
@@ -1278,18 +1678,135 @@ void ProgSynthWorld::SetupSelection_Tournament() {
 }
 
 void ProgSynthWorld::SetupSelection_Truncation() {
-  // TODO - trunction selection
-  emp_assert(false);
+  selector = emp::NewPtr<selection::TruncationSelect>(
+    score_store.GetAggregates(),
+    *random_ptr,
+    config.TRUNCATION_SIZE()
+  );
+
+  selection_fun = [this](
+    size_t n,
+    const emp::vector<size_t>& org_group,
+    const emp::vector<size_t>& test_group
+  ) -> emp::vector<size_t>& {
+    // Cast selector to truncation selection
+    auto& sel = *(selector.Cast<selection::TruncationSelect>());
+    return sel(n, org_group);
+  };
 }
 
 void ProgSynthWorld::SetupSelection_None() {
-  // TODO - No selection
-  emp_assert(false);
+  selector = emp::NewPtr<selection::NoSelect>(
+    config.POP_SIZE()
+  );
+
+  selection_fun = [this](
+    size_t n,
+    const emp::vector<size_t>& org_group,
+    const emp::vector<size_t>& test_group
+  ) -> emp::vector<size_t>& {
+    // Cast selector to no selection
+    auto& sel = *(selector.Cast<selection::NoSelect>());
+    return sel(n, org_group);
+  };
 }
 
 void ProgSynthWorld::SetupSelection_Random() {
-  // TODO - Random selection
-  emp_assert(false);
+  selector = emp::NewPtr<selection::RandomSelect>(
+    *random_ptr,
+    config.POP_SIZE()
+  );
+
+  selection_fun = [this](
+    size_t n,
+    const emp::vector<size_t>& org_group,
+    const emp::vector<size_t>& test_group
+  ) -> emp::vector<size_t>& {
+    // Cast selector to random selection
+    auto& sel = *(selector.Cast<selection::RandomSelect>());
+    return sel(n, org_group);
+  };
+}
+
+void ProgSynthWorld::SetupSelection_NSGA2() {
+  selector = emp::NewPtr<selection::NSGA2Select>(
+    fit_fun_set,
+    *random_ptr
+  );
+
+  selection_fun = [this](
+    size_t n,
+    const emp::vector<size_t>& org_group,
+    const emp::vector<size_t>& test_group
+  ) -> emp::vector<size_t>& {
+    // Cast selector to NSGA-II selection
+    auto& sel = *(selector.Cast<selection::NSGA2Select>());
+    return sel(n, org_group, test_group);
+  };
+}
+
+void ProgSynthWorld::SetupSelection_NoveltyLexicase() {
+  novelty_archive = emp::NewPtr<selection::NoveltyArchive>(
+    *random_ptr,
+    config.NOVELTY_K(),
+    config.NOVELTY_ARCHIVE_SIZE(),
+    config.NOVELTY_ARCHIVE_ADD_RATE()
+  );
+  if (config.NOVELTY_MAX_CHECKS() > 0) {
+    novelty_archive->SetMaxChecks(config.NOVELTY_MAX_CHECKS());
+  }
+
+  // After evaluation, update novelty from each organism's (packed) training case passes
+  end_pop_evaluation_sig.AddAction(
+    [this]() {
+      novelty_archive->Update(
+        score_store.GetPassRows(),
+        GetSize(),
+        score_store.GetNumWords()
+      );
+    }
+  );
+
+  nonperf_fit_funs.clear();
+  nonperf_fit_funs.resize(
+    config.POP_SIZE(),
+    emp::vector<std::function<double(void)>>(0)
+  );
+
+  // Add novelty as an extra evaluation criterion
+  for (size_t org_id = 0; org_id < config.POP_SIZE(); ++org_id) {
+    nonperf_fit_funs[org_id].emplace_back(
+      [this, org_id]() -> double {
+        return novelty_archive->GetNovelty(org_id);
+      }
+    );
+  }
+
+  selector = emp::NewPtr<selection::AgeLexicaseSelect>(
+    fit_fun_set,
+    nonperf_fit_funs,
+    *random_ptr
+  );
+
+  auto& sel = *(selector.Cast<selection::AgeLexicaseSelect>());
+  sel.SetAgeFunOrderLimit(config.AGE_LEX_AGE_ORDER_LIMIT());
+  sel.SetRankCompression(config.LEXICASE_RANK_COMPRESSION());
+  sel.SetBatchSize(config.LEXICASE_BATCH_SIZE());
+  if (config.OUTPUT_SELECTION_PROFILE()) {
+    sel.SetProfile(&selection_profile);
+    profile_selection = true;
+  }
+
+  selection_fun = [this](
+    size_t n,
+    const emp::vector<size_t>& org_group,
+    const emp::vector<size_t>& test_group
+  ) -> emp::vector<size_t>& {
+    // Cast selector to lexicase selection (novelty is folded in like age)
+    auto& sel = *(selector.Cast<selection::AgeLexicaseSelect>());
+    return sel(n, org_group, test_group);
+  };
+
 }
 
 void ProgSynthWorld::SetupOrgInjection() {
@@ -1346,19 +1863,21 @@ void ProgSynthWorld::SetupOrgInjection_Random() {
     for (size_t i = 0; i < num_to_inject; ++i) {
       // Inject in 'next pop' at end of pop vector
       // emp::WorldPosition inject_pos(pops[1].size(), 1);
-      InjectAt(
-        {
-          sgp::cpu::lfunprg::GenRandLinearFunctionsProgram<hardware_t, TAG_SIZE>(
-            *random_ptr,
-            inst_lib,
-            {config.PRG_MIN_FUNC_CNT(), config.PRG_MAX_FUNC_CNT()},
-            FUNC_NUM_TAGS,
-            {config.PRG_MIN_FUNC_INST_CNT(), config.PRG_MAX_FUNC_INST_CNT()},
-            INST_TAG_CNT,
-            INST_ARG_CNT,
-            {config.PRG_INST_MIN_ARG_VAL(), config.PRG_INST_MAX_ARG_VAL()}
+      InjectFrom(
+        genome_t(
+          ToGenomeProgram(
+            sgp::cpu::lfunprg::GenRandLinearFunctionsProgram<hardware_t, TAG_SIZE>(
+              *random_ptr,
+              inst_lib,
+              {config.PRG_MIN_FUNC_CNT(), config.PRG_MAX_FUNC_CNT()},
+              FUNC_NUM_TAGS,
+              {config.PRG_MIN_FUNC_INST_CNT(), config.PRG_MAX_FUNC_INST_CNT()},
+              INST_TAG_CNT,
+              INST_ARG_CNT,
+              {config.PRG_INST_MIN_ARG_VAL(), config.PRG_INST_MAX_ARG_VAL()}
+            )
           )
-        },
+        ),
         {pops[1].size(), 1}
       );
     }
@@ -1398,8 +1917,8 @@ void ProgSynthWorld::SetupOrgInjection_RecombineRandom() {
         pop_id_2 = GetSize() - 1;
       }
       // Make two new genomes to work with
-      genome_t genome_1(GetOrg(pop_id_1).GetGenome());
-      genome_t genome_2(GetOrg(pop_id_2).GetGenome());
+      genome_t genome_1(CopyGenome(GetOrg(pop_id_1).GetGenome()));
+      genome_t genome_2(CopyGenome(GetOrg(pop_id_2).GetGenome()));
       // Recombine!
       recombiner.ApplyFunctionSequenceRecombinationTwoPoint(
         *random_ptr,
@@ -1408,11 +1927,13 @@ void ProgSynthWorld::SetupOrgInjection_RecombineRandom() {
       );
       genome_1.SetAge(0);
       genome_2.SetAge(0);
-      InjectAt(genome_1, {pops[1].size(), 1});
+      InjectFrom(std::move(genome_1), {pops[1].size(), 1});
       ++num_injected;
       if (num_injected < num_to_inject) {
-        InjectAt(genome_2, {pops[1].size(), 1});
+        InjectFrom(std::move(genome_2), {pops[1].size(), 1});
         ++num_injected;
+      } else {
+        spare_genomes.emplace_back(std::move(genome_2));
       }
     }
 
@@ -1443,45 +1964,76 @@ void ProgSynthWorld::SetupOrgInjection_RecombineComplementary() {
   // Or pure random?
 
   inject_orgs = [this]() {
-    // (1) Analyze population
-    emp::vector<PhenUnionInfo> phen_pairs;
-    std::unordered_set<emp::BitVector> unique_phen_unions;
-    // Union phenotypes of all possible pairings
-    for (size_t i = 0; i < GetSize(); ++i) {
-      for (size_t j = i+1; j < GetSize(); ++j) {
-        // TODO - optimize
-        emp::BitVector union_phen(GetOrg(i).GetPhenotype().GetTestPasses().OR(GetOrg(j).GetPhenotype().GetTestPasses()));
-        if (emp::Has(unique_phen_unions, union_phen)) {
+    // (1) Analyze population: find the unique phenotype (test pass) unions of all possible pairings.
+    //     Only unique unions are stored; union rows, pair ids, and the dedup table persist across calls.
+    const size_t num_words = score_store.GetNumWords();
+    const size_t pop_size = GetSize();
+    const uint64_t* pass_rows = score_store.GetPassRows().data();
+    auto hash_row = [num_words](const uint64_t* row) {
+      uint64_t hash = 14695981039346656037ULL;
+      for (size_t w = 0; w < num_words; ++w) {
+        hash = (hash ^ row[w]) * 1099511628211ULL;
+      }
+      return (size_t)hash;
+    };
+    // Size the dedup table for last call's number of unique unions (grows as needed below).
+    size_t table_size = 64;
+    while (table_size < 2 * pair_org_ids.size()) table_size <<= 1;
+    size_t table_mask = table_size - 1;
+    pair_union_slots.assign(table_size, 0);
+    pair_union_rows.clear();
+    pair_org_ids.clear();
+    pair_union_scratch.resize(num_words);
+    uint64_t* union_row = pair_union_scratch.data();
+    for (size_t i = 0; i < pop_size; ++i) {
+      for (size_t j = i+1; j < pop_size; ++j) {
+        for (size_t w = 0; w < num_words; ++w) {
+          union_row[w] = pass_rows[(i * num_words) + w] | pass_rows[(j * num_words) + w];
+        }
+        // Skip pairs whose union we've already seen (slots hold pair id + 1; 0 = empty)
+        size_t slot = hash_row(union_row) & table_mask;
+        bool seen = false;
+        while (pair_union_slots[slot] != 0) {
+          const uint64_t* other_row = pair_union_rows.data() + ((pair_union_slots[slot] - 1) * num_words);
+          if (std::equal(union_row, union_row + num_words, other_row)) {
+            seen = true;
+            break;
+          }
+          slot = (slot + 1) & table_mask;
+        }
+        if (seen) continue;
+        pair_union_rows.insert(pair_union_rows.end(), union_row, union_row + num_words);
+        pair_org_ids.emplace_back(i, j);
+        if (2 * pair_org_ids.size() <= table_size) {
+          pair_union_slots[slot] = pair_org_ids.size();
           continue;
         }
-        phen_pairs.emplace_back(
-          i,
-          GetOrg(i).GetPhenotype().GetTestPasses(),
-          j,
-          GetOrg(j).GetPhenotype().GetTestPasses()
-        );
-        unique_phen_unions.emplace(union_phen);
+        // Table would exceed a load factor of 0.5: double it and reinsert all unique unions.
+        table_size <<= 1;
+        table_mask = table_size - 1;
+        pair_union_slots.assign(table_size, 0);
+        for (size_t pair_id = 0; pair_id < pair_org_ids.size(); ++pair_id) {
+          size_t rehash_slot = hash_row(pair_union_rows.data() + (pair_id * num_words)) & table_mask;
+          while (pair_union_slots[rehash_slot] != 0) rehash_slot = (rehash_slot + 1) & table_mask;
+          pair_union_slots[rehash_slot] = pair_id + 1;
+        }
       }
     }
-    // std::cout << "InjectOrgs" << std::endl;
-    // std::cout << "phen_pairs.size(): " << phen_pairs.size() << std::endl;
-    // TODO - filter phen_pairs to just unique unions?
-    FindParetoFrontPairs(phen_pairs);
-
-    // std::cout << "front ("<< front_pair_ids.size() << "): " << std::endl; // << front_pair_ids << std::endl;
+    FindParetoFrontPairs();
 
     emp_assert(front_pair_ids.size() > 0);
     size_t num_injected = 0;
     while (num_injected < num_to_inject) {
       // Select random pairing on pareto front
       const size_t front_id = random_ptr->GetUInt(front_pair_ids.size());
-      emp_assert(front_id < phen_pairs.size());
-      const size_t pop_id_1 = phen_pairs[front_id].org_ids.first;
-      const size_t pop_id_2 = phen_pairs[front_id].org_ids.second;
+      const size_t pair_id = front_pair_ids[front_id];
+      emp_assert(pair_id < pair_org_ids.size());
+      const size_t pop_id_1 = pair_org_ids[pair_id].first;
+      const size_t pop_id_2 = pair_org_ids[pair_id].second;
 
       // Make two new genomes to work with
-      genome_t genome_1(GetOrg(pop_id_1).GetGenome());
-      genome_t genome_2(GetOrg(pop_id_2).GetGenome());
+      genome_t genome_1(CopyGenome(GetOrg(pop_id_1).GetGenome()));
+      genome_t genome_2(CopyGenome(GetOrg(pop_id_2).GetGenome()));
       // Recombine!
       recombiner.ApplyFunctionSequenceRecombinationTwoPoint(
         *random_ptr,
@@ -1490,11 +2042,13 @@ void ProgSynthWorld::SetupOrgInjection_RecombineComplementary() {
       );
       genome_1.SetAge(0);
       genome_2.SetAge(0);
-      InjectAt(genome_1, {pops[1].size(), 1});
+      InjectFrom(std::move(genome_1), {pops[1].size(), 1});
       ++num_injected;
       if (num_injected < num_to_inject) {
-        InjectAt(genome_2, {pops[1].size(), 1});
+        InjectFrom(std::move(genome_2), {pops[1].size(), 1});
         ++num_injected;
+      } else {
+        spare_genomes.emplace_back(std::move(genome_2));
       }
     }
 
@@ -1559,7 +2113,7 @@ void ProgSynthWorld::InitializePopulation_LoadSingle() {
   );
   // Inject POP_SIZE number of copies of loaded program into population.
   for (size_t i = 0; i < config.POP_SIZE(); ++i) {
-    Inject({ancestor});
+    Inject({ToGenomeProgram(ancestor)});
   }
 }
 
@@ -1567,15 +2121,17 @@ void ProgSynthWorld::InitializePopulation_Random() {
   for (size_t i = 0; i < config.POP_SIZE(); ++i) {
     Inject(
       {
-        sgp::cpu::lfunprg::GenRandLinearFunctionsProgram<hardware_t, TAG_SIZE>(
-          *random_ptr,
-          inst_lib,
-          {config.PRG_MIN_FUNC_CNT(), config.PRG_MAX_FUNC_CNT()},
-          FUNC_NUM_TAGS,
-          {config.PRG_MIN_FUNC_INST_CNT(), config.PRG_MAX_FUNC_INST_CNT()},
-          INST_TAG_CNT,
-          INST_ARG_CNT,
-          {config.PRG_INST_MIN_ARG_VAL(), config.PRG_INST_MAX_ARG_VAL()}
+        ToGenomeProgram(
+          sgp::cpu::lfunprg::GenRandLinearFunctionsProgram<hardware_t, TAG_SIZE>(
+            *random_ptr,
+            inst_lib,
+            {config.PRG_MIN_FUNC_CNT(), config.PRG_MAX_FUNC_CNT()},
+            FUNC_NUM_TAGS,
+            {config.PRG_MIN_FUNC_INST_CNT(), config.PRG_MAX_FUNC_INST_CNT()},
+            INST_TAG_CNT,
+            INST_ARG_CNT,
+            {config.PRG_INST_MIN_ARG_VAL(), config.PRG_INST_MAX_ARG_VAL()}
+          )
         )
       }
     );
@@ -1609,7 +2165,7 @@ void ProgSynthWorld::SetupPhylogenyTracking() {
   systematics_ptr->AddSnapshotFun(
     [](const taxon_t& taxon) {
       std::stringstream ss;
-      utils::PrintVector(ss, taxon.GetData().GetPhenotype(), true);
+      utils::PrintVector(ss, utils::DecodeScores(taxon.GetData().GetPhenotype()), true);
       return ss.str();
     },
     "phenotype"
@@ -1634,7 +2190,7 @@ void ProgSynthWorld::SetupPhylogenyTracking() {
         return "\"[]\"";
       }
       std::stringstream ss;
-      utils::PrintVector(ss, taxon.GetData().true_training_scores, true);
+      utils::PrintVector(ss, utils::DecodeScores(taxon.GetData().true_training_scores), true);
       return ss.str();
     },
     "training_cases_true_scores"
@@ -1670,6 +2226,146 @@ void ProgSynthWorld::SetupDataCollection() {
   }
   SetupDataCollection_Summary();
   SetupDataCollection_Elite();
+  if (profile_selection) {
+    SetupDataCollection_SelectionProfile();
+  }
+  SetupDataCollection_Memory();
+  if (utils::TrackingAllocations()) {
+    SetupDataCollection_Allocations();
+  }
+  SetupDataCollection_Mutations();
+}
+
+void ProgSynthWorld::UpdateMemoryStats() {
+  MemoryStats& stats = memory_stats;
+  // Genomes (population + recycled storage)
+  stats.genome_bytes = utils::VectorBytes(spare_genomes);
+  for (size_t pos = 0; pos < GetSize(); ++pos) {
+    if (!IsOccupied(pos)) continue;
+    stats.genome_bytes += GetProgramBytes(GetOrg(pos).GetGenome().GetProgram());
+  }
+  for (const genome_t& genome : spare_genomes) {
+    stats.genome_bytes += GetProgramBytes(genome.GetProgram());
+  }
+  #ifdef PSYNTH_SHARED_GENOMES
+  stats.shared_function_bytes = SharedFunctionTable::Get().GetNumBytes();
+  #else
+  stats.shared_function_bytes = 0;
+  #endif
+  stats.org_pool_bytes = org_pool.GetCapacity() * sizeof(org_t);
+  stats.phenotype_bytes = (GetNumOrgs() * sizeof(phenotype_t)) + utils::VectorBytes(org_ages);
+  // Score tables
+  stats.score_table_bytes = score_store.GetNumBytes()
+    + utils::NestedVectorBytes(fit_fun_set)
+    + utils::NestedVectorBytes(nonperf_fit_funs);
+  // Selection
+  stats.selection_bytes = utils::VectorBytes(selected_parent_ids)
+    + utils::VectorBytes(all_org_ids)
+    + utils::VectorBytes(all_training_case_ids)
+    + utils::VectorBytes(all_testing_case_ids)
+    + utils::VectorBytes(ids_profile_org_ids);
+  if (selector != nullptr) stats.selection_bytes += selector->GetNumBytes();
+  if (novelty_archive != nullptr) stats.selection_bytes += novelty_archive->GetNumBytes();
+  // Systematics
+  stats.systematics_bytes = 0;
+  stats.num_taxa = 0;
+  if (systematics_ptr != nullptr) {
+    auto add_taxon = [&stats](const emp::Ptr<taxon_t>& taxon) {
+      const auto& data = taxon->GetData();
+      stats.systematics_bytes += sizeof(taxon_t)
+        + GetProgramBytes(taxon->GetInfo().GetProgram())
+        + utils::VectorBytes(data.GetPhenotype())
+        + utils::VectorBytes(data.GetTraitsEvaluated())
+        + utils::VectorBytes(data.true_training_scores);
+      ++stats.num_taxa;
+    };
+    for (const auto& taxon : systematics_ptr->GetActive()) add_taxon(taxon);
+    for (const auto& taxon : systematics_ptr->GetAncestors()) add_taxon(taxon);
+    for (const auto& taxon : systematics_ptr->GetOutside()) add_taxon(taxon);
+  }
+  // Injection
+  stats.injection_bytes = utils::VectorBytes(complementary_pair_ids)
+    + utils::VectorBytes(front_pair_ids)
+    + utils::VectorBytes(pair_union_rows)
+    + utils::VectorBytes(pair_org_ids)
+    + utils::VectorBytes(pair_union_slots)
+    + utils::VectorBytes(pair_union_scratch);
+  // Process
+  stats.rss_bytes = utils::GetCurrentRSS();
+  stats.peak_rss_bytes = utils::GetPeakRSS();
+}
+
+void ProgSynthWorld::SetupDataCollection_Memory() {
+  // Create memory accounting file
+  memory_file_ptr = emp::NewPtr<emp::DataFile>(
+    output_dir + "memory.csv"
+  );
+
+  memory_file_ptr->AddVar(update, "update", "Generation");
+  memory_file_ptr->AddVar(total_test_evaluations, "evaluations", "Test evaluations so far");
+  memory_file_ptr->AddVar(memory_stats.genome_bytes, "genome_bytes", "Bytes held by population (and recycled) genome programs");
+  memory_file_ptr->AddVar(memory_stats.shared_function_bytes, "shared_function_bytes", "Bytes held by the shared function table");
+  memory_file_ptr->AddVar(memory_stats.org_pool_bytes, "org_pool_bytes", "Bytes held by organism pool slots");
+  memory_file_ptr->AddVar(memory_stats.phenotype_bytes, "phenotype_bytes", "Bytes held by organism phenotype handles and ages");
+  memory_file_ptr->AddVar(memory_stats.score_table_bytes, "score_table_bytes", "Bytes held by the score store and fitness function tables");
+  memory_file_ptr->AddVar(memory_stats.selection_bytes, "selection_bytes", "Bytes held by selection buffers");
+  memory_file_ptr->AddVar(memory_stats.systematics_bytes, "systematics_bytes", "Bytes held by phylogeny taxa");
+  memory_file_ptr->AddVar(memory_stats.num_taxa, "num_taxa", "Taxa tracked by systematics");
+  memory_file_ptr->AddVar(memory_stats.injection_bytes, "injection_bytes", "Bytes held by org injection buffers");
+  memory_file_ptr->AddVar(memory_stats.rss_bytes, "rss_bytes", "Process resident set size");
+  memory_file_ptr->AddVar(memory_stats.peak_rss_bytes, "peak_rss_bytes", "Process peak resident set size");
+  memory_file_ptr->PrintHeaderKeys();
+}
+
+void ProgSynthWorld::SetupDataCollection_Allocations() {
+  // Create allocation tracking file
+  allocations_file_ptr = emp::NewPtr<emp::DataFile>(
+    output_dir + "allocations.csv"
+  );
+
+  allocations_file_ptr->AddVar(update, "update", "Generation");
+  allocations_file_ptr->AddVar(total_test_evaluations, "evaluations", "Test evaluations so far");
+  allocations_file_ptr->AddVar(phase_allocations.evaluation.allocations, "evaluation_allocs", "Heap allocations during evaluation");
+  allocations_file_ptr->AddVar(phase_allocations.evaluation.bytes, "evaluation_bytes", "Heap bytes allocated during evaluation");
+  allocations_file_ptr->AddVar(phase_allocations.selection.allocations, "selection_allocs", "Heap allocations during selection and births");
+  allocations_file_ptr->AddVar(phase_allocations.selection.bytes, "selection_bytes", "Heap bytes allocated during selection and births");
+  allocations_file_ptr->AddVar(phase_allocations.injection.allocations, "injection_allocs", "Heap allocations during org injection");
+  allocations_file_ptr->AddVar(phase_allocations.injection.bytes, "injection_bytes", "Heap bytes allocated during org injection");
+  allocations_file_ptr->AddVar(phase_allocations.update.allocations, "prev_update_allocs", "Heap allocations during the previous generation's update (output + population swap)");
+  allocations_file_ptr->AddVar(phase_allocations.update.bytes, "prev_update_bytes", "Heap bytes allocated during the previous generation's update");
+  allocations_file_ptr->PrintHeaderKeys();
+}
+
+void ProgSynthWorld::SetupDataCollection_Mutations() {
+  // Create mutation spectrum file
+  mutations_file_ptr = emp::NewPtr<emp::DataFile>(
+    output_dir + "mutations.csv"
+  );
+
+  mutations_file_ptr->AddVar(update, "update", "Generation");
+  mutations_file_ptr->AddVar(total_test_evaluations, "evaluations", "Test evaluations so far");
+  mutations_file_ptr->AddVar(mutation_stats.num_offspring, "num_offspring", "Offspring mutated this generation");
+  mutations_file_ptr->AddFun<double>(
+    [this]() -> double {
+      return mutation_stats.GetMeanMutations();
+    },
+    "mean_mutations",
+    "Mean number of mutations per offspring"
+  );
+  mutations_file_ptr->AddFun<double>(
+    [this]() -> double {
+      return mutation_stats.GetUnmutatedFraction();
+    },
+    "unmutated_frac",
+    "Fraction of offspring with no mutations (identical to their parent)"
+  );
+  // One column per mutation type
+  for (size_t i = 0; i < mutator_t::NUM_MUTATION_TYPES; ++i) {
+    const auto type = (mutator_t::MUTATION_TYPES)i;
+    const std::string name(mutator_t::GetMutationTypeName(type));
+    mutations_file_ptr->AddVar(mutation_stats.counts[type], name, "Number of " + name + " mutations this generation");
+  }
+  mutations_file_ptr->PrintHeaderKeys();
 }
 
 void ProgSynthWorld::SetupDataCollection_Phylodiversity() {
@@ -1780,8 +2476,7 @@ void ProgSynthWorld::SetupDataCollection_Elite() {
 
   elite_file_ptr->AddFun<size_t>(
     [this]() -> size_t {
-      const auto& org = GetOrg(max_fit_id);
-      return org.GetGenome().GetAge();
+      return org_ages[max_fit_id];
     },
     "elite_age"
   );
@@ -1795,18 +2490,18 @@ void ProgSynthWorld::SetupDataCollection_Elite() {
     "eval_agg_score",
     "Elite organism's evaluated aggregate score"
   );
-  // org_training_coverage
+  // Training coverage
   elite_file_ptr->AddFun<size_t>(
     [this]() -> size_t {
-      return org_training_coverage[max_fit_id];
+      return score_store.GetNumPassed(max_fit_id);
     },
     "eval_training_coverage",
     "Coverage on evaluated training cases"
   );
-  // org_num_training_cases
+  // Number of training cases evaluated
   elite_file_ptr->AddFun<size_t>(
     [this]() -> size_t {
-      return org_num_training_cases[max_fit_id];
+      return score_store.GetNumEvaluated(max_fit_id);
     },
     "num_training_cases_evaluated",
     "Number of training cases that this organism was evaluated against"
@@ -1817,7 +2512,7 @@ void ProgSynthWorld::SetupDataCollection_Elite() {
       std::stringstream ss;
       utils::PrintVector(
         ss,
-        org_training_evaluations[max_fit_id],
+        score_store.GetEvaluated(max_fit_id),
         true
       );
       return ss.str();
@@ -1831,7 +2526,7 @@ void ProgSynthWorld::SetupDataCollection_Elite() {
       std::stringstream ss;
       utils::PrintVector(
         ss,
-        org_training_scores[max_fit_id],
+        score_store.GetScores(max_fit_id),
         true
       );
       return ss.str();
@@ -1878,6 +2573,78 @@ void ProgSynthWorld::SetupDataCollection_Elite() {
   elite_file_ptr->PrintHeaderKeys();
 }
 
+void ProgSynthWorld::SetupDataCollection_SelectionProfile() {
+  // Create selection profile file
+  selection_profile_file_ptr = emp::NewPtr<emp::DataFile>(
+    output_dir + "selection_profile.csv"
+  );
+
+  selection_profile_file_ptr->AddVar(update, "update", "Generation");
+  selection_profile_file_ptr->AddVar(
+    total_test_evaluations,
+    "evaluations",
+    "Test evaluations so far"
+  );
+  selection_profile_file_ptr->AddVar(
+    selection_profile.num_events,
+    "num_events",
+    "Number of lexicase selection events (shuffled criteria orderings)"
+  );
+  selection_profile_file_ptr->AddFun<double>(
+    [this]() -> double {
+      return selection_profile.GetMeanDepth();
+    },
+    "mean_depth",
+    "Mean number of criteria used per selection event"
+  );
+  selection_profile_file_ptr->AddFun<std::string>(
+    [this]() -> std::string {
+      std::stringstream ss;
+      utils::PrintVector(ss, selection_profile.depth_hist, true);
+      return ss.str();
+    },
+    "depth_hist",
+    "Number of selection events that used (index + 1) criteria (last bin includes deeper events)"
+  );
+  selection_profile_file_ptr->AddFun<std::string>(
+    [this]() -> std::string {
+      std::stringstream ss;
+      utils::PrintVector(ss, selection_profile.GetMeanPoolSizes(), true);
+      return ss.str();
+    },
+    "mean_pool_size_by_depth",
+    "Mean candidate pool size after filtering on the (index + 1)th criterion"
+  );
+  selection_profile_file_ptr->AddVar(
+    selection_profile.random_tie_events,
+    "random_tie_events",
+    "Number of selection events that ended in a tie (winner chosen at random)"
+  );
+  selection_profile_file_ptr->AddFun<double>(
+    [this]() -> double {
+      if (selection_profile.random_tie_events == 0) return 0.0;
+      return (double)selection_profile.random_tie_pool_sum / (double)selection_profile.random_tie_events;
+    },
+    "mean_random_tie_pool_size",
+    "Mean final pool size of selection events that ended in a tie"
+  );
+  selection_profile_file_ptr->AddVar(
+    selection_profile.age_decided_events,
+    "age_decided_events",
+    "Number of selection events where a non-performance (age/novelty) criterion was the last to shrink the pool"
+  );
+  selection_profile_file_ptr->AddFun<std::string>(
+    [this]() -> std::string {
+      std::stringstream ss;
+      utils::PrintVector(ss, selection_profile.age_decided_depth_hist, true);
+      return ss.str();
+    },
+    "age_decided_depth_hist",
+    "Depth of the deciding non-performance criterion"
+  );
+  selection_profile_file_ptr->PrintHeaderKeys();
+}
+
 void ProgSynthWorld::SnapshotConfig() {
   emp::DataFile snapshot_file(output_dir + "run_config.csv");
   std::function<std::string(void)> get_param;
@@ -1906,6 +2673,13 @@ void ProgSynthWorld::SnapshotConfig() {
     std::make_pair("INST_TAG_CNT", emp::to_string(INST_TAG_CNT)),
     std::make_pair("INST_ARG_CNT", emp::to_string(INST_ARG_CNT)),
     std::make_pair("sgp_program_type", "LinearFunctionsProgram"),
+    #ifdef PSYNTH_SHARED_GENOMES
+    std::make_pair("genome_program_type", "SharedProgram"),
+    #else
+    std::make_pair("genome_program_type", "LinearFunctionsProgram"),
+    #endif
+    std::make_pair("score_storage_type", ScoreStore::codec_t::name),
+    std::make_pair("score_storage_caveat", std::string("\"") + ScoreStore::codec_t::caveat + "\""),
     std::make_pair("matchbin_metric", "HammingMetric"),
     std::make_pair("matchbin_selector", "RankedSelector"),
     std::make_pair("total_training_cases", emp::to_string(problem_manager.GetTrainingSetSize())),
@@ -1975,9 +2749,9 @@ void ProgSynthWorld::SnapshotPhylogeny() {
     const auto& genome = taxon->GetInfo();
     // Build new org.
     org_t org(genome);
-    org.ResetPhenotype(problem_manager.GetTrainingSetSize());
     auto& scores = taxon->GetData().true_training_scores;
-    scores.resize(problem_manager.GetTrainingSetSize(), 0.0);
+    scores.resize(problem_manager.GetTrainingSetSize(), stored_score_t(0));
+    double agg_score = 0.0;
     begin_program_eval_sig.Trigger(org);
     // Evaluate org on each training case.
     for (size_t i = 0; i < all_training_case_ids.size(); ++i) {
@@ -1993,11 +2767,11 @@ void ProgSynthWorld::SnapshotPhylogeny() {
         training_id,
         true
       );
-      org.UpdatePhenotype(training_id, result);
-      scores[training_id] = result.score;
+      scores[training_id] = ScoreStore::codec_t::Encode(result.score);
+      agg_score += ScoreStore::codec_t::Decode(scores[training_id]);
     }
     taxon->GetData().true_training_scores_computed = true;
-    taxon->GetData().true_agg_score = org.GetPhenotype().GetAggregateScore();
+    taxon->GetData().true_agg_score = agg_score;
   }
 
   systematics_ptr->Snapshot(output_dir + "phylo_" + emp::to_string(GetUpdate()) + ".csv");
@@ -2075,13 +2849,13 @@ void ProgSynthWorld::RunMutationAnalysis() {
   );
   mutant_file.AddFun<double>(
     [this, &mutant_id]() {
-      return org_aggregate_scores[mutant_id];
+      return score_store.GetAggregate(mutant_id);
     },
     "agg_score"
   );
   mutant_file.AddFun<size_t>(
     [this, &mutant_id]() {
-      return org_training_coverage[mutant_id];
+      return score_store.GetNumPassed(mutant_id);
     },
     "training_case_coverage"
   );
@@ -2090,7 +2864,7 @@ void ProgSynthWorld::RunMutationAnalysis() {
       std::stringstream ss;
       utils::PrintVector(
         ss,
-        org_training_scores[mutant_id],
+        score_store.GetScores(mutant_id),
         true
       );
       return ss.str();
@@ -2141,8 +2915,11 @@ void ProgSynthWorld::RunMutationAnalysis() {
 
     auto& focal_program = focal_programs[prog_i].first;
 
+    // Reset tracking (one score store row per mutant; organisms bind to rows on placement)
+    score_store.Resize(config.NUM_MUTANTS() + 1, total_training_cases);
+
     // Inject focal program into population at position 0.
-    Inject({focal_program});
+    Inject({ToGenomeProgram(focal_program)});
 
     // Ensure uniqueness.
     std::set<program_t> mutants({focal_program});
@@ -2163,7 +2940,7 @@ void ProgSynthWorld::RunMutationAnalysis() {
       if (emp::Has(mutants, mutant_program)) {
         continue;
       }
-      Inject({mutant_program});
+      Inject({ToGenomeProgram(mutant_program)});
       mutants.emplace(mutant_program);
     }
     emp_assert(GetSize() == (config.NUM_MUTANTS() + 1));
@@ -2171,38 +2948,14 @@ void ProgSynthWorld::RunMutationAnalysis() {
     ////////////////////////////////////////////////
     // Run each mutant against the full training set
     ////////////////////////////////////////////////
-    // Reset tracking vectors
-    org_training_scores.clear();
-    org_training_scores.resize(
-      GetSize(),
-      emp::vector<double>(total_training_cases, 0.0)
-    );
-    org_aggregate_scores.clear();
-    org_aggregate_scores.resize(
-      GetSize(),
-      0.0
-    );
-    org_training_coverage.clear();
-    org_training_coverage.resize(
-      GetSize(),
-      0
-    );
     // For each mutant:
     for (size_t org_id = 0; org_id < GetSize(); ++org_id) {
       // -- Begin org evaluation --
-      // 0-out scores / coverage
-      std::fill(
-        org_training_scores[org_id].begin(),
-        org_training_scores[org_id].end(),
-        0.0
-      );
-      org_aggregate_scores[org_id] = 0.0;
-      org_training_coverage[org_id] = 0.0;
-      // Reset phenotype
+      // 0-out scores / coverage (i.e., reset phenotype)
+      score_store.ResetOrg(org_id);
       auto& org = GetOrg(org_id);
-      org.ResetPhenotype(total_training_cases);
       // -- Program evaluation --
-      eval_hardware->SetProgram(org.GetGenome().GetProgram());
+      eval_hardware->SetProgram(GetExecProgram(org.GetGenome().GetProgram()));
       // Run program on each training case:
       for (size_t i = 0; i < total_training_cases; ++i) {
         const size_t test_id = all_training_case_ids[i];
@@ -2218,12 +2971,8 @@ void ProgSynthWorld::RunMutationAnalysis() {
           test_id,
           true
         );
-        // - Update organism phenotype
-        org.UpdatePhenotype(test_id, result);
-        // - Update tracking
-        org_training_scores[org_id][test_id] = result.score;
-        org_aggregate_scores[org_id] += result.score;
-        org_training_coverage[org_id] += (size_t)result.is_correct;
+        // - Update organism phenotype / tracking
+        score_store.Record(org_id, test_id, result.score, result.is_correct);
       }
     }
 
@@ -2238,9 +2987,10 @@ void ProgSynthWorld::RunMutationAnalysis() {
 }
 
 // Re-implementation of utils::find_pareto_front
-void ProgSynthWorld::FindParetoFrontPairs(const emp::vector< ProgSynthWorld::PhenUnionInfo >& phen_pairs) {
+void ProgSynthWorld::FindParetoFrontPairs() {
 
-    const size_t num_candidates = phen_pairs.size();
+    const size_t num_candidates = pair_org_ids.size();
+    const size_t num_words = score_store.GetNumWords();
 
 
     // emp::vector<size_t> all_candidates(num_candidates);
@@ -2264,14 +3014,15 @@ void ProgSynthWorld::FindParetoFrontPairs(const emp::vector< ProgSynthWorld::Phe
       for (int front_i = 0; front_i < (int)front.size(); ++front_i) {
         const size_t front_id = front[front_i];
         // emp_assert(score_table[cur_candidate_id].size() == score_table[front_id].size());
-        emp_assert(phen_pairs[cur_pair_id].phen_union.GetSize() == phen_pairs[front_id].phen_union.GetSize());
+        const uint64_t* cur_row = pair_union_rows.data() + (cur_pair_id * num_words);
+        const uint64_t* front_row = pair_union_rows.data() + (front_id * num_words);
         // note, this could be made more efficient (by computing sharing domination comparisons)
-        if (utils::dominates(phen_pairs[cur_pair_id].phen_union, phen_pairs[front_id].phen_union)) {
+        if (utils::dominates_packed(cur_row, front_row, num_words)) {
           // candidate dominates member of the front, remove member of the front
           std::swap(front[front_i], front[front.size()-1]); // Put dominated member of the front in the back
           front.pop_back(); // Remove dominated member of the front
           --front_i; // need to look at this index again
-        } else if (utils::dominates( phen_pairs[front_id].phen_union, phen_pairs[cur_pair_id].phen_union)) {
+        } else if (utils::dominates_packed(front_row, cur_row, num_words)) {
           dominated = true;
           break;
         }
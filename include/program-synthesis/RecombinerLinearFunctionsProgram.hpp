@@ -6,6 +6,7 @@ Provides functions for recombining linear functions programs
 #pragma once
 
 #include <algorithm>
+#include <numeric>
 #include <utility>
 #include "emp/bits/BitSet.hpp"
 #include "emp/base/vector.hpp"
@@ -13,6 +14,8 @@ Provides functions for recombining linear functions programs
 #include "emp/math/Random.hpp"
 #include "emp/math/random_utils.hpp"
 
+#include "PackedProgram.hpp"
+#include "SharedProgram.hpp"
 
 namespace psynth {
 
@@ -41,12 +44,132 @@ public:
   using inst_t = typename program_t::inst_t;
   using hardware_t = HARDWARE_T;
   using inst_lib_t = typename HARDWARE_T::inst_lib_t;
+  using packed_program_t = PackedProgram<TAG_W>;
+  using packed_inst_t = PackedInst;
+  using shared_program_t = SharedProgram<TAG_W>;
 
 protected:
 
   double whole_func_swap_rate = 0.0;
   double per_func_seq_xover_rate = 0.0;
 
+  emp::vector<packed_inst_t> packed_p1_func;  ///< Scratch buffers for recombining packed programs
+  emp::vector<packed_inst_t> packed_p2_func;
+  emp::vector<size_t> p1_func_ids;            ///< Scratch: program 1 function ids (partially shuffled as pairs are drawn)
+  emp::vector<size_t> p2_func_ids;            ///< Scratch: program 2 function ids (partially shuffled as pairs are drawn)
+
+  /// Draw the next id of a partial (Fisher-Yates) shuffle of ids; ids[0, num_drawn) were already drawn.
+  static size_t DrawFuncId(emp::Random& random, emp::vector<size_t>& ids, size_t num_drawn) {
+    emp_assert(num_drawn < ids.size());
+    std::swap(ids[num_drawn], ids[random.GetUInt(num_drawn, ids.size())]);
+    return ids[num_drawn];
+  }
+
+  /// Call fun(p1_func_id, p2_func_id) for each pair of functions to recombine.
+  /// The first pair is always recombined; each subsequent pair (up to min(num_p1_funcs, num_p2_funcs)
+  /// pairs) is recombined with probability rate (never if whole_func_swap_rate is 0).
+  /// Pairs are made of distinct, uniformly random functions, but only pairs actually recombined are drawn.
+  template<typename FUN_T>
+  void ForEachRecombinationPair(
+    emp::Random& random,
+    size_t num_p1_funcs,
+    size_t num_p2_funcs,
+    double rate,
+    FUN_T&& fun
+  ) {
+    p1_func_ids.resize(num_p1_funcs);
+    std::iota(p1_func_ids.begin(), p1_func_ids.end(), 0);
+    p2_func_ids.resize(num_p2_funcs);
+    std::iota(p2_func_ids.begin(), p2_func_ids.end(), 0);
+    // Determine the maximum number of functions we could recombine
+    const size_t max_pairs = std::min(num_p1_funcs, num_p2_funcs);
+    size_t num_drawn = 0;
+    for (size_t i = 0; i < max_pairs; ++i) {
+      if (i > 0 && (whole_func_swap_rate <= 0.0 || !random.P(rate))) {
+        // If not first pair, swap rate > 0, and coin flip says don't recombine, continue
+        continue;
+      }
+      const size_t p1_func_id = DrawFuncId(random, p1_func_ids, num_drawn);
+      const size_t p2_func_id = DrawFuncId(random, p2_func_ids, num_drawn);
+      ++num_drawn;
+      fun(p1_func_id, p2_func_id);
+    }
+  }
+
+  /// Exchange func_1[begin_1, begin_1 + len_1) with func_2[begin_2, begin_2 + len_2).
+  /// Instructions are swapped in place; if lengths differ, the function receiving the longer range
+  /// grows in place and the other is rebuilt (SignalGP functions can only grow in place).
+  void SwapInstRanges(
+    function_t& func_1,
+    size_t begin_1,
+    size_t len_1,
+    function_t& func_2,
+    size_t begin_2,
+    size_t len_2
+  ) {
+    if (len_1 < len_2) {
+      SwapInstRanges(func_2, begin_2, len_2, func_1, begin_1, len_1);
+      return;
+    }
+    emp_assert(begin_1 + len_1 <= func_1.GetSize());
+    emp_assert(begin_2 + len_2 <= func_2.GetSize());
+    // (1) Swap overlapping part of the two ranges
+    for (size_t i = 0; i < len_2; ++i) {
+      std::swap(func_1[begin_1 + i], func_2[begin_2 + i]);
+    }
+    if (len_1 == len_2) return;
+    // (2) Move the rest of func_1's range into func_2 (appended, then rotated into place)
+    const size_t func_1_size = func_1.GetSize();
+    const size_t func_2_size = func_2.GetSize();
+    const size_t extra_begin = begin_1 + len_2;
+    const size_t extra_end = begin_1 + len_1;
+    for (size_t i = extra_begin; i < extra_end; ++i) {
+      func_2.PushInst(func_1[i]);
+    }
+    inst_t* func_2_insts = &func_2[0];
+    std::rotate(
+      func_2_insts + begin_2 + len_2,
+      func_2_insts + func_2_size,
+      func_2_insts + func_2.GetSize()
+    );
+    // (3) Rebuild func_1 without the moved instructions
+    function_t new_func_1(func_1.GetTags());
+    for (size_t i = 0; i < extra_begin; ++i) {
+      new_func_1.PushInst(func_1[i]);
+    }
+    for (size_t i = extra_end; i < func_1_size; ++i) {
+      new_func_1.PushInst(func_1[i]);
+    }
+    func_1 = std::move(new_func_1);
+  }
+
+  /// Exchange program_1 function fID_1's [begin_1, begin_1 + len_1) with program_2 function fID_2's
+  /// [begin_2, begin_2 + len_2), in place.
+  static void SwapInstRanges(
+    packed_program_t& program_1,
+    size_t fID_1,
+    size_t begin_1,
+    size_t len_1,
+    packed_program_t& program_2,
+    size_t fID_2,
+    size_t begin_2,
+    size_t len_2
+  ) {
+    if (len_1 < len_2) {
+      SwapInstRanges(program_2, fID_2, begin_2, len_2, program_1, fID_1, begin_1, len_1);
+      return;
+    }
+    emp_assert(&program_1 != &program_2);
+    emp_assert(begin_1 + len_1 <= program_1.GetFunctionSize(fID_1));
+    emp_assert(begin_2 + len_2 <= program_2.GetFunctionSize(fID_2));
+    packed_inst_t* range_1 = program_1.GetInsts().data() + program_1.GetFunctionOffset(fID_1) + begin_1;
+    packed_inst_t* range_2 = program_2.GetInsts().data() + program_2.GetFunctionOffset(fID_2) + begin_2;
+    std::swap_ranges(range_1, range_1 + len_2, range_2);
+    if (len_1 == len_2) return;
+    program_2.InsertInsts(fID_2, begin_2 + len_2, range_1 + len_2, range_1 + len_1);
+    program_1.EraseInsts(fID_1, begin_1 + len_2, begin_1 + len_1);
+  }
+
 public:
 
   void SetWholeFuncSwapRate(double rate) {
@@ -86,28 +209,16 @@ public:
     emp_assert(program_1.GetSize() > 0);
     emp_assert(program_2.GetSize() > 0);
     // std::cout << "Apply whole function recombination" << std::endl;
-    // Generate vectors of function ids to use for determining which functions to swap
-    emp::vector<size_t> p1_func_ids(program_1.GetSize(), 0);
-    std::iota(p1_func_ids.begin(), p1_func_ids.end(), 0);
-    emp::vector<size_t> p2_func_ids(program_2.GetSize(), 0);
-    std::iota(p2_func_ids.begin(), p2_func_ids.end(), 0);
-    // Determine the maximum number of functions we could swap
-    const size_t max_func_swaps = std::min(program_1.GetSize(), program_2.GetSize());
-
-    emp::Shuffle(random, p1_func_ids);
-    emp::Shuffle(random, p2_func_ids);
-
-    for (size_t i = 0; i < max_func_swaps; ++i) {
-      if (i > 0 && (whole_func_swap_rate <= 0.0 || !random.P(whole_func_swap_rate))) {
-        // If not first swap, swap rate > 0, and coin flip says don't swap, continue
-        continue;
+    ForEachRecombinationPair(
+      random,
+      program_1.GetSize(),
+      program_2.GetSize(),
+      whole_func_swap_rate,
+      [&program_1, &program_2](size_t p1_func_id, size_t p2_func_id) {
+        // std::cout << "Swap p1[" << p1_func_id << "] and " << "p2["<< p2_func_id << "]" << std::endl;
+        std::swap(program_1[p1_func_id], program_2[p2_func_id]);
       }
-      // Get functions ids to be swapped
-      const size_t p1_func_id = p1_func_ids[i];
-      const size_t p2_func_id = p2_func_ids[i];
-      // std::cout << "Swap p1[" << p1_func_id << "] and " << "p2["<< p2_func_id << "]" << std::endl;
-      std::swap(program_1[p1_func_id], program_2[p2_func_id]);
-    }
+    );
   }
 
   void ApplyFunctionSequenceRecombinationTwoPoint(
@@ -123,84 +234,178 @@ public:
     emp_assert(program_1.GetSize() > 0);
     emp_assert(program_2.GetSize() > 0);
     // std::cout << "Apply two-point recombination" << std::endl;
-    // Generate vectors of function ids to use for determining which functions crossover
-    emp::vector<size_t> p1_func_ids(program_1.GetSize(), 0);
-    std::iota(p1_func_ids.begin(), p1_func_ids.end(), 0);
-    emp::vector<size_t> p2_func_ids(program_2.GetSize(), 0);
-    std::iota(p2_func_ids.begin(), p2_func_ids.end(), 0);
-    // Determine the maximum number of functions we could xover
-    const size_t max_func_crosses = std::min(program_1.GetSize(), program_2.GetSize());
-    // Shuffle order of function ids to allow us to guarantee unique pairings.
-    emp::Shuffle(random, p1_func_ids);
-    emp::Shuffle(random, p2_func_ids);
-    for (size_t i = 0; i < max_func_crosses; ++i) {
-      if (i > 0 && (whole_func_swap_rate <= 0.0 || !random.P(per_func_seq_xover_rate))) {
-        // If not first swap, swap rate > 0, and coin flip says don't swap, continue
-        continue;
-      }
-      // Get functions ids to be recombined
-      const size_t p1_func_id = p1_func_ids[i];
-      const size_t p2_func_id = p2_func_ids[i];
-      // std::cout << "Recombine p1[" << p1_func_id << "] and " << "p2["<< p2_func_id << "]" << std::endl;
-      emp_assert(p1_func_id < program_1.GetSize());
-      emp_assert(p2_func_id < program_2.GetSize());
-      emp_assert(program_1[p1_func_id].GetSize() > 0);
-      emp_assert(program_2[p2_func_id].GetSize() > 0);
-      // Pick two points for p1
-      const auto p1_crossover_points = FindTwoPoints(random, program_1[p1_func_id]);
-      // std::cout << "  P1 crossover points: (" << p1_crossover_points.first << "," << p1_crossover_points.second << ")" << std::endl;
-      // Pick two points for p2
-      const auto p2_crossover_points = FindTwoPoints(random, program_2[p2_func_id]);
-      // std::cout << "  P2 crossover points: (" << p2_crossover_points.first << "," << p2_crossover_points.second << ")" << std::endl;
-      // Create new p1 function
-      function_t new_p1_func(program_1[p1_func_id].GetTags());
-      // - (1) Copy p1 0 to p1_crossover_points.first
-      emp_assert(p1_crossover_points.first < program_1[p1_func_id].GetSize());
-      for (size_t inst_i = 0; inst_i < p1_crossover_points.first; ++inst_i) {
-        new_p1_func.PushInst(program_1[p1_func_id][inst_i]);
-      }
-      // - (2) Copy p2 starting at p2_crossover_points.first until (and including) p2_crossover_points.second
-      emp_assert(p2_crossover_points.first < program_2[p2_func_id].GetSize());
-      emp_assert(p2_crossover_points.second < program_2[p2_func_id].GetSize());
-      for (size_t inst_i = p2_crossover_points.first; inst_i <= p2_crossover_points.second; ++inst_i) {
-        new_p1_func.PushInst(program_2[p2_func_id][inst_i]);
-      }
-      // - (3) Copy p1 p1_crossover_points.second+1 to end of function
-      for (size_t inst_i = p1_crossover_points.second + 1; inst_i < program_1[p1_func_id].GetSize(); ++inst_i) {
-        new_p1_func.PushInst(program_1[p1_func_id][inst_i]);
+    ForEachRecombinationPair(
+      random,
+      program_1.GetSize(),
+      program_2.GetSize(),
+      per_func_seq_xover_rate,
+      [this, &random, &program_1, &program_2](size_t p1_func_id, size_t p2_func_id) {
+        // std::cout << "Recombine p1[" << p1_func_id << "] and " << "p2["<< p2_func_id << "]" << std::endl;
+        emp_assert(p1_func_id < program_1.GetSize());
+        emp_assert(p2_func_id < program_2.GetSize());
+        function_t& p1_func = program_1[p1_func_id];
+        function_t& p2_func = program_2[p2_func_id];
+        emp_assert(p1_func.GetSize() > 0);
+        emp_assert(p2_func.GetSize() > 0);
+        // Pick two points for p1
+        const auto p1_crossover_points = FindTwoPoints(random, p1_func);
+        // Pick two points for p2
+        const auto p2_crossover_points = FindTwoPoints(random, p2_func);
+        // New p1 function: p1[0, p1.first) + p2[p2.first, p2.second] + p1(p1.second, end)
+        // New p2 function: p2[0, p2.first) + p1[p1.first, p1.second] + p2(p2.second, end)
+        SwapInstRanges(
+          p1_func,
+          p1_crossover_points.first,
+          p1_crossover_points.second - p1_crossover_points.first + 1,
+          p2_func,
+          p2_crossover_points.first,
+          p2_crossover_points.second - p2_crossover_points.first + 1
+        );
       }
+    );
+  }
 
-      // Create new p2 function
-      function_t new_p2_func(program_2[p2_func_id].GetTags());
-      // - (1) Copy from p2:
-      //        0 to p2_crossover_points.first
-      emp_assert(p2_crossover_points.first < program_2[p2_func_id].GetSize());
-      for (size_t inst_i = 0; inst_i < p2_crossover_points.first; ++inst_i) {
-        new_p2_func.PushInst(program_2[p2_func_id][inst_i]);
+  /// Whole function recombination on packed programs (same semantics as above).
+  void ApplyWholeFunctionRecombination(
+    emp::Random& random,
+    packed_program_t& program_1,
+    packed_program_t& program_2
+  ) {
+    emp_assert(program_1.GetSize() > 0);
+    emp_assert(program_2.GetSize() > 0);
+    ForEachRecombinationPair(
+      random,
+      program_1.GetSize(),
+      program_2.GetSize(),
+      whole_func_swap_rate,
+      [&program_1, &program_2](size_t p1_func_id, size_t p2_func_id) {
+        SwapInstRanges(
+          program_1, p1_func_id, 0, program_1.GetFunctionSize(p1_func_id),
+          program_2, p2_func_id, 0, program_2.GetFunctionSize(p2_func_id)
+        );
+        std::swap(program_1.GetFunctionTags()[p1_func_id], program_2.GetFunctionTags()[p2_func_id]);
       }
-      // - (2) Copy from p1:
-      //        starting at p1_crossover_points.first until (and including) p1_crossover_points.second
-      emp_assert(p1_crossover_points.first < program_1[p1_func_id].GetSize());
-      emp_assert(p1_crossover_points.second < program_1[p1_func_id].GetSize());
-      for (size_t inst_i = p1_crossover_points.first; inst_i <= p1_crossover_points.second; ++inst_i) {
-        new_p2_func.PushInst(program_1[p1_func_id][inst_i]);
+    );
+  }
+
+  /// Two-point function sequence recombination on packed programs (same semantics as above).
+  void ApplyFunctionSequenceRecombinationTwoPoint(
+    emp::Random& random,
+    packed_program_t& program_1,
+    packed_program_t& program_2
+  ) {
+    emp_assert(program_1.GetSize() > 0);
+    emp_assert(program_2.GetSize() > 0);
+    ForEachRecombinationPair(
+      random,
+      program_1.GetSize(),
+      program_2.GetSize(),
+      per_func_seq_xover_rate,
+      [this, &random, &program_1, &program_2](size_t p1_func_id, size_t p2_func_id) {
+        const size_t p1_size = program_1.GetFunctionSize(p1_func_id);
+        const size_t p2_size = program_2.GetFunctionSize(p2_func_id);
+        emp_assert(p1_size > 0);
+        emp_assert(p2_size > 0);
+        const auto p1_crossover_points = FindTwoPoints(random, p1_size);
+        const auto p2_crossover_points = FindTwoPoints(random, p2_size);
+        // New p1 function: p1[0, p1.first) + p2[p2.first, p2.second] + p1(p1.second, end)
+        // New p2 function: p2[0, p2.first) + p1[p1.first, p1.second] + p2(p2.second, end)
+        SwapInstRanges(
+          program_1,
+          p1_func_id,
+          p1_crossover_points.first,
+          p1_crossover_points.second - p1_crossover_points.first + 1,
+          program_2,
+          p2_func_id,
+          p2_crossover_points.first,
+          p2_crossover_points.second - p2_crossover_points.first + 1
+        );
       }
-      // - (3) Copy from p2:
-      //        p2_crossover_points.second+1 to end of function
-      for (size_t inst_i = p2_crossover_points.second + 1; inst_i < program_2[p2_func_id].GetSize(); ++inst_i) {
-        new_p2_func.PushInst(program_2[p2_func_id][inst_i]);
+    );
+  }
+
+  /// Whole function recombination on shared programs: swaps function handles only.
+  void ApplyWholeFunctionRecombination(
+    emp::Random& random,
+    shared_program_t& program_1,
+    shared_program_t& program_2
+  ) {
+    emp_assert(program_1.GetSize() > 0);
+    emp_assert(program_2.GetSize() > 0);
+    ForEachRecombinationPair(
+      random,
+      program_1.GetSize(),
+      program_2.GetSize(),
+      whole_func_swap_rate,
+      [&program_1, &program_2](size_t p1_func_id, size_t p2_func_id) {
+        program_1.SwapFunctions(p1_func_id, program_2, p2_func_id);
       }
+    );
+  }
 
-      program_1[p1_func_id] = new_p1_func;
-      program_2[p2_func_id] = new_p2_func;
-    }
+  /// Two-point function sequence recombination on shared programs: only recombined functions get new nodes.
+  /// (Shared functions are immutable, so recombined functions are assembled in scratch buffers.)
+  void ApplyFunctionSequenceRecombinationTwoPoint(
+    emp::Random& random,
+    shared_program_t& program_1,
+    shared_program_t& program_2
+  ) {
+    emp_assert(program_1.GetSize() > 0);
+    emp_assert(program_2.GetSize() > 0);
+    ForEachRecombinationPair(
+      random,
+      program_1.GetSize(),
+      program_2.GetSize(),
+      per_func_seq_xover_rate,
+      [this, &random, &program_1, &program_2](size_t p1_func_id, size_t p2_func_id) {
+        const SharedFunction& p1_func = program_1[p1_func_id];
+        const SharedFunction& p2_func = program_2[p2_func_id];
+        emp_assert(p1_func.GetSize() > 0);
+        emp_assert(p2_func.GetSize() > 0);
+        const auto p1_crossover_points = FindTwoPoints(random, p1_func.GetSize());
+        const auto p2_crossover_points = FindTwoPoints(random, p2_func.GetSize());
+        packed_p1_func.assign(p1_func.begin(), p1_func.begin() + p1_crossover_points.first);
+        packed_p1_func.insert(
+          packed_p1_func.end(),
+          p2_func.begin() + p2_crossover_points.first,
+          p2_func.begin() + p2_crossover_points.second + 1
+        );
+        packed_p1_func.insert(packed_p1_func.end(), p1_func.begin() + p1_crossover_points.second + 1, p1_func.end());
+        packed_p2_func.assign(p2_func.begin(), p2_func.begin() + p2_crossover_points.first);
+        packed_p2_func.insert(
+          packed_p2_func.end(),
+          p1_func.begin() + p1_crossover_points.first,
+          p1_func.begin() + p1_crossover_points.second + 1
+        );
+        packed_p2_func.insert(packed_p2_func.end(), p2_func.begin() + p2_crossover_points.second + 1, p2_func.end());
+
+        const SharedFunction new_p1_func(
+          p1_func.GetTag(),
+          packed_p1_func.data(),
+          packed_p1_func.data() + packed_p1_func.size()
+        );
+        const SharedFunction new_p2_func(
+          p2_func.GetTag(),
+          packed_p2_func.data(),
+          packed_p2_func.data() + packed_p2_func.size()
+        );
+        program_1.SetFunction(p1_func_id, new_p1_func);
+        program_2.SetFunction(p2_func_id, new_p2_func);
+      }
+    );
   }
 
   std::pair<size_t, size_t> FindTwoPoints(
     emp::Random& random,
     const function_t& func
   ) {
-    const size_t func_size = func.GetSize();
+    return FindTwoPoints(random, func.GetSize());
+  }
+
+  std::pair<size_t, size_t> FindTwoPoints(
+    emp::Random& random,
+    size_t func_size
+  ) {
     emp_assert(func_size > 0);
     if (func_size == 1) {
       // If function only has 1 instruction, return start and finish as same
@@ -0,0 +1,196 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+#include "emp/base/vector.hpp"
+
+#include "../utility/AlignedAllocator.hpp"
+#include "../utility/ScoreCodec.hpp"
+#include "../utility/memory.hpp"
+
+namespace psynth {
+
+/// Storage type for per-test scores (score tables, taxon phenotypes).
+/// Compile with -DPSYNTH_SCORES_FLOAT or -DPSYNTH_SCORES_FIXED16 (fixed-point in [0, 1]) for compact storage.
+#if defined(PSYNTH_SCORES_FIXED16)
+using stored_score_t = uint16_t;
+#elif defined(PSYNTH_SCORES_FLOAT)
+using stored_score_t = float;
+#else
+using stored_score_t = double;
+#endif
+
+/// Population-wide training case results, stored as a structure of arrays:
+/// - a contiguous score matrix (one cache-line-aligned row per organism),
+/// - packed evaluated / passed bit matrices (one row of 64-bit words per organism),
+/// - per-organism aggregate scores, maintained as results are recorded, and
+/// - a packed population coverage row (tests passed by any organism).
+/// Unevaluated scores are always 0, so a row's aggregate is simply its sum.
+/// Per-organism coverage and evaluation counts are popcounts over bit rows.
+/// Scores are stored as SCORE_T (see utils::ScoreCodec) and decoded to double on access;
+/// aggregates are sums of decoded (i.e., stored) scores.
+template<typename SCORE_T>
+class BasicScoreStore {
+public:
+  using score_t = SCORE_T;
+  using codec_t = utils::ScoreCodec<score_t>;
+  static constexpr size_t ROW_ALIGN = 64;                                ///< Score rows start on a cache line
+  static constexpr size_t SCORES_PER_LINE = ROW_ALIGN / sizeof(score_t);
+
+protected:
+  size_t num_orgs = 0;
+  size_t num_tests = 0;
+  size_t row_stride = 0;   ///< Scores per score row (num_tests padded to a full cache line)
+  size_t num_words = 0;    ///< 64-bit words per bit row
+
+  emp::vector<score_t, utils::AlignedAllocator<score_t, ROW_ALIGN>> scores; ///< Per-organism, per-test score (row-major)
+  emp::vector<uint64_t> evaluated;  ///< Per-organism, per-test evaluated bits (row-major)
+  emp::vector<uint64_t> passes;     ///< Per-organism, per-test pass bits (row-major)
+  emp::vector<double> aggregates;   ///< Per-organism sum of evaluated scores
+  emp::vector<uint64_t> pop_passes; ///< Per-test, passed by any organism since last ResetPopCoverage?
+  size_t num_inexact = 0;           ///< Number of recorded scores changed by encoding (clamped or rounded) since last Resize
+
+  static size_t PopCount(const uint64_t* row, size_t words) {
+    size_t count = 0;
+    for (size_t w = 0; w < words; ++w) {
+      count += (size_t)__builtin_popcountll(row[w]);
+    }
+    return count;
+  }
+
+  static bool GetBit(const uint64_t* row, size_t i) { return (row[i / 64] >> (i % 64)) & 1; }
+  static void SetBit(uint64_t* row, size_t i) { row[i / 64] |= (uint64_t)1 << (i % 64); }
+
+public:
+
+  /// Resize store for a_num_orgs organisms and a_num_tests tests. Clears all results.
+  void Resize(size_t a_num_orgs, size_t a_num_tests) {
+    num_orgs = a_num_orgs;
+    num_tests = a_num_tests;
+    row_stride = ((num_tests + SCORES_PER_LINE - 1) / SCORES_PER_LINE) * SCORES_PER_LINE;
+    num_words = (num_tests + 63) / 64;
+    scores.assign(num_orgs * row_stride, score_t(0));
+    evaluated.assign(num_orgs * num_words, 0);
+    passes.assign(num_orgs * num_words, 0);
+    aggregates.assign(num_orgs, 0.0);
+    pop_passes.assign(num_words, 0);
+    num_inexact = 0;
+  }
+
+  /// Clear all of an organism's results.
+  void ResetOrg(size_t org_id) {
+    emp_assert(org_id < num_orgs);
+    std::fill(ScoreRow(org_id), ScoreRow(org_id) + num_tests, score_t(0));
+    std::fill(EvaluatedRow(org_id), EvaluatedRow(org_id) + num_words, 0);
+    std::fill(PassRow(org_id), PassRow(org_id) + num_words, 0);
+    aggregates[org_id] = 0.0;
+  }
+
+  /// Clear population coverage (does not affect per-organism results).
+  void ResetPopCoverage() {
+    std::fill(pop_passes.begin(), pop_passes.end(), 0);
+  }
+
+  /// Record an organism's result on a test. Each (organism, test) should be recorded at most once between resets.
+  void Record(size_t org_id, size_t test_id, double score, bool pass) {
+    emp_assert(org_id < num_orgs);
+    emp_assert(test_id < num_tests);
+    emp_assert(!IsEvaluated(org_id, test_id));
+    const score_t stored = codec_t::Encode(score);
+    const double decoded = codec_t::Decode(stored);
+    ScoreRow(org_id)[test_id] = stored;
+    aggregates[org_id] += decoded;
+    num_inexact += (size_t)(decoded != score);
+    SetBit(EvaluatedRow(org_id), test_id);
+    if (pass) {
+      SetBit(PassRow(org_id), test_id);
+      SetBit(pop_passes.data(), test_id);
+    }
+  }
+
+  size_t GetNumOrgs() const { return num_orgs; }
+  size_t GetNumTests() const { return num_tests; }
+  size_t GetNumWords() const { return num_words; }
+  /// Number of recorded scores that storage changed (clamped or rounded); always 0 for double storage
+  size_t GetNumInexact() const { return num_inexact; }
+
+  double GetScore(size_t org_id, size_t test_id) const {
+    emp_assert(org_id < num_orgs && test_id < num_tests);
+    return codec_t::Decode(ScoreRow(org_id)[test_id]);
+  }
+
+  bool IsEvaluated(size_t org_id, size_t test_id) const {
+    emp_assert(org_id < num_orgs && test_id < num_tests);
+    return GetBit(EvaluatedRow(org_id), test_id);
+  }
+
+  bool Passed(size_t org_id, size_t test_id) const {
+    emp_assert(org_id < num_orgs && test_id < num_tests);
+    return GetBit(PassRow(org_id), test_id);
+  }
+
+  /// Sum of organism's evaluated scores
+  double GetAggregate(size_t org_id) const {
+    emp_assert(org_id < num_orgs);
+    return aggregates[org_id];
+  }
+  /// Per-organism aggregate scores (reference stays valid across Resize)
+  const emp::vector<double>& GetAggregates() const { return aggregates; }
+
+  /// Number of tests organism has been evaluated on
+  size_t GetNumEvaluated(size_t org_id) const { return PopCount(EvaluatedRow(org_id), num_words); }
+  /// Number of tests organism has passed
+  size_t GetNumPassed(size_t org_id) const { return PopCount(PassRow(org_id), num_words); }
+
+  /// Number of tests passed by at least one organism since last ResetPopCoverage
+  size_t GetPopCoverage() const { return PopCount(pop_passes.data(), num_words); }
+  bool PopCovered(size_t test_id) const {
+    emp_assert(test_id < num_tests);
+    return GetBit(pop_passes.data(), test_id);
+  }
+
+  const score_t* ScoreRow(size_t org_id) const { return scores.data() + (org_id * row_stride); }
+  score_t* ScoreRow(size_t org_id) { return scores.data() + (org_id * row_stride); }
+  const uint64_t* EvaluatedRow(size_t org_id) const { return evaluated.data() + (org_id * num_words); }
+  uint64_t* EvaluatedRow(size_t org_id) { return evaluated.data() + (org_id * num_words); }
+  const uint64_t* PassRow(size_t org_id) const { return passes.data() + (org_id * num_words); }
+  uint64_t* PassRow(size_t org_id) { return passes.data() + (org_id * num_words); }
+
+  /// Heap bytes held by the store's tables
+  size_t GetNumBytes() const {
+    return utils::VectorBytes(scores) + utils::VectorBytes(evaluated) + utils::VectorBytes(passes)
+      + utils::VectorBytes(aggregates) + utils::VectorBytes(pop_passes);
+  }
+
+  /// All pass rows (row-major, GetNumWords() words per organism)
+  const emp::vector<uint64_t>& GetPassRows() const { return passes; }
+
+  /// Copy of an organism's (decoded) scores (e.g., for output)
+  emp::vector<double> GetScores(size_t org_id) const {
+    emp::vector<double> row(num_tests);
+    for (size_t test_id = 0; test_id < num_tests; ++test_id) {
+      row[test_id] = codec_t::Decode(ScoreRow(org_id)[test_id]);
+    }
+    return row;
+  }
+
+  /// Copy of an organism's scores in storage form (e.g., for taxon phenotypes)
+  emp::vector<score_t> GetStoredScores(size_t org_id) const {
+    return emp::vector<score_t>(ScoreRow(org_id), ScoreRow(org_id) + num_tests);
+  }
+
+  /// Copy of an organism's evaluated flags (e.g., for output)
+  emp::vector<bool> GetEvaluated(size_t org_id) const {
+    emp::vector<bool> evals(num_tests, false);
+    for (size_t test_id = 0; test_id < num_tests; ++test_id) {
+      evals[test_id] = IsEvaluated(org_id, test_id);
+    }
+    return evals;
+  }
+
+};
+
+using ScoreStore = BasicScoreStore<stored_score_t>;
+
+}
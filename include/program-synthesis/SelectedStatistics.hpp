@@ -36,7 +36,7 @@ namespace psynth {
       parent_genome_ages.resize(selected.size());
       for (size_t i = 0; i < selected.size(); ++i) {
         const size_t org_id = selected[i];
-        parent_genome_ages[i] = world.GetOrg(org_id).GetGenome().GetAge();
+        parent_genome_ages[i] = world.GetOrgAge(org_id);
       }
 
       for (size_t test_id = 0; test_id < num_tests; ++test_id) {
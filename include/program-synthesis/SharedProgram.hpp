@@ -0,0 +1,313 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <unordered_map>
+#include <utility>
+
+#include "emp/base/vector.hpp"
+
+#include "PackedProgram.hpp"
+
+namespace psynth {
+
+/// Immutable, hash-consed program function (tag + packed instruction sequence).
+/// Nodes are owned by the SharedFunctionTable and reference counted by SharedFunction handles.
+struct SharedFunctionNode {
+  uint32_t tag = 0;
+  emp::vector<PackedInst> insts;
+  size_t hash = 0;
+  size_t ref_count = 0;
+
+  bool Matches(uint32_t a_tag, const PackedInst* begin, const PackedInst* end) const {
+    const size_t size = (size_t)(end - begin);
+    return tag == a_tag
+      && insts.size() == size
+      && (size == 0 || std::memcmp(insts.data(), begin, size * sizeof(PackedInst)) == 0);
+  }
+
+  static size_t HashContent(uint32_t tag, const PackedInst* begin, const PackedInst* end) {
+    uint64_t hash = 14695981039346656037ULL;
+    auto mix = [&hash](uint64_t word) {
+      hash ^= word;
+      hash *= 1099511628211ULL;
+    };
+    mix(((uint64_t)tag << 32) | (uint64_t)(end - begin));
+    for (const PackedInst* inst = begin; inst != end; ++inst) {
+      uint64_t words[2];
+      std::memcpy(words, inst, sizeof(PackedInst));
+      mix(words[0]);
+      mix(words[1]);
+    }
+    return (size_t)hash;
+  }
+};
+
+/// Global table of live function nodes. Each distinct function (tag + instructions) exists once,
+/// no matter how many programs (population members, ancestor taxa, ...) contain it.
+class SharedFunctionTable {
+protected:
+  std::unordered_multimap<size_t, SharedFunctionNode*> nodes;  ///< Content hash => node
+  size_t num_insts = 0;                                        ///< Instructions stored across all nodes
+
+  SharedFunctionTable() = default;
+
+public:
+  SharedFunctionTable(const SharedFunctionTable&) = delete;
+  SharedFunctionTable& operator=(const SharedFunctionTable&) = delete;
+
+  ~SharedFunctionTable() {
+    for (auto& entry : nodes) delete entry.second;
+  }
+
+  static SharedFunctionTable& Get() {
+    static SharedFunctionTable table;
+    return table;
+  }
+
+  /// Find (or create) the node for function (tag, [begin, end)). Caller takes a reference.
+  SharedFunctionNode* Intern(uint32_t tag, const PackedInst* begin, const PackedInst* end) {
+    const size_t hash = SharedFunctionNode::HashContent(tag, begin, end);
+    auto range = nodes.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (it->second->Matches(tag, begin, end)) {
+        ++(it->second->ref_count);
+        return it->second;
+      }
+    }
+    SharedFunctionNode* node = new SharedFunctionNode();
+    node->tag = tag;
+    node->insts.assign(begin, end);
+    node->hash = hash;
+    node->ref_count = 1;
+    nodes.emplace(hash, node);
+    num_insts += node->insts.size();
+    return node;
+  }
+
+  /// Drop a reference to node; node is freed when no programs reference it.
+  void Release(SharedFunctionNode* node) {
+    emp_assert(node->ref_count > 0);
+    if (--(node->ref_count) > 0) return;
+    auto range = nodes.equal_range(node->hash);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (it->second == node) {
+        nodes.erase(it);
+        break;
+      }
+    }
+    num_insts -= node->insts.size();
+    delete node;
+  }
+
+  /// Number of distinct live functions
+  size_t GetNumFunctions() const { return nodes.size(); }
+  /// Number of instructions stored across all distinct live functions
+  size_t GetNumInsts() const { return num_insts; }
+  /// Approximate heap bytes held by the table (nodes, instructions, and hash table entries)
+  size_t GetNumBytes() const {
+    return (nodes.size() * (sizeof(SharedFunctionNode) + sizeof(std::pair<size_t, SharedFunctionNode*>) + 2 * sizeof(void*)))
+      + (nodes.bucket_count() * sizeof(void*))
+      + (num_insts * sizeof(PackedInst));
+  }
+};
+
+/// Reference-counted handle to an immutable shared function.
+class SharedFunction {
+protected:
+  SharedFunctionNode* node = nullptr;
+
+  void Release() {
+    if (node != nullptr) SharedFunctionTable::Get().Release(node);
+    node = nullptr;
+  }
+
+public:
+  SharedFunction() = default;
+  SharedFunction(uint32_t tag, const PackedInst* begin, const PackedInst* end)
+    : node(SharedFunctionTable::Get().Intern(tag, begin, end)) { ; }
+  SharedFunction(const SharedFunction& other) : node(other.node) {
+    if (node != nullptr) ++(node->ref_count);
+  }
+  SharedFunction(SharedFunction&& other) noexcept : node(other.node) { other.node = nullptr; }
+  ~SharedFunction() { Release(); }
+
+  SharedFunction& operator=(const SharedFunction& other) {
+    if (node == other.node) return *this;
+    if (other.node != nullptr) ++(other.node->ref_count);
+    Release();
+    node = other.node;
+    return *this;
+  }
+  SharedFunction& operator=(SharedFunction&& other) noexcept {
+    if (this != &other) {
+      Release();
+      node = other.node;
+      other.node = nullptr;
+    }
+    return *this;
+  }
+
+  bool IsNull() const { return node == nullptr; }
+  uint32_t GetTag() const { emp_assert(node); return node->tag; }
+  size_t GetSize() const { emp_assert(node); return node->insts.size(); }
+  size_t GetHash() const { emp_assert(node); return node->hash; }
+  size_t GetRefCount() const { return node == nullptr ? 0 : node->ref_count; }
+  const PackedInst* begin() const { emp_assert(node); return node->insts.data(); }
+  const PackedInst* end() const { emp_assert(node); return node->insts.data() + node->insts.size(); }
+  const PackedInst& operator[](size_t i) const { emp_assert(i < GetSize()); return node->insts[i]; }
+
+  /// Hash-consed: identical functions share a node.
+  bool operator==(const SharedFunction& other) const { return node == other.node; }
+  bool operator!=(const SharedFunction& other) const { return node != other.node; }
+  /// Content ordering (deterministic across runs)
+  bool operator<(const SharedFunction& other) const {
+    if (node == other.node) return false;
+    if (GetTag() != other.GetTag()) return GetTag() < other.GetTag();
+    return std::lexicographical_compare(begin(), end(), other.begin(), other.end());
+  }
+};
+
+/// Program whose functions are immutable, hash-consed, and shared (via the global SharedFunctionTable)
+/// with every other program that contains them. Copying a program copies function handles only;
+/// mutation/recombination create new nodes only for functions they actually change.
+template<size_t TAG_W>
+class SharedProgram {
+public:
+  using this_t = SharedProgram<TAG_W>;
+  using packed_program_t = PackedProgram<TAG_W>;
+
+protected:
+  emp::vector<SharedFunction> funcs;
+  size_t inst_count = 0;
+
+public:
+  SharedProgram() = default;
+  SharedProgram(const packed_program_t& packed) { Repack(packed); }
+
+  size_t GetSize() const { return funcs.size(); }
+  size_t GetInstCount() const { return inst_count; }
+  const SharedFunction& operator[](size_t fID) const {
+    emp_assert(fID < GetSize());
+    return funcs[fID];
+  }
+
+  void PushFunction(const SharedFunction& func) {
+    inst_count += func.GetSize();
+    funcs.emplace_back(func);
+  }
+
+  void PopFunction() {
+    emp_assert(GetSize() > 0);
+    inst_count -= funcs.back().GetSize();
+    funcs.pop_back();
+  }
+
+  /// Replace function fID.
+  void SetFunction(size_t fID, const SharedFunction& func) {
+    emp_assert(fID < GetSize());
+    inst_count = inst_count - funcs[fID].GetSize() + func.GetSize();
+    funcs[fID] = func;
+  }
+
+  void SwapFunctions(size_t fID, this_t& other, size_t other_fID) {
+    emp_assert(fID < GetSize() && other_fID < other.GetSize());
+    const size_t size = funcs[fID].GetSize();
+    const size_t other_size = other.funcs[other_fID].GetSize();
+    std::swap(funcs[fID], other.funcs[other_fID]);
+    inst_count = inst_count - size + other_size;
+    other.inst_count = other.inst_count - other_size + size;
+  }
+
+  /// Unpack into a (mutable) packed program.
+  void Unpack(packed_program_t& packed) const {
+    packed.Clear();
+    packed.GetInsts().reserve(inst_count);
+    for (const SharedFunction& func : funcs) {
+      packed.PushFunction(func.GetTag());
+      for (const PackedInst& inst : func) packed.PushInst(inst);
+    }
+  }
+
+  /// Rebuild from a packed program, keeping handles for functions that did not change.
+  void Repack(const packed_program_t& packed) {
+    funcs.resize(std::min(funcs.size(), packed.GetSize()));
+    for (size_t fID = 0; fID < packed.GetSize(); ++fID) {
+      const uint32_t tag = packed.GetFunctionTag(fID);
+      const PackedInst* begin = packed.FunctionBegin(fID);
+      const PackedInst* end = packed.FunctionEnd(fID);
+      if (fID < funcs.size()) {
+        const size_t size = (size_t)(end - begin);
+        const bool unchanged = funcs[fID].GetTag() == tag
+          && funcs[fID].GetSize() == size
+          && (size == 0 || std::memcmp(funcs[fID].begin(), begin, size * sizeof(PackedInst)) == 0);
+        if (!unchanged) funcs[fID] = SharedFunction(tag, begin, end);
+      } else {
+        funcs.emplace_back(tag, begin, end);
+      }
+    }
+    inst_count = packed.GetInstCount();
+  }
+
+  template<typename PROGRAM_T>
+  static this_t FromProgram(const PROGRAM_T& program) {
+    return this_t(packed_program_t::FromProgram(program));
+  }
+
+  template<typename PROGRAM_T>
+  PROGRAM_T ToProgram() const {
+    packed_program_t packed;
+    Unpack(packed);
+    return packed.template ToProgram<PROGRAM_T>();
+  }
+
+  /// Function handles are hash-consed, so equality is a handle (pointer) comparison.
+  bool operator==(const this_t& other) const { return funcs == other.funcs; }
+  bool operator!=(const this_t& other) const { return !(*this == other); }
+  bool operator<(const this_t& other) const {
+    return std::lexicographical_compare(funcs.begin(), funcs.end(), other.funcs.begin(), other.funcs.end());
+  }
+
+  size_t Hash() const {
+    size_t hash = funcs.size();
+    for (const SharedFunction& func : funcs) {
+      hash ^= func.GetHash() + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+    }
+    return hash;
+  }
+
+  /// Print program in the (SignalGP) print format read by LoadLinearFunctionsProgram_PrintFormat.
+  template<typename INST_LIB_T>
+  void Print(std::ostream& out, const INST_LIB_T& ilib) const {
+    for (size_t fID = 0; fID < GetSize(); ++fID) {
+      out << "(";
+      packed_program_t::PrintTag(out, funcs[fID].GetTag());
+      out << ") Fn-" << fID << "\n";
+      for (const PackedInst& inst : funcs[fID]) {
+        out << "  (";
+        packed_program_t::PrintTag(out, inst.tag);
+        out << ") " << ilib.GetName(inst.op) << " [";
+        for (size_t k = 0; k < PackedInst::NUM_ARGS; ++k) {
+          if (k) out << ", ";
+          out << (int)inst.args[k];
+        }
+        out << "]\n";
+      }
+    }
+  }
+
+};
+
+}
+
+namespace std {
+
+template<size_t TAG_W>
+struct hash<psynth::SharedProgram<TAG_W>> {
+  size_t operator()(const psynth::SharedProgram<TAG_W>& program) const { return program.Hash(); }
+};
+
+}
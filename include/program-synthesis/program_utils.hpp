@@ -10,6 +10,10 @@
 #include "sgp/cpu/lfunprg/LinearFunctionsProgram.hpp"
 #include "sgp/cpu/linprg/Instruction.hpp"
 
+#include "PackedProgram.hpp"
+#include "SharedProgram.hpp"
+#include "../utility/memory.hpp"
+
 
 namespace psynth {
 
@@ -86,6 +90,79 @@ void PrintProgramJSON(
   out << "}";
 }
 
+template<typename INST_LIB_T, size_t TAG_W>
+void PrintProgramJSON(
+  std::ostream& out,
+  const PackedProgram<TAG_W>& program,
+  const INST_LIB_T& ilib
+) {
+  using packed_program_t = PackedProgram<TAG_W>;
+  out << "{";
+  out << "\"functions\":[";
+  for (size_t func_i = 0; func_i < program.GetSize(); ++func_i) {
+    if (func_i) out << ",";
+    out << "{";
+    out << "\"id\":" << func_i << ",";
+    out << "\"tags\":[\"";
+    packed_program_t::PrintTag(out, program.GetFunctionTag(func_i));
+    out << "\"],";
+    out << "\"instructions\":[";
+    for (size_t inst_i = 0; inst_i < program.GetFunctionSize(func_i); ++inst_i) {
+      const PackedInst& inst = program.GetInst(func_i, inst_i);
+      if (inst_i) out << ",";
+      out << "{";
+      out << "\"name\":\"" << ilib.GetName(inst.op) << "\",";
+      out << "\"tags\":[\"";
+      packed_program_t::PrintTag(out, inst.tag);
+      out << "\"],";
+      out << "\"args\":[";
+      for (size_t arg_i = 0; arg_i < PackedInst::NUM_ARGS; ++arg_i) {
+        if (arg_i) out << ",";
+        out << "\"" << (int)inst.args[arg_i] << "\"";
+      }
+      out << "]";
+      out << "}";
+    }
+    out << "]"; // End instructions
+    out << "}"; // End function
+  }
+  out << "]"; // End functions
+  out << "}";
+}
+
+/// Approximate heap bytes held by a program (function and instruction buffers).
+/// SignalGP does not expose instruction buffer capacities, so instruction sequences are counted by size.
+template<typename TAG_T, typename INST_ARG_T>
+size_t GetProgramBytes(const sgp::cpu::lfunprg::LinearFunctionsProgram<TAG_T, INST_ARG_T>& program) {
+  using program_t = sgp::cpu::lfunprg::LinearFunctionsProgram<TAG_T, INST_ARG_T>;
+  using function_t = typename program_t::function_t;
+  using inst_t = typename program_t::inst_t;
+  size_t bytes = program.GetSize() * sizeof(function_t);
+  for (size_t func_i = 0; func_i < program.GetSize(); ++func_i) {
+    const auto& function = program[func_i];
+    bytes += utils::VectorBytes(function.GetTags());
+    bytes += function.GetSize() * sizeof(inst_t);
+    for (size_t inst_i = 0; inst_i < function.GetSize(); ++inst_i) {
+      bytes += utils::VectorBytes(function[inst_i].GetArgs());
+      bytes += utils::VectorBytes(function[inst_i].GetTags());
+    }
+  }
+  return bytes;
+}
+
+template<size_t TAG_W>
+size_t GetProgramBytes(const PackedProgram<TAG_W>& program) {
+  return utils::VectorBytes(program.GetInsts())
+    + utils::VectorBytes(program.GetFunctionOffsets())
+    + utils::VectorBytes(program.GetFunctionTags());
+}
+
+/// Function handles only (shared functions are accounted for by the SharedFunctionTable).
+template<size_t TAG_W>
+size_t GetProgramBytes(const SharedProgram<TAG_W>& program) {
+  return program.GetSize() * sizeof(SharedFunction);
+}
+
 template<size_t TAG_WIDTH>
 emp::BitSet<TAG_WIDTH> FromString_BitSet(
   const std::string& bit_str
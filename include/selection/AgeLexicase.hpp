@@ -9,6 +9,8 @@
 #include "emp/datastructs/vector_utils.hpp"
 
 #include "BaseSelect.hpp"
+#include "ScoreRanks.hpp"
+#include "SelectionProfile.hpp"
 
 namespace selection {
 
@@ -38,6 +40,14 @@ protected:
   emp::vector<size_t> age_fun_valid_locs;   ///< Possible locations in shuffle for age functions
   emp::vector<size_t> score_fun_ordering;   ///< Initial locations in shuffle for score functions
 
+  size_t batch_size = 1;                    ///< Max number of selections made per shuffled criteria ordering
+  bool use_rank_compression = true;         ///< Filter on dense per-criterion score ranks where possible?
+  ScoreRankTable score_ranks;               ///< Per-criterion score ranks (rebuilt with score table)
+  emp::vector<size_t> cur_pool;             ///< Used internally: candidates remaining in current selection event
+  emp::vector<size_t> next_pool;            ///< Used internally: candidates surviving current criterion
+  SelectionProfile* profile = nullptr;      ///< If set, selection events are recorded here
+  const emp::vector<size_t>* age_source = nullptr; ///< If set, per-candidate ages read directly (instead of calling age functions)
+
   void ShuffleEvalOrdering() {
     // std::cout << "-- ShuffleEvalOrdering --" << std::endl;
     // Shuffle age_fun_ordering and score_fun_ordering into each other
@@ -103,7 +113,7 @@ public:
         all_eval_criteria[cand_id].emplace_back(age_fun);
       }
     }
-    SetAgeFunOrderLimit(all_eval_criteria.size());
+    SetAgeFunOrderLimit(all_eval_criteria[0].size());
   }
 
   emp::vector<size_t>& operator()(size_t n) override;
@@ -114,11 +124,50 @@ public:
     const emp::vector<size_t>& score_fun_ids
   );
 
+  /// Age functions appear within the first k criteria of each ordering (k <= # score + age functions).
   void SetAgeFunOrderLimit(size_t k) {
-    emp_assert(k <= all_eval_criteria.size());
+    emp_assert(k <= all_eval_criteria[0].size());
     age_fun_order_limit = k;
   }
 
+  /// Set the maximum number of parents selected from each criteria ordering.
+  void SetBatchSize(size_t b) {
+    emp_assert(b > 0);
+    batch_size = b;
+  }
+  size_t GetBatchSize() const { return batch_size; }
+
+  /// Should lexicase filter on dense score ranks? (Selection results are identical either way.)
+  void SetRankCompression(bool use) { use_rank_compression = use; }
+  bool GetRankCompression() const { return use_rank_compression; }
+
+  /// Record selection events into p (nullptr to stop recording). Does not take ownership.
+  void SetProfile(SelectionProfile* p) { profile = p; }
+
+  size_t GetNumBytes() const override {
+    return BaseSelect::GetNumBytes()
+      + utils::NestedVectorBytes(all_eval_criteria)
+      + utils::VectorBytes(all_score_fun_ids)
+      + utils::VectorBytes(all_age_fun_ids)
+      + utils::NestedVectorBytes(score_table)
+      + utils::VectorBytes(eval_criteria_ordering)
+      + utils::VectorBytes(candidate_idxs)
+      + utils::VectorBytes(all_candidate_ids)
+      + utils::VectorBytes(all_fun_ids)
+      + utils::VectorBytes(age_fun_valid_locs)
+      + utils::VectorBytes(score_fun_ordering)
+      + score_ranks.GetNumBytes()
+      + utils::VectorBytes(cur_pool)
+      + utils::VectorBytes(next_pool);
+  }
+
+  /// Read the (single) age criterion directly from ages (indexed by candidate id; younger is better)
+  /// instead of calling the age functions. ages must outlive the selector (nullptr to stop).
+  void SetAgeSource(const emp::vector<size_t>* ages) {
+    emp_assert(ages == nullptr || all_age_fun_ids.size() == 1);
+    age_source = ages;
+  }
+
 };
 
 emp::vector<size_t>& AgeLexicaseSelect::operator()(size_t n) {
@@ -147,7 +196,8 @@ emp::vector<size_t>& AgeLexicaseSelect::operator()(
   const size_t fun_cnt = score_fun_ids.size() + all_age_fun_ids.size();
   emp_assert(all_eval_criteria.size() > 0);
   emp_assert(num_candidates > 0);
-  emp_assert(num_candidates <= all_eval_criteria.size());
+  // Candidate ids may repeat (e.g., to stand in for duplicate phenotypes), but must be valid
+  emp_assert(std::all_of(candidate_ids.begin(), candidate_ids.end(), [this](size_t id) { return id < all_eval_criteria.size(); }));
   emp_assert(fun_cnt > 0);
   emp_assert(fun_cnt <= all_eval_criteria.back().size());
   // Reset internal selected vector
@@ -162,9 +212,9 @@ emp::vector<size_t>& AgeLexicaseSelect::operator()(
     emp_assert(emp::Has(all_score_fun_ids, fun_id));
 
     for (size_t cand_i = 0; cand_i < num_candidates; ++cand_i) {
-      emp_assert(fun_cnt <= all_eval_criteria[cand_i].size());
-      emp_assert(fun_id < all_eval_criteria[cand_i].size());
       const size_t cand_id = candidate_ids[cand_i];
+      emp_assert(fun_cnt <= all_eval_criteria[cand_id].size());
+      emp_assert(fun_id < all_eval_criteria[cand_id].size());
       score_table[fun_i][cand_i] = all_eval_criteria[cand_id][fun_id]();
     }
   }
@@ -174,6 +224,15 @@ emp::vector<size_t>& AgeLexicaseSelect::operator()(
     const size_t eval_fun_id = all_age_fun_ids[age_fun_i];
     emp_assert(score_table_id < score_table.size());
     score_table[score_table_id].resize(num_candidates);
+    if (age_source != nullptr) {
+      const auto& ages = *age_source;
+      for (size_t cand_i = 0; cand_i < num_candidates; ++cand_i) {
+        const size_t cand_id = candidate_ids[cand_i];
+        emp_assert(cand_id < ages.size());
+        score_table[score_table_id][cand_i] = -1.0 * (double)ages[cand_id];
+      }
+      continue;
+    }
     for (size_t cand_i = 0; cand_i < num_candidates; ++cand_i) {
       const size_t cand_id = candidate_ids[cand_i];
       emp_assert(cand_i < score_table[score_table_id].size());
@@ -182,6 +241,10 @@ emp::vector<size_t>& AgeLexicaseSelect::operator()(
       score_table[score_table_id][cand_i] = all_eval_criteria[cand_id][eval_fun_id]();
     }
   }
+  // Compress each criterion's scores into dense ranks
+  if (use_rank_compression) {
+    score_ranks.Build(score_table);
+  }
 
   // Come up with lexicase ordering
   // - Need to weave in the age functions to follow constraints
@@ -213,42 +276,66 @@ emp::vector<size_t>& AgeLexicaseSelect::operator()(
       0
     );
   }
-  emp::vector<size_t> cur_pool, next_pool;
-  for (size_t sel_i = 0; sel_i < n; ++sel_i) {
+  next_pool.clear();
+  for (size_t sel_i = 0; sel_i < n; ) {
     // Randomize the score ordering
     ShuffleEvalOrdering();
     // Step through each score
     cur_pool = candidate_idxs;
     int depth = -1;
+    int decided_depth = -1;       // Depth of last criterion to shrink the pool (only tracked when profiling)
     // For each score, filter the population down to only the best performers.
     for (size_t score_id : eval_criteria_ordering) {
       ++depth;
-      double max_score = score_table[score_id][cur_pool[0]]; // Max score starts as first candidate's score on this function.
-      next_pool.emplace_back(cur_pool[0]); // Seed the keeper pool with the first candidate.
+      if (use_rank_compression && score_ranks.IsCompressed(score_id)) {
+        // Filter on dense ranks (equivalent to filtering on raw scores)
+        score_ranks.FilterMaxRank(score_id, cur_pool, next_pool);
+      } else {
+        double max_score = score_table[score_id][cur_pool[0]]; // Max score starts as first candidate's score on this function.
+        next_pool.emplace_back(cur_pool[0]); // Seed the keeper pool with the first candidate.
 
-      for (size_t i = 1; i < cur_pool.size(); ++i) {
-        const size_t cand_idx = cur_pool[i];
-        const double cur_score = score_table[score_id][cand_idx];
-        if (cur_score > max_score) {
-          max_score = cur_score;        // This is the new max score for this function
-          next_pool.resize(1);          // Clear out candidates with former max score
-          next_pool[0] = cand_idx;      // Add this candidate as only one with the new max
-        } else if (cur_score == max_score) {
-          next_pool.emplace_back(cand_idx);
+        for (size_t i = 1; i < cur_pool.size(); ++i) {
+          const size_t cand_idx = cur_pool[i];
+          const double cur_score = score_table[score_id][cand_idx];
+          if (cur_score > max_score) {
+            max_score = cur_score;        // This is the new max score for this function
+            next_pool.resize(1);          // Clear out candidates with former max score
+            next_pool[0] = cand_idx;      // Add this candidate as only one with the new max
+          } else if (cur_score == max_score) {
+            next_pool.emplace_back(cand_idx);
+          }
         }
       }
+      if (profile != nullptr) {
+        profile->RecordStep((size_t)depth, next_pool.size());
+        if (next_pool.size() < cur_pool.size()) decided_depth = depth;
+      }
       // Make next_pool into new cur_pool; make cur_pool allocated space for next_pool
       std::swap(cur_pool, next_pool);
       next_pool.resize(0);
       if (cur_pool.size() == 1) break; // Stop if we're down to just one candidate.
     }
-    // Select a random survivor (all equal at this point)
+    if (profile != nullptr) {
+      profile->RecordEvent((size_t)depth + 1, cur_pool.size());
+      // Age criteria come after score functions in the score table
+      if (decided_depth >= 0 && eval_criteria_ordering[decided_depth] >= score_fun_ids.size()) {
+        profile->RecordAgeDecision((size_t)decided_depth);
+      }
+    }
+    // Select random survivors (all equal at this point). One ordering fills up to batch_size selection slots.
+    // Survivors are drawn without replacement; the pool is recycled if the batch is larger than the pool.
     emp_assert(cur_pool.size() > 0);
-    const size_t win_id = (cur_pool.size() == 1)
-      ? cur_pool.back()
-      : cur_pool[random.GetUInt(cur_pool.size())];
-    emp_assert(win_id < candidate_ids.size());
-    selected[sel_i] = candidate_ids[win_id]; // Transform win id (which is an index into score table) back into an actual candidate id
+    const size_t batch_end = std::min(n, sel_i + batch_size);
+    for (size_t draw_i = 0; sel_i < batch_end; ++sel_i, ++draw_i) {
+      const size_t pool_pos = draw_i % cur_pool.size();
+      const size_t remaining = cur_pool.size() - pool_pos;
+      if (remaining > 1) {
+        std::swap(cur_pool[pool_pos], cur_pool[pool_pos + random.GetUInt(remaining)]);
+      }
+      const size_t win_id = cur_pool[pool_pos];
+      emp_assert(win_id < candidate_ids.size());
+      selected[sel_i] = candidate_ids[win_id]; // Transform win id (which is an index into score table) back into an actual candidate id
+    }
   }
   return selected;
 }
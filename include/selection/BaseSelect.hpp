@@ -2,6 +2,8 @@
 
 #include "emp/base/vector.hpp"
 
+#include "../utility/memory.hpp"
+
 namespace selection {
 
 struct BaseSelect {
@@ -18,6 +20,9 @@ struct BaseSelect {
   emp::vector<size_t>& GetSelected() { return selected; }
   const emp::vector<size_t>& GetSelected() const { return selected; }
 
+  /// Heap bytes held by this selector's buffers
+  virtual size_t GetNumBytes() const { return utils::VectorBytes(selected); }
+
 };
 
 }
\ No newline at end of file
@@ -8,6 +8,8 @@
 #include "emp/math/random_utils.hpp"
 
 #include "BaseSelect.hpp"
+#include "ScoreRanks.hpp"
+#include "SelectionProfile.hpp"
 
 namespace selection {
 
@@ -25,6 +27,16 @@ protected:
   emp::vector<size_t> candidate_idxs;               ///< Does not contain ids. Contains indices into score table.
   emp::vector<size_t> all_candidate_ids;
   emp::vector<size_t> all_fun_ids;
+
+  size_t batch_size = 1;                            ///< Max number of selections made per shuffled function ordering
+  bool use_rank_compression = true;                 ///< Filter on dense per-function score ranks where possible?
+  ScoreRankTable score_ranks;                       ///< Per-function score ranks (rebuilt with score table)
+  SelectionProfile* profile = nullptr;              ///< If set, selection events are recorded here
+  bool lazy_scores = false;                         ///< Call score functions on first access during filtering (instead of up front)?
+  emp::vector< emp::vector<bool> > score_known;     ///< Lazy mode: per-function, per-candidate, has score_table entry been filled?
+  size_t lazy_batch_size = 1;                       ///< Lazy mode: # of functions (current + upcoming in ordering) scored per candidate at once
+  emp::vector<size_t> cur_pool;                     ///< Used internally: candidates remaining in current selection event
+  emp::vector<size_t> next_pool;                    ///< Used internally: candidates surviving current criterion
 public:
 
   LexicaseSelect(
@@ -43,6 +55,49 @@ public:
     const emp::vector<size_t>& fun_ids
   );
 
+  /// Set the maximum number of parents selected from each function ordering.
+  void SetBatchSize(size_t b) {
+    emp_assert(b > 0);
+    batch_size = b;
+  }
+  size_t GetBatchSize() const { return batch_size; }
+
+  /// Should lexicase filter on dense score ranks? (Selection results are identical either way.)
+  void SetRankCompression(bool use) { use_rank_compression = use; }
+  bool GetRankCompression() const { return use_rank_compression; }
+
+  /// Record selection events into p (nullptr to stop recording). Does not take ownership.
+  void SetProfile(SelectionProfile* p) { profile = p; }
+
+  /// Should score functions be called lazily, only for the candidates still in a pool when their
+  /// function comes up (and at most once per candidate per call)? Selection results are identical
+  /// either way. Lazy mode filters on raw scores (rank compression needs full score columns).
+  void SetLazyScores(bool lazy) { lazy_scores = lazy; }
+  bool GetLazyScores() const { return lazy_scores; }
+
+  /// Lazy mode: when a candidate needs a score, also score it on the next (b - 1) functions in the
+  /// current ordering, so each candidate's score functions are called back-to-back (e.g., so that
+  /// an evaluator only needs to load a candidate's program once per batch). Look-ahead scores may
+  /// never be used by filtering, so b > 1 calls more score functions than b = 1 (the default).
+  void SetLazyBatchSize(size_t b) {
+    emp_assert(b > 0);
+    lazy_batch_size = b;
+  }
+  size_t GetLazyBatchSize() const { return lazy_batch_size; }
+
+  size_t GetNumBytes() const override {
+    return BaseSelect::GetNumBytes()
+      + utils::NestedVectorBytes(score_table)
+      + utils::VectorBytes(score_ordering)
+      + utils::VectorBytes(candidate_idxs)
+      + utils::VectorBytes(all_candidate_ids)
+      + utils::VectorBytes(all_fun_ids)
+      + score_ranks.GetNumBytes()
+      + utils::VectorBytes(cur_pool)
+      + utils::VectorBytes(next_pool)
+      + utils::NestedVectorBytes(score_known);
+  }
+
 };
 
 emp::vector<size_t>& LexicaseSelect::operator()(size_t n) {
@@ -80,7 +135,8 @@ emp::vector<size_t>& LexicaseSelect::operator()(
   const size_t fun_cnt = fun_ids.size();
   emp_assert(score_fun_sets.size() > 0);
   emp_assert(num_candidates > 0);
-  emp_assert(num_candidates <= score_fun_sets.size());
+  // Candidate ids may repeat (e.g., to stand in for duplicate phenotypes), but must be valid
+  emp_assert(std::all_of(candidate_ids.begin(), candidate_ids.end(), [this](size_t id) { return id < score_fun_sets.size(); }));
   emp_assert(fun_cnt > 0);
   emp_assert(fun_cnt <= score_fun_sets.back().size());
 
@@ -89,15 +145,28 @@ emp::vector<size_t>& LexicaseSelect::operator()(
 
   // Update the score table
   score_table.resize(fun_cnt);
-  for (size_t fun_i = 0; fun_i < fun_cnt; ++fun_i) {
-    score_table[fun_i].resize(num_candidates);
-    const size_t fun_id = fun_ids[fun_i];
-
-    for (size_t cand_i = 0; cand_i < num_candidates; ++cand_i) {
-      emp_assert(fun_cnt <= score_fun_sets[cand_i].size());
-      emp_assert(fun_id < score_fun_sets[cand_i].size());
-      const size_t cand_id = candidate_ids[cand_i];
-      score_table[fun_i][cand_i] = score_fun_sets[cand_id][fun_id]();
+  if (lazy_scores) {
+    // Scores are filled in during filtering
+    score_known.resize(fun_cnt);
+    for (size_t fun_i = 0; fun_i < fun_cnt; ++fun_i) {
+      score_table[fun_i].resize(num_candidates);
+      score_known[fun_i].assign(num_candidates, false);
+    }
+  } else {
+    for (size_t fun_i = 0; fun_i < fun_cnt; ++fun_i) {
+      score_table[fun_i].resize(num_candidates);
+      const size_t fun_id = fun_ids[fun_i];
+
+      for (size_t cand_i = 0; cand_i < num_candidates; ++cand_i) {
+        const size_t cand_id = candidate_ids[cand_i];
+        emp_assert(fun_cnt <= score_fun_sets[cand_id].size());
+        emp_assert(fun_id < score_fun_sets[cand_id].size());
+        score_table[fun_i][cand_i] = score_fun_sets[cand_id][fun_id]();
+      }
+    }
+    // Compress each function's scores into dense ranks
+    if (use_rank_compression) {
+      score_ranks.Build(score_table);
     }
   }
 
@@ -119,8 +188,8 @@ emp::vector<size_t>& LexicaseSelect::operator()(
       0
     );
   }
-  emp::vector<size_t> cur_pool, next_pool;
-  for (size_t sel_i = 0; sel_i < n; ++sel_i) {
+  next_pool.clear();
+  for (size_t sel_i = 0; sel_i < n; ) {
     // Randomize the score ordering
     emp::Shuffle(random, score_ordering);
     // Step through each score
@@ -129,32 +198,61 @@ emp::vector<size_t>& LexicaseSelect::operator()(
     // For each score, filter the population down to only the best performers.
     for (size_t score_id : score_ordering) {
       ++depth;
-      double max_score = score_table[score_id][cur_pool[0]]; // Max score starts as first candidate's score on this function.
-      next_pool.emplace_back(cur_pool[0]); // Seed the keeper pool with the first candidate.
-
-      for (size_t i = 1; i < cur_pool.size(); ++i) {
-        const size_t cand_idx = cur_pool[i];
-        const double cur_score = score_table[score_id][cand_idx];
-        if (cur_score > max_score) {
-          max_score = cur_score;        // This is the new max score for this function
-          next_pool.resize(1);          // Clear out candidates with former max score
-          next_pool[0] = cand_idx;      // Add this candidate as only one with the new max
-        } else if (cur_score == max_score) {
-          next_pool.emplace_back(cand_idx);
+      if (lazy_scores) {
+        // Fill in any scores on this function that haven't been looked at yet
+        // (along with each such candidate's scores on the next few functions in the ordering)
+        const size_t batch_end = std::min(score_ordering.size(), (size_t)depth + lazy_batch_size);
+        for (size_t cand_idx : cur_pool) {
+          if (score_known[score_id][cand_idx]) continue;
+          const size_t cand_id = candidate_ids[cand_idx];
+          for (size_t order_i = (size_t)depth; order_i < batch_end; ++order_i) {
+            const size_t batch_score_id = score_ordering[order_i];
+            if (score_known[batch_score_id][cand_idx]) continue;
+            score_table[batch_score_id][cand_idx] = score_fun_sets[cand_id][fun_ids[batch_score_id]]();
+            score_known[batch_score_id][cand_idx] = true;
+          }
         }
       }
+      if (use_rank_compression && !lazy_scores && score_ranks.IsCompressed(score_id)) {
+        // Filter on dense ranks (equivalent to filtering on raw scores)
+        score_ranks.FilterMaxRank(score_id, cur_pool, next_pool);
+      } else {
+        double max_score = score_table[score_id][cur_pool[0]]; // Max score starts as first candidate's score on this function.
+        next_pool.emplace_back(cur_pool[0]); // Seed the keeper pool with the first candidate.
+
+        for (size_t i = 1; i < cur_pool.size(); ++i) {
+          const size_t cand_idx = cur_pool[i];
+          const double cur_score = score_table[score_id][cand_idx];
+          if (cur_score > max_score) {
+            max_score = cur_score;        // This is the new max score for this function
+            next_pool.resize(1);          // Clear out candidates with former max score
+            next_pool[0] = cand_idx;      // Add this candidate as only one with the new max
+          } else if (cur_score == max_score) {
+            next_pool.emplace_back(cand_idx);
+          }
+        }
+      }
+      if (profile != nullptr) profile->RecordStep((size_t)depth, next_pool.size());
       // Make next_pool into new cur_pool; make cur_pool allocated space for next_pool
       std::swap(cur_pool, next_pool);
       next_pool.resize(0);
       if (cur_pool.size() == 1) break; // Stop if we're down to just one candidate.
     }
-    // Select a random survivor (all equal at this point)
+    if (profile != nullptr) profile->RecordEvent((size_t)depth + 1, cur_pool.size());
+    // Select random survivors (all equal at this point). One ordering fills up to batch_size selection slots.
+    // Survivors are drawn without replacement; the pool is recycled if the batch is larger than the pool.
     emp_assert(cur_pool.size() > 0);
-    const size_t win_id = (cur_pool.size() == 1)
-      ? cur_pool.back()
-      : cur_pool[random.GetUInt(cur_pool.size())];
-    emp_assert(win_id < candidate_ids.size());
-    selected[sel_i] = candidate_ids[win_id]; // Transform win id (which is an index into score table) back into an actual candidate id
+    const size_t batch_end = std::min(n, sel_i + batch_size);
+    for (size_t draw_i = 0; sel_i < batch_end; ++sel_i, ++draw_i) {
+      const size_t pool_pos = draw_i % cur_pool.size();
+      const size_t remaining = cur_pool.size() - pool_pos;
+      if (remaining > 1) {
+        std::swap(cur_pool[pool_pos], cur_pool[pool_pos + random.GetUInt(remaining)]);
+      }
+      const size_t win_id = cur_pool[pool_pos];
+      emp_assert(win_id < candidate_ids.size());
+      selected[sel_i] = candidate_ids[win_id]; // Transform win id (which is an index into score table) back into an actual candidate id
+    }
   }
   return selected;
 }
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <functional>
+#include <algorithm>
+#include <numeric>
+
+#include "emp/base/vector.hpp"
+#include "emp/math/Random.hpp"
+
+#include "BaseSelect.hpp"
+#include "../utility/pareto.hpp"
+
+namespace selection {
+
+/// NSGA-II style parent selection: candidates are sorted into non-dominated fronts
+/// over their per-function scores, and each parent is the winner of a binary
+/// crowded tournament (lower front wins; ties go to larger crowding distance).
+struct NSGA2Select : public BaseSelect {
+public:
+  using score_fun_t = std::function<double(void)>;
+protected:
+  emp::vector< emp::vector<score_fun_t> >& score_fun_sets; ///< Per-candidate, per-function
+  emp::Random& random;
+
+  // --- INTERNAL ---
+  emp::vector<double> score_table;                  ///< Row-major (per-candidate) scores for a given selection event
+  utils::NonDominatedSorter sorter;
+  emp::vector<size_t> all_candidate_ids;
+  emp::vector<size_t> all_fun_ids;
+
+public:
+
+  NSGA2Select(
+    emp::vector< emp::vector<score_fun_t> >& a_score_fun_sets,
+    emp::Random& a_random
+  ) :
+    score_fun_sets(a_score_fun_sets),
+    random(a_random)
+  { ; }
+
+  emp::vector<size_t>& operator()(size_t n) override;
+
+  emp::vector<size_t>& operator()(
+    size_t n,
+    const emp::vector<size_t>& candidate_ids,
+    const emp::vector<size_t>& fun_ids
+  );
+
+  /// Fronts / crowding distances from the most recent selection event (indices into candidate_ids)
+  const utils::NonDominatedSorter& GetSorter() const { return sorter; }
+
+};
+
+emp::vector<size_t>& NSGA2Select::operator()(size_t n) {
+  emp_assert(score_fun_sets.size() > 0);
+  const size_t num_candidates = score_fun_sets.size();
+  const size_t num_funs = score_fun_sets.back().size();
+  if (all_candidate_ids.size() != num_candidates) {
+    all_candidate_ids.resize(num_candidates, 0);
+    std::iota(
+      all_candidate_ids.begin(),
+      all_candidate_ids.end(),
+      0
+    );
+  }
+  if (all_fun_ids.size() != num_funs) {
+    all_fun_ids.resize(num_funs, 0);
+    std::iota(
+      all_fun_ids.begin(),
+      all_fun_ids.end(),
+      0
+    );
+  }
+  return (*this)(n, all_candidate_ids, all_fun_ids);
+}
+
+emp::vector<size_t>& NSGA2Select::operator()(
+  size_t n,
+  const emp::vector<size_t>& candidate_ids,
+  const emp::vector<size_t>& fun_ids
+) {
+  const size_t num_candidates = candidate_ids.size();
+  const size_t fun_cnt = fun_ids.size();
+  emp_assert(num_candidates > 0);
+  emp_assert(num_candidates <= score_fun_sets.size());
+  emp_assert(fun_cnt > 0);
+
+  selected.resize(n, 0);
+
+  // Update the score table
+  score_table.resize(num_candidates * fun_cnt);
+  for (size_t cand_i = 0; cand_i < num_candidates; ++cand_i) {
+    const size_t cand_id = candidate_ids[cand_i];
+    auto& score_funs = score_fun_sets[cand_id];
+    double* row = score_table.data() + (cand_i * fun_cnt);
+    for (size_t fun_i = 0; fun_i < fun_cnt; ++fun_i) {
+      emp_assert(fun_ids[fun_i] < score_funs.size());
+      row[fun_i] = score_funs[fun_ids[fun_i]]();
+    }
+  }
+
+  // Sort candidates into fronts, compute crowding distances
+  sorter.Sort(score_table, num_candidates, fun_cnt);
+  sorter.ComputeCrowding(score_table);
+  const auto& ranks = sorter.GetRanks();
+  const auto& crowding = sorter.GetCrowding();
+
+  // Binary crowded tournaments
+  for (size_t sel_i = 0; sel_i < n; ++sel_i) {
+    const size_t a = random.GetUInt(num_candidates);
+    const size_t b = random.GetUInt(num_candidates);
+    size_t winner = a;
+    if (ranks[b] < ranks[a]) {
+      winner = b;
+    } else if (ranks[b] == ranks[a]) {
+      if (crowding[b] > crowding[a]) {
+        winner = b;
+      } else if (crowding[b] == crowding[a] && random.P(0.5)) {
+        winner = b;
+      }
+    }
+    selected[sel_i] = candidate_ids[winner];
+  }
+  return selected;
+}
+
+}
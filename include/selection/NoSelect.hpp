@@ -0,0 +1,55 @@
+#pragma once
+
+#include "emp/base/vector.hpp"
+
+#include "BaseSelect.hpp"
+
+namespace selection {
+
+/// No selection: each candidate is selected in order (wrapping around if n is
+/// larger than the number of candidates), i.e., every candidate reproduces.
+struct NoSelect : public BaseSelect {
+protected:
+  size_t num_candidates;                    ///< Number of candidates when none are given explicitly (e.g., population size)
+
+public:
+  NoSelect(
+    size_t a_num_candidates
+  ) :
+    num_candidates(a_num_candidates)
+  { ; }
+
+  emp::vector<size_t>& operator()(size_t n) override;
+  emp::vector<size_t>& operator()(
+    size_t n,
+    const emp::vector<size_t>& candidate_ids
+  );
+
+  size_t GetNumCandidates() const { return num_candidates; }
+  void SetNumCandidates(size_t num) { num_candidates = num; }
+
+};
+
+emp::vector<size_t>& NoSelect::operator()(size_t n) {
+  emp_assert(num_candidates > 0);
+  selected.resize(n, 0);
+  for (size_t i = 0; i < n; ++i) {
+    selected[i] = i % num_candidates;
+  }
+  return selected;
+}
+
+emp::vector<size_t>& NoSelect::operator()(
+  size_t n,
+  const emp::vector<size_t>& candidate_ids
+) {
+  emp_assert(candidate_ids.size() > 0);
+  const size_t num_ids = candidate_ids.size();
+  selected.resize(n, 0);
+  for (size_t i = 0; i < n; ++i) {
+    selected[i] = candidate_ids[i % num_ids];
+  }
+  return selected;
+}
+
+}
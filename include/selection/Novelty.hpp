@@ -0,0 +1,172 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+
+#include "emp/base/vector.hpp"
+#include "emp/math/Random.hpp"
+
+#include "../utility/HammingVPTree.hpp"
+
+namespace selection {
+
+/// Tracks the novelty of bit phenotypes (e.g., test pass vectors): the mean Hamming distance
+/// from each population member to its k nearest neighbours among the rest of the population
+/// and a bounded archive of past phenotypes.
+/// Identical phenotypes are collapsed into a single weighted point before building the
+/// nearest-neighbour index (populations are often dominated by a few phenotypes).
+class NoveltyArchive {
+protected:
+  emp::Random& random;
+  size_t k;                                 ///< Number of nearest neighbours used to compute novelty
+  size_t archive_capacity;                  ///< Maximum number of phenotypes stored in the archive
+  double add_rate;                          ///< Per-member probability of being added to the archive each update
+
+  size_t num_words = 0;                     ///< 64-bit words per phenotype
+  emp::vector<uint64_t> archive_rows;       ///< Archived phenotypes (row-major)
+  size_t archive_size = 0;
+
+  emp::vector<double> novelty;              ///< Per-population-member novelty (from most recent update)
+
+  // --- INTERNAL ---
+  emp::vector<uint64_t> all_rows;           ///< Population + archive rows
+  emp::vector<size_t> row_order;            ///< all_rows ids, sorted to find identical phenotypes
+  emp::vector<uint64_t> points;             ///< Unique phenotypes (row-major)
+  emp::vector<size_t> point_weights;        ///< Number of copies of each unique phenotype
+  emp::vector<size_t> pop_point_ids;        ///< Per-population-member unique phenotype id
+  emp::vector<double> point_novelty;        ///< Per-unique-phenotype novelty (cached; -1 = not computed)
+  utils::HammingVPTree tree;
+
+  const uint64_t* AllRow(size_t id) const { return all_rows.data() + (id * num_words); }
+
+public:
+  NoveltyArchive(
+    emp::Random& a_random,
+    size_t a_k=15,
+    size_t a_archive_capacity=1000,
+    double a_add_rate=0.01
+  ) :
+    random(a_random),
+    k(a_k),
+    archive_capacity(a_archive_capacity),
+    add_rate(a_add_rate)
+  { ; }
+
+  /// Recompute novelty for the population, then (probabilistically) add population members to the archive.
+  /// pop_rows holds pop_size packed phenotypes (row-major, a_num_words 64-bit words each).
+  void Update(const emp::vector<uint64_t>& pop_rows, size_t pop_size, size_t a_num_words);
+
+  const emp::vector<double>& GetNovelty() const { return novelty; }
+  double GetNovelty(size_t pop_id) const {
+    emp_assert(pop_id < novelty.size());
+    return novelty[pop_id];
+  }
+
+  size_t GetArchiveSize() const { return archive_size; }
+  size_t GetK() const { return k; }
+
+  /// Limit nearest-neighbour search to max_checks distance computations per organism (approximate novelty).
+  void SetMaxChecks(size_t max_checks) { tree.SetMaxChecks(max_checks); }
+
+  /// Heap bytes held by the archive, per-update buffers, and search tree
+  size_t GetNumBytes() const {
+    return utils::VectorBytes(archive_rows) + utils::VectorBytes(novelty)
+      + utils::VectorBytes(all_rows) + utils::VectorBytes(row_order) + utils::VectorBytes(points)
+      + utils::VectorBytes(point_weights) + utils::VectorBytes(pop_point_ids) + utils::VectorBytes(point_novelty)
+      + tree.GetNumBytes();
+  }
+
+};
+
+void NoveltyArchive::Update(
+  const emp::vector<uint64_t>& pop_rows,
+  size_t pop_size,
+  size_t a_num_words
+) {
+  emp_assert(pop_rows.size() >= pop_size * a_num_words);
+  // Phenotype width changed? Archive is no longer comparable.
+  if (a_num_words != num_words) {
+    num_words = a_num_words;
+    archive_size = 0;
+  }
+  archive_rows.resize(archive_capacity * num_words);
+
+  // Gather population and archive phenotypes
+  const size_t num_rows = pop_size + archive_size;
+  all_rows.resize(num_rows * num_words);
+  std::copy(
+    pop_rows.begin(),
+    pop_rows.begin() + (pop_size * num_words),
+    all_rows.begin()
+  );
+  std::copy(
+    archive_rows.begin(),
+    archive_rows.begin() + (archive_size * num_words),
+    all_rows.begin() + (pop_size * num_words)
+  );
+
+  // Collapse identical phenotypes into weighted points
+  row_order.resize(num_rows);
+  std::iota(row_order.begin(), row_order.end(), 0);
+  std::sort(
+    row_order.begin(),
+    row_order.end(),
+    [this](size_t a, size_t b) {
+      return std::lexicographical_compare(
+        AllRow(a), AllRow(a) + num_words,
+        AllRow(b), AllRow(b) + num_words
+      );
+    }
+  );
+  points.clear();
+  point_weights.clear();
+  pop_point_ids.resize(pop_size);
+  for (size_t i = 0; i < num_rows; ++i) {
+    const size_t row_id = row_order[i];
+    const bool is_new = (i == 0) || !std::equal(
+      AllRow(row_id), AllRow(row_id) + num_words,
+      AllRow(row_order[i-1])
+    );
+    if (is_new) {
+      points.insert(points.end(), AllRow(row_id), AllRow(row_id) + num_words);
+      point_weights.emplace_back(0);
+    }
+    ++point_weights.back();
+    if (row_id < pop_size) pop_point_ids[row_id] = point_weights.size() - 1;
+  }
+
+  // Compute novelty (once per unique phenotype)
+  const size_t num_points = point_weights.size();
+  tree.Build(points.data(), num_points, num_words, random, point_weights.data());
+  point_novelty.resize(num_points);
+  std::fill(point_novelty.begin(), point_novelty.end(), -1.0);
+  novelty.resize(pop_size);
+  for (size_t pop_id = 0; pop_id < pop_size; ++pop_id) {
+    const size_t point_id = pop_point_ids[pop_id];
+    if (point_novelty[point_id] < 0.0) {
+      point_novelty[point_id] = tree.KNearestMeanDistance(
+        points.data() + (point_id * num_words),
+        k,
+        point_id
+      );
+    }
+    novelty[pop_id] = point_novelty[point_id];
+  }
+
+  // Update archive (random replacement once full)
+  if (archive_capacity == 0) return;
+  for (size_t pop_id = 0; pop_id < pop_size; ++pop_id) {
+    if (!random.P(add_rate)) continue;
+    const size_t slot = (archive_size < archive_capacity) ?
+      archive_size++ :
+      random.GetUInt(archive_capacity);
+    std::copy(
+      pop_rows.begin() + (pop_id * num_words),
+      pop_rows.begin() + ((pop_id + 1) * num_words),
+      archive_rows.begin() + (slot * num_words)
+    );
+  }
+}
+
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "emp/base/vector.hpp"
+#include "emp/math/Random.hpp"
+
+#include "BaseSelect.hpp"
+
+namespace selection {
+
+/// Random selection: each of the n slots is filled by a uniform draw (with
+/// replacement) from the candidates.
+struct RandomSelect : public BaseSelect {
+protected:
+  emp::Random& random;
+  size_t num_candidates;                    ///< Number of candidates when none are given explicitly (e.g., population size)
+
+public:
+  RandomSelect(
+    emp::Random& a_random,
+    size_t a_num_candidates
+  ) :
+    random(a_random),
+    num_candidates(a_num_candidates)
+  { ; }
+
+  emp::vector<size_t>& operator()(size_t n) override;
+  emp::vector<size_t>& operator()(
+    size_t n,
+    const emp::vector<size_t>& candidate_ids
+  );
+
+  size_t GetNumCandidates() const { return num_candidates; }
+  void SetNumCandidates(size_t num) { num_candidates = num; }
+
+};
+
+emp::vector<size_t>& RandomSelect::operator()(size_t n) {
+  emp_assert(num_candidates > 0);
+  selected.resize(n, 0);
+  for (size_t i = 0; i < n; ++i) {
+    selected[i] = random.GetUInt(num_candidates);
+  }
+  return selected;
+}
+
+emp::vector<size_t>& RandomSelect::operator()(
+  size_t n,
+  const emp::vector<size_t>& candidate_ids
+) {
+  emp_assert(candidate_ids.size() > 0);
+  const size_t num_ids = candidate_ids.size();
+  selected.resize(n, 0);
+  for (size_t i = 0; i < n; ++i) {
+    selected[i] = candidate_ids[random.GetUInt(num_ids)];
+  }
+  return selected;
+}
+
+}
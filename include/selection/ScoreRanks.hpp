@@ -0,0 +1,268 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "emp/base/vector.hpp"
+
+#include "../utility/memory.hpp"
+
+namespace selection {
+
+namespace internal {
+
+/// Find all members of pool tied for the max rank (preserving pool order), appending them to next_pool.
+/// gathered is scratch space used to lay out the pool's ranks contiguously.
+template<typename RANK_T>
+void FilterMaxRank(
+  const emp::vector<RANK_T>& ranks,
+  const emp::vector<size_t>& pool,
+  emp::vector<size_t>& next_pool,
+  emp::vector<RANK_T>& gathered
+) {
+  static_assert(std::is_same<RANK_T, uint8_t>::value || std::is_same<RANK_T, uint16_t>::value);
+  emp_assert(pool.size() > 0);
+  const size_t pool_size = pool.size();
+  // Gather pool ranks into contiguous memory
+  gathered.resize(pool_size);
+  for (size_t i = 0; i < pool_size; ++i) {
+    gathered[i] = ranks[pool[i]];
+  }
+  next_pool.resize(pool_size);
+  size_t num_kept = 0;
+  size_t i = 0;
+  RANK_T max_rank = 0;
+#if defined(__SSE2__)
+  if constexpr (std::is_same<RANK_T, uint8_t>::value) {
+    // (1) Find max rank, 16 candidates at a time
+    const size_t num_blocks = pool_size / 16;
+    __m128i max_v = _mm_setzero_si128();
+    for (size_t block = 0; block < num_blocks; ++block) {
+      const __m128i v = _mm_loadu_si128((const __m128i*)(gathered.data() + (block * 16)));
+      max_v = _mm_max_epu8(max_v, v);
+    }
+    alignas(16) uint8_t lanes[16];
+    _mm_store_si128((__m128i*)lanes, max_v);
+    max_rank = *std::max_element(lanes, lanes + 16);
+    for (i = num_blocks * 16; i < pool_size; ++i) {
+      max_rank = std::max(max_rank, gathered[i]);
+    }
+    // (2) Compress: keep candidates whose rank equals the max
+    const __m128i target = _mm_set1_epi8((char)max_rank);
+    for (size_t block = 0; block < num_blocks; ++block) {
+      const size_t base = block * 16;
+      const __m128i v = _mm_loadu_si128((const __m128i*)(gathered.data() + base));
+      uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, target));
+      while (mask) {
+        const size_t lane = (size_t)__builtin_ctz(mask);
+        next_pool[num_kept++] = pool[base + lane];
+        mask &= mask - 1;
+      }
+    }
+    for (i = num_blocks * 16; i < pool_size; ++i) {
+      if (gathered[i] == max_rank) next_pool[num_kept++] = pool[i];
+    }
+    next_pool.resize(num_kept);
+    return;
+  } else {
+    // (1) Find max rank, 8 candidates at a time
+    //     (SSE2 only has a signed 16-bit max, so flip the sign bit on the way in and out)
+    const size_t num_blocks = pool_size / 8;
+    const __m128i sign = _mm_set1_epi16((short)0x8000);
+    __m128i max_v = _mm_set1_epi16(std::numeric_limits<short>::min());
+    for (size_t block = 0; block < num_blocks; ++block) {
+      const __m128i v = _mm_loadu_si128((const __m128i*)(gathered.data() + (block * 8)));
+      max_v = _mm_max_epi16(max_v, _mm_xor_si128(v, sign));
+    }
+    alignas(16) uint16_t lanes[8];
+    _mm_store_si128((__m128i*)lanes, _mm_xor_si128(max_v, sign));
+    max_rank = *std::max_element(lanes, lanes + 8);
+    for (i = num_blocks * 8; i < pool_size; ++i) {
+      max_rank = std::max(max_rank, gathered[i]);
+    }
+    // (2) Compress: keep candidates whose rank equals the max
+    //     (pack 16-bit comparison results down to bytes so each candidate gets one mask bit)
+    const __m128i target = _mm_set1_epi16((short)max_rank);
+    const __m128i zero = _mm_setzero_si128();
+    for (size_t block = 0; block < num_blocks; ++block) {
+      const size_t base = block * 8;
+      const __m128i v = _mm_loadu_si128((const __m128i*)(gathered.data() + base));
+      const __m128i eq = _mm_packs_epi16(_mm_cmpeq_epi16(v, target), zero);
+      uint32_t mask = (uint32_t)_mm_movemask_epi8(eq);
+      while (mask) {
+        const size_t lane = (size_t)__builtin_ctz(mask);
+        next_pool[num_kept++] = pool[base + lane];
+        mask &= mask - 1;
+      }
+    }
+    for (i = num_blocks * 8; i < pool_size; ++i) {
+      if (gathered[i] == max_rank) next_pool[num_kept++] = pool[i];
+    }
+    next_pool.resize(num_kept);
+    return;
+  }
+#endif
+  // Scalar version (written to be auto-vectorizable)
+  max_rank = *std::max_element(gathered.begin(), gathered.end());
+  for (i = 0; i < pool_size; ++i) {
+    next_pool[num_kept] = pool[i];
+    num_kept += (size_t)(gathered[i] == max_rank);
+  }
+  next_pool.resize(num_kept);
+}
+
+} // End internal namespace
+
+/// Dense, per-criterion rank compression of a lexicase score table.
+/// Each criterion's column of scores is mapped onto small integers such that
+/// rank(a) > rank(b) iff a > b and rank(a) == rank(b) iff a == b. Filtering on
+/// ranks therefore keeps exactly the candidates that filtering on raw scores would.
+/// Each criterion uses the narrowest rank type that fits its number of distinct values
+/// (uint8_t or uint16_t). Criteria with more distinct values than a uint16_t can represent
+/// are left uncompressed; callers must fall back to raw scores for those criteria.
+class ScoreRankTable {
+public:
+  static constexpr size_t MAX_DISTINCT_8 = (size_t)std::numeric_limits<uint8_t>::max() + 1;
+  static constexpr size_t MAX_DISTINCT_16 = (size_t)std::numeric_limits<uint16_t>::max() + 1;
+
+protected:
+  emp::vector<uint8_t> rank_widths;                ///< Per-criterion, bytes per rank (0 = uncompressed)
+  emp::vector< emp::vector<uint8_t> > ranks_8;     ///< Per-criterion, per-candidate rank (1-byte criteria)
+  emp::vector< emp::vector<uint16_t> > ranks_16;   ///< Per-criterion, per-candidate rank (2-byte criteria)
+  emp::vector<double> distinct_scores;             ///< Scratch space used to find distinct scores in a column
+  emp::vector<uint64_t> distinct_slots;            ///< Scratch hash set used to bail out of columns with too many distinct scores
+  emp::vector<uint8_t> gathered_8;                 ///< Used internally to lay out pool ranks contiguously
+  emp::vector<uint16_t> gathered_16;
+
+  /// Does scores have more than max_distinct distinct values? Stops as soon as the answer is known.
+  bool ExceedsDistinct(const emp::vector<double>& scores, size_t max_distinct) {
+    if (scores.size() <= max_distinct) return false;
+    // Hash set of score bit patterns (0 marks an empty slot, so +0.0 is tracked separately)
+    size_t num_slots = 1;
+    while (num_slots < 2 * (max_distinct + 1)) num_slots <<= 1;
+    const size_t slot_mask = num_slots - 1;
+    distinct_slots.assign(num_slots, 0);
+    size_t num_distinct = 0;
+    bool seen_zero = false;
+    for (double score : scores) {
+      uint64_t bits = 0;
+      if (score == 0.0) score = 0.0; // -0.0 == 0.0
+      std::memcpy(&bits, &score, sizeof(bits));
+      if (bits == 0) {
+        if (seen_zero) continue;
+        seen_zero = true;
+      } else {
+        size_t slot = (size_t)((bits * 0x9E3779B97F4A7C15ULL) >> 32) & slot_mask;
+        while (distinct_slots[slot] != 0 && distinct_slots[slot] != bits) slot = (slot + 1) & slot_mask;
+        if (distinct_slots[slot] == bits) continue;
+        distinct_slots[slot] = bits;
+      }
+      if (++num_distinct > max_distinct) return true;
+    }
+    return false;
+  }
+
+  template<typename RANK_T>
+  void AssignRanks(const emp::vector<double>& scores, emp::vector<RANK_T>& ranks) const {
+    ranks.resize(scores.size());
+    for (size_t cand_i = 0; cand_i < scores.size(); ++cand_i) {
+      const auto it = std::lower_bound(
+        distinct_scores.begin(),
+        distinct_scores.end(),
+        scores[cand_i]
+      );
+      emp_assert(it != distinct_scores.end() && *it == scores[cand_i]);
+      ranks[cand_i] = (RANK_T)(it - distinct_scores.begin());
+    }
+  }
+
+public:
+
+  /// Compute ranks for each criterion (row) in score_table (score_table[criterion][candidate]).
+  void Build(const emp::vector< emp::vector<double> >& score_table) {
+    const size_t num_criteria = score_table.size();
+    rank_widths.resize(num_criteria);
+    ranks_8.resize(num_criteria);
+    ranks_16.resize(num_criteria);
+    for (size_t crit_i = 0; crit_i < num_criteria; ++crit_i) {
+      const auto& scores = score_table[crit_i];
+      // Too many distinct values to fit in the widest rank type? Fall back to raw scores.
+      if (ExceedsDistinct(scores, MAX_DISTINCT_16)) {
+        rank_widths[crit_i] = 0;
+        continue;
+      }
+      // Find distinct score values for this criterion
+      distinct_scores.resize(scores.size());
+      std::copy(scores.begin(), scores.end(), distinct_scores.begin());
+      std::sort(distinct_scores.begin(), distinct_scores.end());
+      distinct_scores.erase(
+        std::unique(distinct_scores.begin(), distinct_scores.end()),
+        distinct_scores.end()
+      );
+      emp_assert(distinct_scores.size() <= MAX_DISTINCT_16);
+      if (distinct_scores.size() <= MAX_DISTINCT_8) {
+        rank_widths[crit_i] = 1;
+        AssignRanks(scores, ranks_8[crit_i]);
+      } else {
+        rank_widths[crit_i] = 2;
+        AssignRanks(scores, ranks_16[crit_i]);
+      }
+    }
+  }
+
+  size_t GetNumCriteria() const { return rank_widths.size(); }
+
+  /// Heap bytes held by rank table and scratch space
+  size_t GetNumBytes() const {
+    return utils::VectorBytes(rank_widths)
+      + utils::NestedVectorBytes(ranks_8)
+      + utils::NestedVectorBytes(ranks_16)
+      + utils::VectorBytes(distinct_scores)
+      + utils::VectorBytes(distinct_slots)
+      + utils::VectorBytes(gathered_8)
+      + utils::VectorBytes(gathered_16);
+  }
+
+  bool IsCompressed(size_t criterion) const {
+    emp_assert(criterion < rank_widths.size());
+    return rank_widths[criterion] != 0;
+  }
+
+  /// Bytes per rank used for criterion (0 if uncompressed).
+  size_t GetRankWidth(size_t criterion) const {
+    emp_assert(criterion < rank_widths.size());
+    return rank_widths[criterion];
+  }
+
+  /// Ranks for criterion (RANK_T must match the criterion's rank width).
+  template<typename RANK_T>
+  const emp::vector<RANK_T>& GetRanks(size_t criterion) const {
+    emp_assert(GetRankWidth(criterion) == sizeof(RANK_T));
+    if constexpr (std::is_same<RANK_T, uint8_t>::value) {
+      return ranks_8[criterion];
+    } else {
+      static_assert(std::is_same<RANK_T, uint16_t>::value, "Ranks are uint8_t or uint16_t.");
+      return ranks_16[criterion];
+    }
+  }
+
+  /// Find all members of pool tied for the max score on criterion (preserving pool order), storing them in next_pool.
+  void FilterMaxRank(size_t criterion, const emp::vector<size_t>& pool, emp::vector<size_t>& next_pool) {
+    emp_assert(IsCompressed(criterion));
+    if (rank_widths[criterion] == 1) {
+      internal::FilterMaxRank(ranks_8[criterion], pool, next_pool, gathered_8);
+    } else {
+      internal::FilterMaxRank(ranks_16[criterion], pool, next_pool, gathered_16);
+    }
+  }
+
+};
+
+} // End selection namespace
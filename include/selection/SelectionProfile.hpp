@@ -0,0 +1,86 @@
+#pragma once
+
+#include <algorithm>
+
+#include "emp/base/vector.hpp"
+
+namespace selection {
+
+/// Fixed-size histograms describing lexicase selection events (one event per shuffled criteria
+/// ordering). Filled in by lexicase selectors when attached (see SetProfile); reset by the owner
+/// (e.g., once per generation).
+struct SelectionProfile {
+  static constexpr size_t NUM_DEPTH_BINS = 64;  ///< Depths >= NUM_DEPTH_BINS - 1 share the last bin
+
+  size_t num_events = 0;                  ///< Number of selection events
+  emp::vector<size_t> depth_hist;         ///< Number of events that used (bin + 1) criteria
+  emp::vector<size_t> pool_size_sum;      ///< Sum (over events) of pool size after filtering on the (bin + 1)th criterion
+  emp::vector<size_t> pool_size_count;    ///< Number of events that filtered on the (bin + 1)th criterion
+  size_t random_tie_events = 0;           ///< Number of events that ended with more than one candidate (winner chosen at random)
+  size_t random_tie_pool_sum = 0;         ///< Sum of final pool sizes over events that ended in a random tie
+  size_t age_decided_events = 0;          ///< Number of events where an age criterion was the last to shrink the pool
+  emp::vector<size_t> age_decided_depth_hist; ///< Depth of the deciding age criterion
+
+  SelectionProfile() :
+    depth_hist(NUM_DEPTH_BINS, 0),
+    pool_size_sum(NUM_DEPTH_BINS, 0),
+    pool_size_count(NUM_DEPTH_BINS, 0),
+    age_decided_depth_hist(NUM_DEPTH_BINS, 0)
+  { ; }
+
+  static size_t Bin(size_t depth) { return std::min(depth, NUM_DEPTH_BINS - 1); }
+
+  void Reset() {
+    num_events = 0;
+    random_tie_events = 0;
+    random_tie_pool_sum = 0;
+    age_decided_events = 0;
+    std::fill(depth_hist.begin(), depth_hist.end(), 0);
+    std::fill(pool_size_sum.begin(), pool_size_sum.end(), 0);
+    std::fill(pool_size_count.begin(), pool_size_count.end(), 0);
+    std::fill(age_decided_depth_hist.begin(), age_decided_depth_hist.end(), 0);
+  }
+
+  /// Record pool size after filtering on the criterion at depth (0 = first criterion).
+  void RecordStep(size_t depth, size_t pool_size) {
+    const size_t bin = Bin(depth);
+    pool_size_sum[bin] += pool_size;
+    ++pool_size_count[bin];
+  }
+
+  /// Record the end of a selection event that used num_criteria criteria.
+  void RecordEvent(size_t num_criteria, size_t final_pool_size) {
+    emp_assert(num_criteria > 0);
+    ++num_events;
+    ++depth_hist[Bin(num_criteria - 1)];
+    if (final_pool_size > 1) {
+      ++random_tie_events;
+      random_tie_pool_sum += final_pool_size;
+    }
+  }
+
+  /// Record that an age criterion at depth was the last to shrink an event's pool.
+  void RecordAgeDecision(size_t depth) {
+    ++age_decided_events;
+    ++age_decided_depth_hist[Bin(depth)];
+  }
+
+  double GetMeanDepth() const {
+    if (num_events == 0) return 0.0;
+    size_t total = 0;
+    for (size_t bin = 0; bin < NUM_DEPTH_BINS; ++bin) total += (bin + 1) * depth_hist[bin];
+    return (double)total / (double)num_events;
+  }
+
+  /// Mean pool size after each filtering step (0 for depths no event reached).
+  emp::vector<double> GetMeanPoolSizes() const {
+    emp::vector<double> means(NUM_DEPTH_BINS, 0.0);
+    for (size_t bin = 0; bin < NUM_DEPTH_BINS; ++bin) {
+      if (pool_size_count[bin]) means[bin] = (double)pool_size_sum[bin] / (double)pool_size_count[bin];
+    }
+    return means;
+  }
+
+};
+
+}
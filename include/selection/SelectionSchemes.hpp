@@ -2,7 +2,10 @@
 
 // #include "Elite.hpp"
 #include "Lexicase.hpp"
-// #include "NoSelect.hpp"
-// #include "Random.hpp"
+#include "NSGA2.hpp"
+#include "NoSelect.hpp"
+#include "Novelty.hpp"
+#include "Random.hpp"
 #include "Tournament.hpp"
-#include "AgeLexicase.hpp"
\ No newline at end of file
+#include "Truncation.hpp"
+#include "AgeLexicase.hpp"
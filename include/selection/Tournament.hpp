@@ -2,6 +2,7 @@
 
 #include <functional>
 #include <algorithm>
+#include <numeric>
 
 #include "emp/base/vector.hpp"
 #include "emp/math/Random.hpp"
@@ -12,23 +13,26 @@
 namespace selection {
 
 struct TournamentSelect : public BaseSelect {
-public:
-  using score_fun_t = std::function<double(void)>;
 protected:
-  emp::vector<score_fun_t>& score_funs;     ///< One function for each selection candidate (e.g., each member of the population)
+  const emp::vector<double>& scores;        ///< One aggregate score for each selection candidate (e.g., each member of the population)
   emp::Random& random;
   size_t tournament_size;
 
   // --- INTERNAL ---
   emp::vector<size_t> all_candidate_ids;
+  emp::vector<size_t> candidate_idxs;       ///< Persistent permutation of candidate indices (used for partial Fisher-Yates)
+  emp::vector<size_t> entries;              ///< Indices (into candidate_ids) of current tournament's entrants
+
+  /// Fill entries with tournament_size distinct indices in [0, num_candidates).
+  void SampleEntries(size_t num_candidates);
 
 public:
   TournamentSelect(
-    emp::vector<score_fun_t>& a_score_funs,
+    const emp::vector<double>& a_scores,
     emp::Random& a_random,
     size_t a_tournament_size=4
   ) :
-    score_funs(a_score_funs),
+    scores(a_scores),
     random(a_random),
     tournament_size(a_tournament_size)
   { ; }
@@ -42,11 +46,18 @@ public:
   size_t GetTournamentSize() const { return tournament_size; }
   void SetTournamentSize(size_t t) { tournament_size = t; }
 
+  size_t GetNumBytes() const override {
+    return BaseSelect::GetNumBytes()
+      + utils::VectorBytes(all_candidate_ids)
+      + utils::VectorBytes(candidate_idxs)
+      + utils::VectorBytes(entries);
+  }
+
 };
 
 emp::vector<size_t>& TournamentSelect::operator()(size_t n) {
-  emp_assert(score_funs.size() > 0);
-  const size_t num_candidates = score_funs.size();
+  emp_assert(scores.size() > 0);
+  const size_t num_candidates = scores.size();
   if (all_candidate_ids.size() != num_candidates) {
     all_candidate_ids.resize(num_candidates, 0);
     std::iota(
@@ -58,38 +69,58 @@ emp::vector<size_t>& TournamentSelect::operator()(size_t n) {
   return (*this)(n, all_candidate_ids);
 }
 
+void TournamentSelect::SampleEntries(size_t num_candidates) {
+  entries.resize(tournament_size);
+  // Small tournaments relative to the candidate pool: rejection sampling
+  // (expected draws stay close to tournament_size, no O(N) work).
+  if (tournament_size * tournament_size <= num_candidates) {
+    for (size_t i = 0; i < tournament_size; ++i) {
+      size_t idx = random.GetUInt(num_candidates);
+      while (std::find(entries.begin(), entries.begin() + i, idx) != entries.begin() + i) {
+        idx = random.GetUInt(num_candidates);
+      }
+      entries[i] = idx;
+    }
+    return;
+  }
+  // Otherwise, partial Fisher-Yates over a persistent permutation. Any permutation
+  // is a valid starting point, so candidate_idxs is never reset between tournaments.
+  if (candidate_idxs.size() != num_candidates) {
+    candidate_idxs.resize(num_candidates);
+    std::iota(
+      candidate_idxs.begin(),
+      candidate_idxs.end(),
+      0
+    );
+  }
+  for (size_t i = 0; i < tournament_size; ++i) {
+    const size_t j = i + random.GetUInt(num_candidates - i);
+    std::swap(candidate_idxs[i], candidate_idxs[j]);
+    entries[i] = candidate_idxs[i];
+  }
+}
+
 emp::vector<size_t>& TournamentSelect::operator()(
   size_t n,
   const emp::vector<size_t>& candidate_ids
 ) {
   emp_assert(tournament_size > 0, "Tournament size must be greater than 0.", tournament_size);
-  emp_assert(tournament_size <= score_funs.size());
+  emp_assert(tournament_size <= scores.size());
   emp_assert(tournament_size <= candidate_ids.size());
-  emp_assert(candidate_ids.size() <= score_funs.size());
+  emp_assert(candidate_ids.size() <= scores.size());
 
   const size_t num_candidates = candidate_ids.size();
   selected.resize(n, 0);
 
-  emp::vector<size_t> entries(tournament_size, 0);
-  emp::vector<size_t> candidate_idxs(num_candidates, 0);
-  std::iota(
-    candidate_idxs.begin(),
-    candidate_idxs.end(),
-    0
-  );
-
   for (size_t t = 0; t < n; ++t) {
     // Form a tournament
-    emp::Shuffle(random, candidate_idxs);
-    for (size_t i = 0; i < entries.size(); ++i) {
-      entries[i] = candidate_ids[candidate_idxs[i]];
-    }
+    SampleEntries(num_candidates);
     // pick a winner
-    size_t winner_id = entries[0];
-    double winner_fit = score_funs[entries[0]]();
-    for (size_t i = 1; i < entries.size(); ++i) {
-      const size_t entry_id = entries[i];
-      const double entry_fit = score_funs[entry_id]();
+    size_t winner_id = candidate_ids[entries[0]];
+    double winner_fit = scores[winner_id];
+    for (size_t i = 1; i < tournament_size; ++i) {
+      const size_t entry_id = candidate_ids[entries[i]];
+      const double entry_fit = scores[entry_id];
       if (entry_fit > winner_fit) {
         winner_id = entry_id;
         winner_fit = entry_fit;
@@ -101,4 +132,4 @@ emp::vector<size_t>& TournamentSelect::operator()(
   return selected;
 }
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <functional>
+#include <algorithm>
+#include <numeric>
+
+#include "emp/base/vector.hpp"
+#include "emp/math/Random.hpp"
+#include "emp/math/random_utils.hpp"
+
+#include "BaseSelect.hpp"
+
+namespace selection {
+
+/// Truncation selection: the truncation_size highest-scoring candidates are
+/// selected round-robin to fill all n slots. Finds the top candidates with
+/// std::nth_element (linear time) rather than a full sort.
+struct TruncationSelect : public BaseSelect {
+protected:
+  const emp::vector<double>& scores;        ///< One aggregate score for each selection candidate (e.g., each member of the population)
+  emp::Random& random;
+  size_t truncation_size;
+
+  // --- INTERNAL ---
+  emp::vector<size_t> all_candidate_ids;
+  emp::vector<size_t> ranked;               ///< Candidate ids, partitioned so top candidates come first
+
+public:
+  TruncationSelect(
+    const emp::vector<double>& a_scores,
+    emp::Random& a_random,
+    size_t a_truncation_size=8
+  ) :
+    scores(a_scores),
+    random(a_random),
+    truncation_size(a_truncation_size)
+  { ; }
+
+  emp::vector<size_t>& operator()(size_t n) override;
+  emp::vector<size_t>& operator()(
+    size_t n,
+    const emp::vector<size_t>& candidate_ids
+  );
+
+  size_t GetTruncationSize() const { return truncation_size; }
+  void SetTruncationSize(size_t t) { truncation_size = t; }
+
+  size_t GetNumBytes() const override {
+    return BaseSelect::GetNumBytes()
+      + utils::VectorBytes(all_candidate_ids)
+      + utils::VectorBytes(ranked);
+  }
+
+};
+
+emp::vector<size_t>& TruncationSelect::operator()(size_t n) {
+  emp_assert(scores.size() > 0);
+  const size_t num_candidates = scores.size();
+  if (all_candidate_ids.size() != num_candidates) {
+    all_candidate_ids.resize(num_candidates, 0);
+    std::iota(
+      all_candidate_ids.begin(),
+      all_candidate_ids.end(),
+      0
+    );
+  }
+  return (*this)(n, all_candidate_ids);
+}
+
+emp::vector<size_t>& TruncationSelect::operator()(
+  size_t n,
+  const emp::vector<size_t>& candidate_ids
+) {
+  emp_assert(truncation_size > 0, "Truncation size must be greater than 0.", truncation_size);
+  emp_assert(candidate_ids.size() > 0);
+  emp_assert(candidate_ids.size() <= scores.size());
+
+  const size_t num_candidates = candidate_ids.size();
+  const size_t num_kept = std::min(truncation_size, num_candidates);
+  selected.resize(n, 0);
+
+  ranked.resize(num_candidates);
+  std::copy(
+    candidate_ids.begin(),
+    candidate_ids.end(),
+    ranked.begin()
+  );
+  // Shuffle so that ties at the cutoff are broken randomly
+  emp::Shuffle(random, ranked);
+  std::nth_element(
+    ranked.begin(),
+    ranked.begin() + (num_kept - 1),
+    ranked.end(),
+    [this](size_t a, size_t b) { return scores[a] > scores[b]; }
+  );
+
+  for (size_t i = 0; i < n; ++i) {
+    selected[i] = ranked[i % num_kept];
+  }
+  return selected;
+}
+
+}
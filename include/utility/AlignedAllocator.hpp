@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+
+namespace utils {
+
+/// Minimal allocator that aligns allocations to ALIGN bytes (e.g., a cache line).
+template<typename T, size_t ALIGN=64>
+struct AlignedAllocator {
+  using value_type = T;
+  static_assert(ALIGN >= alignof(T), "Alignment must be at least the type's natural alignment.");
+
+  template<typename U>
+  struct rebind { using other = AlignedAllocator<U, ALIGN>; };
+
+  AlignedAllocator() = default;
+  template<typename U>
+  AlignedAllocator(const AlignedAllocator<U, ALIGN>&) { ; }
+
+  T* allocate(size_t n) {
+    return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(ALIGN)));
+  }
+
+  void deallocate(T* ptr, size_t) {
+    ::operator delete(ptr, std::align_val_t(ALIGN));
+  }
+
+  template<typename U>
+  bool operator==(const AlignedAllocator<U, ALIGN>&) const { return true; }
+  template<typename U>
+  bool operator!=(const AlignedAllocator<U, ALIGN>&) const { return false; }
+};
+
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace utils {
+
+/// Process-wide heap allocation counters.
+/// Counting only happens in builds compiled with PSYNTH_TRACK_ALLOCATIONS (which replaces
+/// global operator new/delete); otherwise counters stay at zero.
+struct AllocationCounts {
+  size_t allocations = 0;  ///< Number of calls to operator new
+  size_t bytes = 0;        ///< Bytes requested from operator new
+
+  AllocationCounts operator-(const AllocationCounts& other) const {
+    return {allocations - other.allocations, bytes - other.bytes};
+  }
+};
+
+namespace internal {
+
+inline std::atomic<size_t>& AllocationCounter() {
+  static std::atomic<size_t> count{0};
+  return count;
+}
+
+inline std::atomic<size_t>& AllocationByteCounter() {
+  static std::atomic<size_t> bytes{0};
+  return bytes;
+}
+
+inline void CountAllocation(size_t size) {
+  AllocationCounter().fetch_add(1, std::memory_order_relaxed);
+  AllocationByteCounter().fetch_add(size, std::memory_order_relaxed);
+}
+
+}
+
+/// Is allocation tracking compiled in?
+constexpr bool TrackingAllocations() {
+  #ifdef PSYNTH_TRACK_ALLOCATIONS
+  return true;
+  #else
+  return false;
+  #endif
+}
+
+/// Allocations so far (take the difference of two snapshots to count allocations in between).
+inline AllocationCounts GetAllocationCounts() {
+  return {
+    internal::AllocationCounter().load(std::memory_order_relaxed),
+    internal::AllocationByteCounter().load(std::memory_order_relaxed)
+  };
+}
+
+/// Counts allocations between successive laps.
+class AllocationStopwatch {
+protected:
+  AllocationCounts mark;
+public:
+  AllocationStopwatch() : mark(GetAllocationCounts()) { ; }
+
+  /// Allocations since the previous lap (or construction).
+  AllocationCounts Lap() {
+    const AllocationCounts now = GetAllocationCounts();
+    const AllocationCounts lap = now - mark;
+    mark = now;
+    return lap;
+  }
+};
+
+}
+
+#ifdef PSYNTH_TRACK_ALLOCATIONS
+// Replacement global allocation functions (diagnostic builds only).
+// NOTE: replacements must be defined exactly once per program, so this header must only be
+//       included (with PSYNTH_TRACK_ALLOCATIONS) from a single translation unit.
+
+namespace utils {
+namespace internal {
+
+inline void* TrackedAlloc(size_t size) {
+  CountAllocation(size);
+  if (void* ptr = std::malloc(size ? size : 1)) return ptr;
+  throw std::bad_alloc();
+}
+
+inline void* TrackedAlignedAlloc(size_t size, std::align_val_t align) {
+  CountAllocation(size);
+  const size_t alignment = static_cast<size_t>(align);
+  // aligned_alloc requires size to be a multiple of alignment
+  const size_t padded = ((size ? size : 1) + alignment - 1) / alignment * alignment;
+  if (void* ptr = std::aligned_alloc(alignment, padded)) return ptr;
+  throw std::bad_alloc();
+}
+
+}
+}
+
+void* operator new(size_t size) { return utils::internal::TrackedAlloc(size); }
+void* operator new[](size_t size) { return utils::internal::TrackedAlloc(size); }
+void* operator new(size_t size, std::align_val_t align) { return utils::internal::TrackedAlignedAlloc(size, align); }
+void* operator new[](size_t size, std::align_val_t align) { return utils::internal::TrackedAlignedAlloc(size, align); }
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, size_t, std::align_val_t) noexcept { std::free(ptr); }
+
+#endif
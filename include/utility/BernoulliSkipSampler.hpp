@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+
+#include "emp/math/Random.hpp"
+
+namespace utils {
+
+/// Samples successes of a long run of independent Bernoulli(p) trials by drawing the (geometric)
+/// gap to each next success, so work scales with the number of successes rather than trials.
+/// Trials can be visited in consecutive segments (e.g., one per function); the position of the
+/// next success carries over from one segment to the next.
+class BernoulliSkipSampler {
+protected:
+  static constexpr size_t NEVER = std::numeric_limits<size_t>::max();
+
+  double prob = 0.0;
+  double log_fail = 0.0;   ///< log(1 - prob)
+  size_t next = NEVER;     ///< Index (relative to current segment start) of next success
+
+  /// Number of failures before the next success.
+  size_t SampleGap(emp::Random& rnd) const {
+    if (prob >= 1.0) return 0;
+    if (prob <= 0.0) return NEVER;
+    // P(gap >= k) = (1-p)^k = P(u <= (1-p)^k) for u uniform in (0, 1]
+    const double u = 1.0 - rnd.GetDouble();
+    const double gap = std::floor(std::log(u) / log_fail);
+    return (gap < (double)NEVER) ? (size_t)gap : NEVER;
+  }
+
+  void Advance(emp::Random& rnd) {
+    const size_t gap = SampleGap(rnd);
+    next = (gap >= NEVER - next - 1) ? NEVER : next + gap + 1;
+  }
+
+public:
+  BernoulliSkipSampler(emp::Random& rnd, double p) :
+    prob(p),
+    log_fail((p > 0.0 && p < 1.0) ? std::log1p(-p) : 0.0)
+  {
+    next = SampleGap(rnd);
+  }
+
+  /// Visit the next num_trials trials, calling fun(i) (i in [0, num_trials), ascending) for each success.
+  /// Returns the number of successes.
+  template<typename FUN_T>
+  size_t Sample(emp::Random& rnd, size_t num_trials, FUN_T&& fun) {
+    size_t cnt = 0;
+    while (next < num_trials) {
+      fun(next);
+      ++cnt;
+      Advance(rnd);
+    }
+    if (next != NEVER) next -= num_trials;
+    return cnt;
+  }
+};
+
+}
@@ -2,9 +2,12 @@
 
 #include <utility>
 #include <algorithm>
+#include <cstdint>
+#include <functional>
 
 #include "emp/base/vector.hpp"
 #include "emp/math/Random.hpp"
+#include "emp/math/random_utils.hpp"
 
 namespace utils {
 
@@ -62,6 +65,13 @@ protected:
 
   std::function<void(void)> assign_groupings;
 
+  // -- Informed down-sampling --
+  size_t profile_width = 0;                          ///< Number of bits in each member's profile
+  size_t profile_num_words = 0;                      ///< Number of 64-bit words used to store each member's profile
+  emp::vector<uint64_t> member_profiles;             ///< Per-member (row-major), packed bit profile (e.g., which sampled orgs pass a test)
+  emp::vector<size_t> min_dists;                     ///< Used internally by farthest-first: per-member distance to the current sample
+  emp::vector<bool> in_sample;                       ///< Used internally by farthest-first: is member already in sample?
+
   bool dirty_groups = true;
 
 public:
@@ -198,6 +208,101 @@ public:
     };
   }
 
+  /// @brief Configure profile storage for informed down-sampling. Clears all member profiles.
+  void ResetMemberProfiles(size_t width) {
+    profile_width = width;
+    profile_num_words = (width + 63) / 64;
+    member_profiles.resize(profile_num_words * member_group_assignments.size());
+    std::fill(member_profiles.begin(), member_profiles.end(), 0);
+  }
+
+  void SetMemberProfileBit(size_t member_id, size_t bit, bool value) {
+    emp_assert(member_id < member_group_assignments.size());
+    emp_assert(bit < profile_width);
+    uint64_t& word = member_profiles[(member_id * profile_num_words) + (bit / 64)];
+    const uint64_t mask = (uint64_t)1 << (bit % 64);
+    word = (value) ? (word | mask) : (word & ~mask);
+  }
+
+  size_t GetProfileWidth() const { return profile_width; }
+
+  /// @brief Hamming distance between two members' profiles.
+  size_t GetProfileDistance(size_t member_a, size_t member_b) const {
+    const uint64_t* a = member_profiles.data() + (member_a * profile_num_words);
+    const uint64_t* b = member_profiles.data() + (member_b * profile_num_words);
+    size_t dist = 0;
+    for (size_t w = 0; w < profile_num_words; ++w) {
+      dist += (size_t)__builtin_popcountll(a[w] ^ b[w]);
+    }
+    return dist;
+  }
+
+  /// @brief Configure InformedDownSample mode.
+  //  Each update, a single group of sample_size members is chosen using farthest-first
+  //  traversal over member profiles (see ResetMemberProfiles/SetMemberProfileBit).
+  //  Falls back to a uniformly random down-sample until profiles have been provided.
+  void SetInformedDownSampleMode(size_t sample_size) {
+    emp_assert(sample_size > 0);
+    emp_assert(sample_size <= possible_ids.size());
+    // Initialize single group to hold down-sample
+    groupings.resize(1);
+    auto& group = groupings.back();
+    group.SetGroupID(0);
+    group.Resize(sample_size, 0);
+    // Configure assign_groupings
+    assign_groupings = [this, sample_size]() {
+      emp_assert(groupings.size() == 1);
+      auto& group = groupings.back();
+      emp_assert(group.member_ids.size() == sample_size);
+      // Every member starts out of the down-sample
+      std::fill(
+        member_group_assignments.begin(),
+        member_group_assignments.end(),
+        1
+      );
+      // No profiles yet? Use a random down-sample.
+      if (profile_width == 0) {
+        emp::Shuffle(random, possible_ids);
+        for (size_t i = 0; i < sample_size; ++i) {
+          group.member_ids[i] = possible_ids[i];
+          member_group_assignments[possible_ids[i]] = 0;
+        }
+        return;
+      }
+      // Farthest-first traversal: start with a random member, then repeatedly add the
+      // member farthest from everything already in the sample (ties broken randomly).
+      in_sample.resize(member_group_assignments.size());
+      std::fill(in_sample.begin(), in_sample.end(), false);
+      min_dists.resize(member_group_assignments.size());
+      size_t next_id = possible_ids[random.GetUInt(possible_ids.size())];
+      for (size_t i = 0; i < sample_size; ++i) {
+        group.member_ids[i] = next_id;
+        member_group_assignments[next_id] = 0;
+        in_sample[next_id] = true;
+        // Update distances to sample, find next farthest member
+        const size_t added_id = next_id;
+        size_t max_dist = 0;
+        size_t num_ties = 0;
+        for (size_t member_id : possible_ids) {
+          if (in_sample[member_id]) continue;
+          const size_t dist = GetProfileDistance(member_id, added_id);
+          if (i == 0 || dist < min_dists[member_id]) {
+            min_dists[member_id] = dist;
+          }
+          if (num_ties == 0 || min_dists[member_id] > max_dist) {
+            max_dist = min_dists[member_id];
+            next_id = member_id;
+            num_ties = 1;
+          } else if (min_dists[member_id] == max_dist) {
+            // Reservoir sample among tied members
+            ++num_ties;
+            if (random.GetUInt(num_ties) == 0) next_id = member_id;
+          }
+        }
+      }
+    };
+  }
+
   void UpdateGroupings() {
     assign_groupings();
   }
@@ -0,0 +1,205 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+#include "emp/base/vector.hpp"
+#include "emp/math/Random.hpp"
+
+#include "memory.hpp"
+
+namespace utils {
+
+/// Hamming distance between two packed bit rows.
+inline size_t hamming_distance(const uint64_t* a, const uint64_t* b, size_t num_words) {
+  size_t dist = 0;
+  for (size_t w = 0; w < num_words; ++w) {
+    dist += (size_t)__builtin_popcountll(a[w] ^ b[w]);
+  }
+  return dist;
+}
+
+/// Vantage-point tree over packed bit rows (Hamming distance), supporting exact k-nearest-neighbour queries.
+/// The tree is stored implicitly: the node covering [lo, hi) has its vantage point at ids[lo], its
+/// inside child (distance <= thresholds[lo]) covers [lo+1, mid), and its outside child (distance >=
+/// thresholds[lo]) covers [mid, hi). Points may carry integer weights (e.g., the number of identical
+/// phenotypes a point stands for); a point of weight w counts as w neighbours.
+/// The tree does not own the point data; rows must stay valid (and unchanged) between Build and queries.
+class HammingVPTree {
+public:
+  static constexpr size_t LEAF_SIZE = 8;  ///< Ranges this small are scanned linearly
+
+protected:
+  const uint64_t* rows = nullptr;         ///< Row-major packed points (num_words per point)
+  const size_t* weights = nullptr;        ///< Optional per-point weights (nullptr = all 1)
+  size_t num_points = 0;
+  size_t num_words = 0;
+
+  emp::vector<size_t> ids;                ///< Point ids, arranged into implicit tree order
+  emp::vector<size_t> thresholds;         ///< Per-node (indexed by node's lo) inside/outside distance threshold
+  emp::vector<size_t> mid_points;         ///< Per-node (indexed by node's lo) start of outside child range
+  emp::vector< std::pair<size_t, size_t> > build_scratch; ///< (distance, id) pairs used during Build
+  emp::vector< std::pair<size_t, size_t> > heap;          ///< Max-heap of (distance, id) for current query
+  size_t heap_weight = 0;                                 ///< Total weight of points in heap
+  size_t num_checks = 0;                                  ///< Distance computations made by current query
+  size_t max_checks = (size_t)-1;                         ///< Query stops descending once this many distances have been computed
+
+  const uint64_t* Row(size_t id) const { return rows + (id * num_words); }
+
+  size_t Weight(size_t id, size_t exclude_id) const {
+    // Excluded point (e.g., the query itself) counts for one less
+    return ((weights == nullptr) ? 1 : weights[id]) - (size_t)(id == exclude_id);
+  }
+
+  void BuildRange(size_t lo, size_t hi, emp::Random& random) {
+    if (hi - lo <= LEAF_SIZE) return;
+    // Choose a random vantage point, move it to the front of the range
+    std::swap(build_scratch[lo], build_scratch[lo + random.GetUInt(hi - lo)]);
+    const size_t vp = build_scratch[lo].second;
+    for (size_t i = lo + 1; i < hi; ++i) {
+      build_scratch[i].first = hamming_distance(Row(vp), Row(build_scratch[i].second), num_words);
+    }
+    // Split remaining points at the median distance. Points tied with the threshold may land
+    // on either side, which keeps the tree balanced even when many points share a distance.
+    const size_t mid = lo + 1 + ((hi - lo - 1) / 2);
+    std::nth_element(
+      build_scratch.begin() + lo + 1,
+      build_scratch.begin() + mid,
+      build_scratch.begin() + hi
+    );
+    thresholds[lo] = build_scratch[mid].first;
+    mid_points[lo] = mid;
+    BuildRange(lo + 1, mid, random);
+    BuildRange(mid, hi, random);
+  }
+
+  void Consider(size_t id, size_t dist, size_t k, size_t exclude_id) {
+    const size_t weight = Weight(id, exclude_id);
+    if (weight == 0) return;
+    if (heap_weight >= k && dist >= heap.front().first) return;
+    heap.emplace_back(dist, id);
+    std::push_heap(heap.begin(), heap.end());
+    heap_weight += weight;
+    // Drop farthest points that are no longer needed to make up k neighbours
+    while (heap_weight - Weight(heap.front().second, exclude_id) >= k) {
+      heap_weight -= Weight(heap.front().second, exclude_id);
+      std::pop_heap(heap.begin(), heap.end());
+      heap.pop_back();
+    }
+  }
+
+  size_t Tau(size_t k) const {
+    return (heap_weight < k) ? std::numeric_limits<size_t>::max() : heap.front().first;
+  }
+
+  void SearchRange(size_t lo, size_t hi, const uint64_t* query, size_t k, size_t exclude_id) {
+    if (lo >= hi) return;
+    if (num_checks >= max_checks && heap_weight >= k) return;
+    if (hi - lo <= LEAF_SIZE) {
+      num_checks += hi - lo;
+      for (size_t i = lo; i < hi; ++i) {
+        Consider(ids[i], hamming_distance(query, Row(ids[i]), num_words), k, exclude_id);
+      }
+      return;
+    }
+    const size_t vp = ids[lo];
+    const size_t d = hamming_distance(query, Row(vp), num_words);
+    ++num_checks;
+    Consider(vp, d, k, exclude_id);
+    const size_t mu = thresholds[lo];
+    const size_t mid = mid_points[lo];
+    // By the triangle inequality, the far side can only hold a closer point if its lower bound is < tau.
+    if (d <= mu) {
+      SearchRange(lo + 1, mid, query, k, exclude_id);
+      if ((mu - d) < Tau(k)) SearchRange(mid, hi, query, k, exclude_id);
+    } else {
+      SearchRange(mid, hi, query, k, exclude_id);
+      if ((d - mu) < Tau(k)) SearchRange(lo + 1, mid, query, k, exclude_id);
+    }
+  }
+
+public:
+
+  /// Build tree over a_num_points packed rows (row-major, a_num_words 64-bit words per row).
+  /// a_weights (optional) must hold a_num_points weights and stay valid between Build and queries.
+  void Build(
+    const uint64_t* a_rows,
+    size_t a_num_points,
+    size_t a_num_words,
+    emp::Random& random,
+    const size_t* a_weights=nullptr
+  ) {
+    rows = a_rows;
+    weights = a_weights;
+    num_points = a_num_points;
+    num_words = a_num_words;
+    build_scratch.resize(num_points);
+    for (size_t i = 0; i < num_points; ++i) {
+      build_scratch[i] = {0, i};
+    }
+    thresholds.resize(num_points);
+    mid_points.resize(num_points);
+    BuildRange(0, num_points, random);
+    ids.resize(num_points);
+    for (size_t i = 0; i < num_points; ++i) {
+      ids[i] = build_scratch[i].second;
+    }
+  }
+
+  size_t GetSize() const { return num_points; }
+
+  /// Limit the number of distance computations per query (approximate search). Once the limit is
+  /// reached, the query returns the best neighbours found so far (always at least k, if available).
+  void SetMaxChecks(size_t checks) { max_checks = checks; }
+
+  /// Heap bytes held by the tree and its scratch space
+  size_t GetNumBytes() const {
+    return utils::VectorBytes(ids) + utils::VectorBytes(thresholds) + utils::VectorBytes(mid_points)
+      + utils::VectorBytes(build_scratch) + utils::VectorBytes(heap);
+  }
+  size_t GetMaxChecks() const { return max_checks; }
+
+  /// Number of distance computations made by the most recent query
+  size_t GetNumChecks() const { return num_checks; }
+
+  /// Find (up to) the k nearest neighbours of query (counting point weights), ignoring one copy
+  /// of exclude_id (e.g., the query's own point).
+  /// Results are (distance, id) pairs in no particular order; the farthest result may carry more
+  /// weight than needed to make up k. Valid until the next query.
+  const emp::vector< std::pair<size_t, size_t> >& KNearest(
+    const uint64_t* query,
+    size_t k,
+    size_t exclude_id=(size_t)-1
+  ) {
+    heap.clear();
+    heap_weight = 0;
+    num_checks = 0;
+    if (k == 0) return heap;
+    SearchRange(0, num_points, query, k, exclude_id);
+    return heap;
+  }
+
+  /// Mean distance from query to its k nearest neighbours (counting point weights), ignoring one
+  /// copy of exclude_id. If there are fewer than k neighbours, averages over all of them.
+  double KNearestMeanDistance(
+    const uint64_t* query,
+    size_t k,
+    size_t exclude_id=(size_t)-1
+  ) {
+    KNearest(query, k, exclude_id);
+    if (heap.empty()) return 0.0;
+    const size_t needed = std::min(heap_weight, k);
+    // Only part of the farthest point's weight may be needed
+    const size_t top_used = Weight(heap.front().second, exclude_id) - (heap_weight - needed);
+    double total = (double)(heap.front().first * top_used);
+    for (size_t i = 1; i < heap.size(); ++i) {
+      total += (double)(heap[i].first * Weight(heap[i].second, exclude_id));
+    }
+    return total / (double)needed;
+  }
+
+};
+
+}
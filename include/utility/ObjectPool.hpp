@@ -0,0 +1,98 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+
+#include "emp/base/vector.hpp"
+
+namespace utils {
+
+/// Fixed-size slot allocator for objects of type T.
+/// Slots live in a small number of chunks; freed slots go onto a free list and are
+/// handed back out (LIFO) by the next allocation. Construction/destruction is left to the caller.
+template<typename T>
+class ObjectPool {
+protected:
+  union Slot {
+    Slot* next;                                         ///< Next free slot (when free)
+    alignas(T) unsigned char storage[sizeof(T)];        ///< Object storage (when allocated)
+  };
+
+  struct Chunk {
+    std::unique_ptr<Slot[]> slots;
+    size_t size = 0;
+  };
+
+  emp::vector<Chunk> chunks;
+  Slot* free_list = nullptr;
+  size_t capacity = 0;   ///< Total slots across all chunks
+  size_t num_live = 0;   ///< Slots currently handed out
+
+  void AddChunk(size_t size) {
+    emp_assert(size > 0);
+    Chunk& chunk = chunks.emplace_back();
+    chunk.slots.reset(new Slot[size]);
+    chunk.size = size;
+    // Thread new slots onto the free list so that the lowest addresses are handed out first.
+    for (size_t i = size; i-- > 0; ) {
+      chunk.slots[i].next = free_list;
+      free_list = &(chunk.slots[i]);
+    }
+    capacity += size;
+  }
+
+public:
+  ObjectPool() = default;
+  ObjectPool(const ObjectPool&) = delete;
+  ObjectPool& operator=(const ObjectPool&) = delete;
+
+  ~ObjectPool() {
+    // Outstanding objects must be returned before the pool goes away.
+    emp_assert(num_live == 0, num_live);
+  }
+
+  size_t GetCapacity() const { return capacity; }
+  size_t GetNumLive() const { return num_live; }
+  size_t GetNumFree() const { return capacity - num_live; }
+  size_t GetNumChunks() const { return chunks.size(); }
+
+  /// Make sure at least n slots exist (allocating one chunk for the difference).
+  void Reserve(size_t n) {
+    if (n > capacity) AddChunk(n - capacity);
+  }
+
+  /// Raw storage for one T. Grows the pool (doubling) when exhausted.
+  void* Allocate() {
+    if (free_list == nullptr) AddChunk(std::max<size_t>(capacity, 16));
+    Slot* slot = free_list;
+    free_list = slot->next;
+    ++num_live;
+    return static_cast<void*>(slot->storage);
+  }
+
+  /// Return storage previously handed out by Allocate.
+  void Deallocate(void* ptr) {
+    emp_assert(Owns(ptr));
+    emp_assert(num_live > 0);
+    Slot* slot = reinterpret_cast<Slot*>(ptr);
+    slot->next = free_list;
+    free_list = slot;
+    --num_live;
+  }
+
+  /// Was ptr handed out by this pool?
+  bool Owns(const void* ptr) const {
+    std::less<const void*> less;
+    for (const Chunk& chunk : chunks) {
+      const void* begin = static_cast<const void*>(chunk.slots.get());
+      const void* end = static_cast<const void*>(chunk.slots.get() + chunk.size);
+      if (!less(ptr, begin) && less(ptr, end)) return true;
+    }
+    return false;
+  }
+};
+
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+#include "emp/base/vector.hpp"
+
+namespace utils {
+
+/// Converts test scores (doubles) to/from a storage type.
+/// Encoding is monotone, so equal scores stay equal (and ordered scores stay ordered or tie).
+/// Lossy codecs may turn distinct scores into ties (changing selection outcomes); caveat describes how
+/// (empty for lossless codecs), and IsExact reports whether a particular score survives encoding.
+template<typename SCORE_T>
+struct ScoreCodec {
+  static constexpr const char* name = "double";
+  static constexpr const char* caveat = "";
+  static SCORE_T Encode(double score) { return (SCORE_T)score; }
+  static double Decode(SCORE_T score) { return (double)score; }
+  static bool IsExact(double score) { return Decode(Encode(score)) == score; }
+};
+
+template<>
+struct ScoreCodec<float> {
+  static constexpr const char* name = "float";
+  static constexpr const char* caveat = "scores are rounded to single precision; scores that differ only beyond float precision tie";
+  static float Encode(double score) { return (float)score; }
+  static double Decode(float score) { return (double)score; }
+  static bool IsExact(double score) { return Decode(Encode(score)) == score; }
+};
+
+/// Fixed-point scores in [0, 1] (1/65535 resolution). Out-of-range scores are clamped.
+template<>
+struct ScoreCodec<uint16_t> {
+  static constexpr const char* name = "fixed16";
+  static constexpr const char* caveat = "scores outside [0, 1] are clamped; scores closer than 1/65535 may tie";
+  static constexpr double SCALE = 65535.0;
+  static uint16_t Encode(double score) {
+    if (!(score > 0.0)) return 0;
+    if (score >= 1.0) return (uint16_t)SCALE;
+    return (uint16_t)std::lround(score * SCALE);
+  }
+  static double Decode(uint16_t score) { return (double)score / SCALE; }
+  static bool IsExact(double score) { return Decode(Encode(score)) == score; }
+};
+
+/// Decode a vector of stored scores (e.g., for output).
+template<typename SCORE_T>
+emp::vector<double> DecodeScores(const emp::vector<SCORE_T>& scores) {
+  emp::vector<double> decoded(scores.size());
+  for (size_t i = 0; i < scores.size(); ++i) {
+    decoded[i] = ScoreCodec<SCORE_T>::Decode(scores[i]);
+  }
+  return decoded;
+}
+
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+
+#include "emp/base/vector.hpp"
+
+namespace utils {
+
+/// Fixed set of persistent worker threads for running one task on every thread at once
+/// (e.g., one block of a generation's work per thread). Workers sleep between tasks, so
+/// running a task neither creates threads nor allocates. The calling thread takes part as
+/// thread 0; workers are threads 1 through GetNumThreads() - 1.
+class ThreadPool {
+protected:
+  emp::vector<std::thread> workers;
+  std::mutex lock;
+  std::condition_variable start_cv;  ///< Workers wait here for the next task
+  std::condition_variable done_cv;   ///< Run waits here for workers to finish the current task
+  size_t task_id = 0;                ///< Incremented for each task (workers run each task id once)
+  size_t num_busy = 0;               ///< Workers still running the current task
+  bool stopping = false;
+
+  // Current task (type-erased reference to Run's argument; no allocation)
+  void* task = nullptr;
+  void (*invoke_task)(void*, size_t) = nullptr;
+
+  void WorkerLoop(size_t thread_id, size_t last_task_id) {
+    while (true) {
+      std::unique_lock<std::mutex> guard(lock);
+      start_cv.wait(guard, [this, last_task_id]() { return stopping || task_id != last_task_id; });
+      if (stopping) return;
+      last_task_id = task_id;
+      void* cur_task = task;
+      auto cur_invoke = invoke_task;
+      guard.unlock();
+      cur_invoke(cur_task, thread_id);
+      guard.lock();
+      if (--num_busy == 0) done_cv.notify_one();
+    }
+  }
+
+public:
+  ThreadPool() = default;
+  explicit ThreadPool(size_t num_threads) { Start(num_threads); }
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+  ~ThreadPool() { Stop(); }
+
+  /// (Re)start pool with num_threads total threads (including the calling thread).
+  void Start(size_t num_threads) {
+    Stop();
+    stopping = false;
+    // New workers wait for the next task (not the last one run)
+    const size_t cur_task_id = task_id;
+    for (size_t thread_id = 1; thread_id < num_threads; ++thread_id) {
+      workers.emplace_back([this, thread_id, cur_task_id]() { WorkerLoop(thread_id, cur_task_id); });
+    }
+  }
+
+  /// Join all worker threads.
+  void Stop() {
+    {
+      std::lock_guard<std::mutex> guard(lock);
+      stopping = true;
+    }
+    start_cv.notify_all();
+    for (std::thread& worker : workers) worker.join();
+    workers.clear();
+  }
+
+  /// Total number of threads that run each task (workers + calling thread).
+  size_t GetNumThreads() const { return workers.size() + 1; }
+
+  /// Run fun(thread_id) once on each thread (thread 0 is the calling thread); returns once all are done.
+  template<typename FUN_T>
+  void Run(FUN_T& fun) {
+    if (workers.size()) {
+      std::lock_guard<std::mutex> guard(lock);
+      task = (void*)&fun;
+      invoke_task = [](void* f, size_t thread_id) { (*(FUN_T*)f)(thread_id); };
+      num_busy = workers.size();
+      ++task_id;
+    }
+    start_cv.notify_all();
+    fun((size_t)0);
+    std::unique_lock<std::mutex> guard(lock);
+    done_cv.wait(guard, [this]() { return num_busy == 0; });
+  }
+
+};
+
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <fstream>
+#include <type_traits>
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+namespace utils {
+
+/// Heap bytes held by a vector's buffer (based on capacity, not size).
+template<typename VEC_T>
+size_t VectorBytes(const VEC_T& vec) {
+  using value_t = typename VEC_T::value_type;
+  if constexpr (std::is_same<value_t, bool>::value) {
+    return (vec.capacity() + 7) / 8;
+  } else {
+    return vec.capacity() * sizeof(value_t);
+  }
+}
+
+/// Heap bytes held by a vector of vectors (outer buffer + each inner buffer).
+template<typename VEC_T>
+size_t NestedVectorBytes(const VEC_T& vec) {
+  size_t bytes = VectorBytes(vec);
+  for (const auto& inner : vec) bytes += VectorBytes(inner);
+  return bytes;
+}
+
+/// Current resident set size of this process in bytes (0 if unavailable).
+inline size_t GetCurrentRSS() {
+  std::ifstream statm("/proc/self/statm");
+  size_t total_pages = 0;
+  size_t resident_pages = 0;
+  if (!(statm >> total_pages >> resident_pages)) return 0;
+  return resident_pages * (size_t)sysconf(_SC_PAGESIZE);
+}
+
+/// Peak resident set size of this process in bytes (0 if unavailable).
+inline size_t GetPeakRSS() {
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+  return (size_t)usage.ru_maxrss * 1024; // Linux reports kilobytes
+}
+
+}
@@ -2,6 +2,9 @@
 
 #include <algorithm>
 #include <numeric>
+#include <cstdint>
+#include <limits>
+#include <utility>
 #include "emp/base/vector.hpp"
 #include "emp/bits/BitVector.hpp"
 
@@ -72,4 +75,206 @@ namespace utils {
   }
 
 
+  /// Does packed bit row a dominate packed bit row b? (a has every bit set that b has, plus at least one more)
+  inline bool dominates_packed(const uint64_t* a, const uint64_t* b, size_t num_words) {
+    bool equal = true;
+    for (size_t w = 0; w < num_words; ++w) {
+      if (b[w] & ~a[w]) return false;
+      equal = equal && (a[w] == b[w]);
+    }
+    return !equal;
+  }
+
+  /// Sorts candidates into non-dominated fronts (larger scores are better), using
+  /// efficient non-dominated sort (ENS-SS):
+  ///  (1) candidates are ordered by descending score sum (ties broken lexicographically), so
+  ///      no candidate can be dominated by one that comes after it;
+  ///  (2) each candidate, in order, joins the first front with no member that dominates it.
+  /// Tables where every score is 0 or 1 are packed into 64-bit words and compared a word at a time.
+  /// Internal buffers are reused across calls.
+  class NonDominatedSorter {
+  protected:
+    size_t num_candidates = 0;
+    size_t num_objectives = 0;
+    bool binary = false;                            ///< Were all scores 0 or 1 in the last sorted table?
+    size_t num_words = 0;                           ///< Number of 64-bit words per packed row
+    emp::vector<uint64_t> bit_rows;                 ///< Packed (row-major) rows, only used for binary tables
+    emp::vector<double> row_sums;                   ///< Per-candidate score sum
+    emp::vector<size_t> order;                      ///< Candidates in processing order
+    emp::vector< emp::vector<size_t> > fronts;      ///< Fronts (only first num_fronts are valid; inner vectors reused)
+    size_t num_fronts = 0;
+    emp::vector<size_t> ranks;                      ///< Per-candidate front index (0 = non-dominated)
+    emp::vector<double> crowding;                   ///< Per-candidate crowding distance (within its front)
+    emp::vector< std::pair<double, size_t> > front_scratch; ///< Used internally for crowding distance
+
+    bool RowDominates(const emp::vector<double>& table, size_t a, size_t b) const {
+      if (binary) {
+        return dominates_packed(
+          bit_rows.data() + (a * num_words),
+          bit_rows.data() + (b * num_words),
+          num_words
+        );
+      }
+      const double* a_row = table.data() + (a * num_objectives);
+      const double* b_row = table.data() + (b * num_objectives);
+      bool equal = true;
+      for (size_t i = 0; i < num_objectives; ++i) {
+        if (a_row[i] < b_row[i]) return false;
+        equal = equal && (a_row[i] == b_row[i]);
+      }
+      return !equal;
+    }
+
+  public:
+
+    /// Sort candidates into fronts. table is row-major: table[(candidate * num_objectives) + objective].
+    void Sort(const emp::vector<double>& table, size_t a_num_candidates, size_t a_num_objectives) {
+      emp_assert(table.size() >= a_num_candidates * a_num_objectives);
+      num_candidates = a_num_candidates;
+      num_objectives = a_num_objectives;
+      // Compute row sums, check whether we can pack scores into bits
+      binary = true;
+      row_sums.resize(num_candidates);
+      for (size_t cand = 0; cand < num_candidates; ++cand) {
+        const double* row = table.data() + (cand * num_objectives);
+        double sum = 0.0;
+        for (size_t i = 0; i < num_objectives; ++i) {
+          sum += row[i];
+          binary = binary && (row[i] == 0.0 || row[i] == 1.0);
+        }
+        row_sums[cand] = sum;
+      }
+      if (binary) {
+        num_words = (num_objectives + 63) / 64;
+        bit_rows.resize(num_words * num_candidates);
+        std::fill(bit_rows.begin(), bit_rows.end(), 0);
+        for (size_t cand = 0; cand < num_candidates; ++cand) {
+          const double* row = table.data() + (cand * num_objectives);
+          uint64_t* bits = bit_rows.data() + (cand * num_words);
+          for (size_t i = 0; i < num_objectives; ++i) {
+            bits[i / 64] |= (uint64_t)(row[i] == 1.0) << (i % 64);
+          }
+        }
+      }
+      // (1) Order candidates such that dominators always come first
+      order.resize(num_candidates);
+      std::iota(order.begin(), order.end(), 0);
+      std::sort(
+        order.begin(),
+        order.end(),
+        [this, &table](size_t a, size_t b) {
+          if (row_sums[a] != row_sums[b]) return row_sums[a] > row_sums[b];
+          // Equal sums: only need a tie-breaker for real-valued scores (floating point
+          // sums of a dominated/dominating pair may round to the same value).
+          if (!binary) {
+            const double* a_row = table.data() + (a * num_objectives);
+            const double* b_row = table.data() + (b * num_objectives);
+            for (size_t i = 0; i < num_objectives; ++i) {
+              if (a_row[i] != b_row[i]) return a_row[i] > b_row[i];
+            }
+          }
+          return a < b;
+        }
+      );
+      // (2) Assign each candidate to the first front that does not dominate it
+      ranks.resize(num_candidates);
+      num_fronts = 0;
+      for (size_t cand : order) {
+        size_t front_i = 0;
+        for (; front_i < num_fronts; ++front_i) {
+          const auto& front = fronts[front_i];
+          bool dominated = false;
+          // Most recently added members are most similar to cand; check them first
+          for (size_t member_i = front.size(); member_i-- > 0; ) {
+            if (RowDominates(table, front[member_i], cand)) {
+              dominated = true;
+              break;
+            }
+          }
+          if (!dominated) break;
+        }
+        if (front_i == num_fronts) {
+          if (fronts.size() == num_fronts) fronts.emplace_back();
+          fronts[num_fronts].clear();
+          ++num_fronts;
+        }
+        fronts[front_i].emplace_back(cand);
+        ranks[cand] = front_i;
+      }
+    }
+
+    /// Compute NSGA-II crowding distances within each front (call after Sort, with the same table).
+    void ComputeCrowding(const emp::vector<double>& table) {
+      crowding.resize(num_candidates);
+      std::fill(crowding.begin(), crowding.end(), 0.0);
+      const double inf = std::numeric_limits<double>::infinity();
+      for (size_t front_i = 0; front_i < num_fronts; ++front_i) {
+        const auto& front = fronts[front_i];
+        if (front.size() <= 2) {
+          for (size_t cand : front) crowding[cand] = inf;
+          continue;
+        }
+        if (binary) {
+          // Binary objectives: a stable sort would put all 0-scorers before all 1-scorers, so
+          // only the ends of the two runs and the candidates on either side of the 0/1
+          // boundary have non-zero contributions. Find them in one pass (no sort).
+          for (size_t obj = 0; obj < num_objectives; ++obj) {
+            const uint64_t mask = (uint64_t)1 << (obj % 64);
+            size_t first_zero = front.size(), last_zero = front.size();
+            size_t first_one = front.size(), last_one = front.size();
+            for (size_t i = 0; i < front.size(); ++i) {
+              const bool one = bit_rows[(front[i] * num_words) + (obj / 64)] & mask;
+              if (one) {
+                if (first_one == front.size()) first_one = i;
+                last_one = i;
+              } else {
+                if (first_zero == front.size()) first_zero = i;
+                last_zero = i;
+              }
+            }
+            const bool has_zero = first_zero != front.size();
+            const bool has_one = first_one != front.size();
+            crowding[front[has_zero ? first_zero : first_one]] = inf;
+            crowding[front[has_one ? last_one : last_zero]] = inf;
+            if (!(has_zero && has_one)) continue;
+            crowding[front[last_zero]] += 1.0;
+            crowding[front[first_one]] += 1.0;
+          }
+          continue;
+        }
+        front_scratch.resize(front.size());
+        for (size_t obj = 0; obj < num_objectives; ++obj) {
+          // Gather (score, candidate) pairs so the sort works on contiguous memory
+          for (size_t i = 0; i < front.size(); ++i) {
+            front_scratch[i] = {table[(front[i] * num_objectives) + obj], front[i]};
+          }
+          std::sort(front_scratch.begin(), front_scratch.end());
+          const double range = front_scratch.back().first - front_scratch.front().first;
+          crowding[front_scratch.front().second] = inf;
+          crowding[front_scratch.back().second] = inf;
+          if (range == 0.0) continue;
+          for (size_t i = 1; i + 1 < front_scratch.size(); ++i) {
+            crowding[front_scratch[i].second] += (front_scratch[i+1].first - front_scratch[i-1].first) / range;
+          }
+        }
+      }
+    }
+
+    size_t GetNumFronts() const { return num_fronts; }
+
+    const emp::vector<size_t>& GetFront(size_t front_i) const {
+      emp_assert(front_i < num_fronts);
+      return fronts[front_i];
+    }
+
+    /// Per-candidate front index (0 = non-dominated front)
+    const emp::vector<size_t>& GetRanks() const { return ranks; }
+
+    /// Per-candidate crowding distance (valid after ComputeCrowding)
+    const emp::vector<double>& GetCrowding() const { return crowding; }
+
+    bool IsBinary() const { return binary; }
+
+  };
+
 }
\ No newline at end of file
@@ -0,0 +1,55 @@
+#define CATCH_CONFIG_MAIN
+#define PSYNTH_TRACK_ALLOCATIONS
+
+#include "Catch2/single_include/catch2/catch.hpp"
+
+#include <functional>
+
+#include "emp/math/Random.hpp"
+#include "utility/AllocationTracker.hpp"
+#include "selection/Lexicase.hpp"
+
+TEST_CASE("AllocationTracker") {
+  REQUIRE(utils::TrackingAllocations());
+
+  utils::AllocationStopwatch stopwatch;
+  REQUIRE(stopwatch.Lap().allocations == 0);
+
+  emp::vector<int> values(100, 0);
+  values.reserve(200);
+  const utils::AllocationCounts counts = stopwatch.Lap();
+  REQUIRE(counts.allocations == 2);
+  REQUIRE(counts.bytes == 300 * sizeof(int));
+
+  // Filling reserved capacity does not allocate.
+  for (size_t i = 0; i < 100; ++i) values.emplace_back((int)i);
+  REQUIRE(stopwatch.Lap().allocations == 0);
+}
+
+TEST_CASE("LexicaseSelect steady state does not allocate") {
+  const int seed = 2;
+  const size_t pop_size = 50;
+  const size_t num_fit_funs = 10;
+  emp::Random score_rnd(seed);
+  emp::vector<
+    emp::vector<std::function<double(void)>>
+  > fit_funs(pop_size, {});
+  for (size_t pop_i = 0; pop_i < pop_size; ++pop_i) {
+    for (size_t fit_i = 0; fit_i < num_fit_funs; ++fit_i) {
+      const double score = (double)score_rnd.GetUInt(3);
+      fit_funs[pop_i].emplace_back(
+        [score](){ return score; }
+      );
+    }
+  }
+
+  emp::Random rnd(seed);
+  selection::LexicaseSelect selector(fit_funs, rnd);
+  // First generation sizes internal buffers.
+  selector(pop_size);
+  utils::AllocationStopwatch stopwatch;
+  for (size_t rep = 0; rep < 5; ++rep) {
+    selector(pop_size);
+  }
+  REQUIRE(stopwatch.Lap().allocations == 0);
+}
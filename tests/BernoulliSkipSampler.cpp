@@ -0,0 +1,57 @@
+#define CATCH_CONFIG_MAIN
+
+#include "Catch2/single_include/catch2/catch.hpp"
+
+#include <cmath>
+
+#include "emp/base/vector.hpp"
+#include "emp/math/Random.hpp"
+#include "utility/BernoulliSkipSampler.hpp"
+
+TEST_CASE("BernoulliSkipSampler edge rates") {
+  emp::Random rnd(1);
+
+  utils::BernoulliSkipSampler never(rnd, 0.0);
+  REQUIRE(never.Sample(rnd, 1000, [](size_t) { REQUIRE(false); }) == 0);
+
+  utils::BernoulliSkipSampler always(rnd, 1.0);
+  emp::vector<size_t> hits;
+  REQUIRE(always.Sample(rnd, 5, [&hits](size_t i) { hits.emplace_back(i); }) == 5);
+  REQUIRE(hits == emp::vector<size_t>{0, 1, 2, 3, 4});
+  // Next segment starts back at 0
+  hits.clear();
+  REQUIRE(always.Sample(rnd, 2, [&hits](size_t i) { hits.emplace_back(i); }) == 2);
+  REQUIRE(hits == emp::vector<size_t>{0, 1});
+  REQUIRE(always.Sample(rnd, 0, [](size_t) { REQUIRE(false); }) == 0);
+}
+
+TEST_CASE("BernoulliSkipSampler matches per-trial distribution") {
+  emp::Random rnd(2);
+  const double p = 0.01;
+  const size_t segment_size = 37;
+  const size_t num_segments = 5000;
+  const size_t num_trials = segment_size * num_segments;
+
+  // Successes are ascending, in range, and split across segments as if trials were contiguous.
+  utils::BernoulliSkipSampler sampler(rnd, p);
+  emp::vector<size_t> per_position(segment_size, 0);
+  size_t total = 0;
+  for (size_t seg = 0; seg < num_segments; ++seg) {
+    int prev = -1;
+    total += sampler.Sample(rnd, segment_size, [&](size_t i) {
+      REQUIRE(i < segment_size);
+      REQUIRE((int)i > prev);
+      prev = (int)i;
+      ++per_position[i];
+    });
+  }
+  // Binomial(num_trials, p): mean 1850, sd ~43
+  const double expected = p * (double)num_trials;
+  const double sd = std::sqrt(expected * (1.0 - p));
+  REQUIRE(std::abs((double)total - expected) < 5 * sd);
+  // No position within a segment is favored.
+  const double per_pos_expected = expected / (double)segment_size;
+  for (size_t count : per_position) {
+    REQUIRE(std::abs((double)count - per_pos_expected) < 5 * std::sqrt(per_pos_expected));
+  }
+}
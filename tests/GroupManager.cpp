@@ -0,0 +1,102 @@
+#define CATCH_CONFIG_MAIN
+
+#include "Catch2/single_include/catch2/catch.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <unordered_set>
+
+#include "emp/base/vector.hpp"
+#include "emp/math/Random.hpp"
+#include "utility/GroupManager.hpp"
+
+namespace {
+
+/// Check that the down-sample is sample_size distinct, valid ids and that member group assignments
+/// agree with it (0 = in down-sample, 1 = out).
+void CheckDownSample(const utils::GroupManager& manager, size_t num_ids, size_t sample_size) {
+  REQUIRE(manager.GetNumGroups() == 1);
+  const auto& sample = manager.GetGroup(0).GetMembers();
+  REQUIRE(sample.size() == sample_size);
+  std::unordered_set<size_t> sampled(sample.begin(), sample.end());
+  REQUIRE(sampled.size() == sample_size);
+  for (size_t id = 0; id < num_ids; ++id) {
+    REQUIRE(manager.GetMemberGroupID(id) == (sampled.count(id) ? 0 : 1));
+  }
+  for (size_t id : sample) {
+    REQUIRE(id < num_ids);
+  }
+}
+
+}
+
+TEST_CASE("GroupManager informed down-sampling") {
+  emp::Random random(2);
+  const size_t num_ids = 8;
+  emp::vector<size_t> ids(num_ids);
+  std::iota(ids.begin(), ids.end(), 0);
+
+  SECTION("Random down-sample before any profiles exist") {
+    utils::GroupManager manager(random);
+    manager.SetPossibleIDs(ids);
+    manager.SetInformedDownSampleMode(3);
+    REQUIRE(manager.GetProfileWidth() == 0);
+    emp::vector<size_t> times_sampled(num_ids, 0);
+    for (size_t update = 0; update < 200; ++update) {
+      manager.UpdateGroupings();
+      CheckDownSample(manager, num_ids, 3);
+      for (size_t id : manager.GetGroup(0).GetMembers()) ++times_sampled[id];
+    }
+    // Every id should make it into some random down-sample
+    for (size_t id = 0; id < num_ids; ++id) {
+      REQUIRE(times_sampled[id] > 0);
+    }
+  }
+
+  SECTION("Farthest-first traversal picks maximally distinct profiles first") {
+    // Two members share each of four profiles: 0x00, 0xFF, 0x0F, 0xF0.
+    // Complementary profiles are 8 apart; all others are 4 apart (or identical).
+    const emp::vector<uint8_t> profiles{0x00, 0xFF, 0x0F, 0xF0, 0x00, 0xFF, 0x0F, 0xF0};
+    utils::GroupManager manager(random);
+    manager.SetPossibleIDs(ids);
+    manager.ResetMemberProfiles(8);
+    for (size_t id = 0; id < num_ids; ++id) {
+      for (size_t bit = 0; bit < 8; ++bit) {
+        manager.SetMemberProfileBit(id, bit, (profiles[id] >> bit) & 1);
+      }
+    }
+    REQUIRE(manager.GetProfileDistance(0, 1) == 8);
+    REQUIRE(manager.GetProfileDistance(0, 2) == 4);
+    REQUIRE(manager.GetProfileDistance(0, 4) == 0);
+
+    // Sample of 2: second pick is always the complement of the (random) first pick.
+    manager.SetInformedDownSampleMode(2);
+    for (size_t update = 0; update < 50; ++update) {
+      manager.UpdateGroupings();
+      CheckDownSample(manager, num_ids, 2);
+      const auto& sample = manager.GetGroup(0).GetMembers();
+      REQUIRE(profiles[sample[1]] == (uint8_t)~profiles[sample[0]]);
+    }
+
+    // Sample of 4: one member of each distinct profile, complements added back-to-back.
+    manager.SetInformedDownSampleMode(4);
+    emp::vector<size_t> times_sampled(num_ids, 0);
+    for (size_t update = 0; update < 200; ++update) {
+      manager.UpdateGroupings();
+      CheckDownSample(manager, num_ids, 4);
+      const auto& sample = manager.GetGroup(0).GetMembers();
+      std::unordered_set<uint8_t> sampled_profiles;
+      for (size_t id : sample) sampled_profiles.insert(profiles[id]);
+      REQUIRE(sampled_profiles.size() == 4);
+      REQUIRE(profiles[sample[1]] == (uint8_t)~profiles[sample[0]]);
+      REQUIRE(profiles[sample[3]] == (uint8_t)~profiles[sample[2]]);
+      for (size_t id : sample) ++times_sampled[id];
+    }
+    // Ties (identical profiles, equally distant candidates) are broken randomly,
+    // so every member should be picked at some point.
+    for (size_t id = 0; id < num_ids; ++id) {
+      REQUIRE(times_sampled[id] > 0);
+    }
+  }
+}
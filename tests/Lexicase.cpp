@@ -0,0 +1,464 @@
+#define CATCH_CONFIG_MAIN
+
+#include "Catch2/single_include/catch2/catch.hpp"
+
+#include <functional>
+#include <algorithm>
+#include <numeric>
+
+#include "emp/math/Random.hpp"
+#include "selection/Lexicase.hpp"
+#include "selection/AgeLexicase.hpp"
+
+namespace {
+
+using fit_funs_t = emp::vector< emp::vector<std::function<double(void)>> >;
+using call_log_t = emp::vector< std::pair<size_t, size_t> >;
+
+/// Per-candidate, per-function score functions reading scores[candidate][function].
+/// scores must outlive the returned functions. If num_calls is given, it counts score function calls.
+/// If call_log is given, each call appends its (candidate, function).
+fit_funs_t MakeFitFuns(
+  const emp::vector< emp::vector<double> >& scores,
+  size_t* num_calls=nullptr,
+  call_log_t* call_log=nullptr
+) {
+  fit_funs_t fit_funs(scores.size());
+  for (size_t pop_i = 0; pop_i < scores.size(); ++pop_i) {
+    for (size_t fit_i = 0; fit_i < scores[pop_i].size(); ++fit_i) {
+      fit_funs[pop_i].emplace_back(
+        [&scores, pop_i, fit_i, num_calls, call_log]() {
+          if (num_calls != nullptr) ++(*num_calls);
+          if (call_log != nullptr) call_log->emplace_back(pop_i, fit_i);
+          return scores[pop_i][fit_i];
+        }
+      );
+    }
+  }
+  return fit_funs;
+}
+
+/// Check batch-mode selections when every ordering leaves exactly the candidates in survivors:
+/// each batch of batch_size consecutive selections (the last may be partial) draws survivors
+/// without replacement, recycling the full survivor pool each time it runs out.
+void CheckBatches(
+  const emp::vector<size_t>& selected,
+  size_t n,
+  size_t batch_size,
+  emp::vector<size_t> survivors
+) {
+  REQUIRE(selected.size() == n);
+  std::sort(survivors.begin(), survivors.end());
+  for (size_t batch_start = 0; batch_start < n; batch_start += batch_size) {
+    const size_t batch_end = std::min(n, batch_start + batch_size);
+    for (size_t block_start = batch_start; block_start < batch_end; block_start += survivors.size()) {
+      const size_t block_end = std::min(batch_end, block_start + survivors.size());
+      emp::vector<size_t> block(selected.begin() + block_start, selected.begin() + block_end);
+      std::sort(block.begin(), block.end());
+      REQUIRE(std::adjacent_find(block.begin(), block.end()) == block.end());
+      REQUIRE(std::includes(survivors.begin(), survivors.end(), block.begin(), block.end()));
+    }
+  }
+}
+
+}
+
+TEST_CASE("ScoreRankTable") {
+  emp::vector< emp::vector<double> > score_table{
+    {0.5, 0.25, 0.5, 1.0, 0.0},
+    {0.0, 0.0, 0.0, 0.0, 0.0}
+  };
+  // Column with more distinct values than fit in a uint8_t
+  score_table.emplace_back(300, 0.0);
+  for (size_t i = 0; i < score_table.back().size(); ++i) {
+    score_table.back()[i] = (double)i / 300.0;
+  }
+  // Column with more distinct values than fit in a uint16_t
+  score_table.emplace_back(70000, 0.0);
+  for (size_t i = 0; i < score_table.back().size(); ++i) {
+    score_table.back()[i] = (double)i;
+  }
+  // Large column with few distinct values (including both signs of zero)
+  score_table.emplace_back(70000, 0.0);
+  for (size_t i = 0; i < score_table.back().size(); ++i) {
+    score_table.back()[i] = (i % 3 == 0) ? -0.0 : (double)(i % 5);
+  }
+
+  selection::ScoreRankTable ranks;
+  ranks.Build(score_table);
+  REQUIRE(ranks.IsCompressed(0));
+  REQUIRE(ranks.IsCompressed(1));
+  REQUIRE(ranks.IsCompressed(2));
+  REQUIRE(!ranks.IsCompressed(3));
+  REQUIRE(ranks.IsCompressed(4));
+  REQUIRE(ranks.GetRankWidth(0) == 1);
+  REQUIRE(ranks.GetRankWidth(2) == 2);
+  REQUIRE(ranks.GetRankWidth(3) == 0);
+  REQUIRE(ranks.GetRankWidth(4) == 1);
+  REQUIRE(ranks.GetRanks<uint8_t>(0) == emp::vector<uint8_t>{2, 1, 2, 3, 0});
+  REQUIRE(ranks.GetRanks<uint8_t>(1) == emp::vector<uint8_t>{0, 0, 0, 0, 0});
+  for (size_t i = 0; i < 300; ++i) {
+    REQUIRE(ranks.GetRanks<uint16_t>(2)[i] == i);
+  }
+  for (size_t i = 0; i < 70000; ++i) {
+    REQUIRE(ranks.GetRanks<uint8_t>(4)[i] == ((i % 3 == 0) ? 0 : (i % 5)));
+  }
+}
+
+TEST_CASE("FilterMaxRank") {
+  emp::Random random(3);
+  emp::vector<size_t> pool;
+  emp::vector<size_t> next_pool;
+  emp::vector<size_t> expected;
+  emp::vector<uint8_t> ranks_8, gathered_8;
+  emp::vector<uint16_t> ranks_16, gathered_16;
+  for (size_t rep = 0; rep < 200; ++rep) {
+    const size_t num_cands = 1 + random.GetUInt(100);
+    const size_t num_values = 1 + random.GetUInt(rep % 2 ? 4 : 65536);
+    ranks_8.resize(num_cands);
+    ranks_16.resize(num_cands);
+    for (size_t i = 0; i < num_cands; ++i) {
+      ranks_16[i] = (uint16_t)random.GetUInt(num_values);
+      ranks_8[i] = (uint8_t)(ranks_16[i] % 256);
+    }
+    // Pool: random subset of candidates (in random order)
+    pool.resize(num_cands);
+    std::iota(pool.begin(), pool.end(), 0);
+    emp::Shuffle(random, pool);
+    pool.resize(1 + random.GetUInt(num_cands));
+    auto check = [&](const auto& ranks, auto& gathered) {
+      const auto max_rank = ranks[*std::max_element(
+        pool.begin(), pool.end(), [&ranks](size_t a, size_t b) { return ranks[a] < ranks[b]; }
+      )];
+      expected.clear();
+      for (size_t id : pool) {
+        if (ranks[id] == max_rank) expected.emplace_back(id);
+      }
+      selection::internal::FilterMaxRank(ranks, pool, next_pool, gathered);
+      REQUIRE(next_pool == expected);
+    };
+    check(ranks_8, gathered_8);
+    check(ranks_16, gathered_16);
+  }
+}
+
+TEST_CASE("LexicaseSelect rank compression matches raw scores") {
+  const int seed = 2;
+  const size_t pop_size = 600;
+  const size_t num_fit_funs = 20;
+  emp::Random score_rnd(seed);
+
+  // Mix of binary, few-valued (uint8_t ranks), and continuous (uint16_t ranks) scores.
+  emp::vector< emp::vector<double> > scores(pop_size, emp::vector<double>(num_fit_funs, 0.0));
+  for (size_t pop_i = 0; pop_i < pop_size; ++pop_i) {
+    for (size_t fit_i = 0; fit_i < num_fit_funs; ++fit_i) {
+      if (fit_i % 3 == 0) {
+        scores[pop_i][fit_i] = (double)score_rnd.P(0.5);
+      } else if (fit_i % 3 == 1) {
+        scores[pop_i][fit_i] = (double)score_rnd.GetUInt(4) / 4.0;
+      } else {
+        scores[pop_i][fit_i] = score_rnd.GetDouble();
+      }
+    }
+  }
+  fit_funs_t fit_funs = MakeFitFuns(scores);
+
+  emp::Random rnd_ranked(seed);
+  emp::Random rnd_raw(seed);
+  selection::LexicaseSelect ranked_selector(fit_funs, rnd_ranked);
+  selection::LexicaseSelect raw_selector(fit_funs, rnd_raw);
+  ranked_selector.SetRankCompression(true);
+  raw_selector.SetRankCompression(false);
+
+  for (size_t rep = 0; rep < 10; ++rep) {
+    const auto ranked_selected = ranked_selector(pop_size);
+    const auto raw_selected = raw_selector(pop_size);
+    REQUIRE(ranked_selected == raw_selected);
+  }
+}
+
+TEST_CASE("LexicaseSelect batch mode") {
+  const int seed = 2;
+  const size_t pop_size = 50;
+  const size_t num_fit_funs = 10;
+  emp::Random score_rnd(seed);
+  emp::vector< emp::vector<double> > scores(pop_size, emp::vector<double>(num_fit_funs, 0.0));
+  for (size_t pop_i = 0; pop_i < pop_size; ++pop_i) {
+    for (size_t fit_i = 0; fit_i < num_fit_funs; ++fit_i) {
+      scores[pop_i][fit_i] = (double)score_rnd.GetUInt(3);
+    }
+  }
+  fit_funs_t fit_funs = MakeFitFuns(scores);
+
+  // Batch size of 1 should be standard lexicase.
+  emp::Random rnd_default(seed);
+  emp::Random rnd_batch_1(seed);
+  selection::LexicaseSelect default_selector(fit_funs, rnd_default);
+  selection::LexicaseSelect batch_1_selector(fit_funs, rnd_batch_1);
+  batch_1_selector.SetBatchSize(1);
+  REQUIRE(default_selector(pop_size) == batch_1_selector(pop_size));
+
+  // Larger batches should still fill every selection slot with a valid id.
+  for (size_t batch_size : {2, 7, 64}) {
+    emp::Random rnd(seed);
+    selection::LexicaseSelect selector(fit_funs, rnd);
+    selector.SetBatchSize(batch_size);
+    const auto selected = selector(pop_size);
+    REQUIRE(selected.size() == pop_size);
+    for (size_t id : selected) {
+      REQUIRE(id < pop_size);
+    }
+  }
+
+  // Candidates 3, 17, and 41 tie for best on every function, so every ordering leaves exactly them.
+  const emp::vector<size_t> survivors{3, 17, 41};
+  emp::vector< emp::vector<double> > tied_scores(pop_size, emp::vector<double>(num_fit_funs, 0.0));
+  for (size_t pop_i : survivors) {
+    std::fill(tied_scores[pop_i].begin(), tied_scores[pop_i].end(), 1.0);
+  }
+  fit_funs_t tied_fit_funs = MakeFitFuns(tied_scores);
+  emp::Random rnd_tied(seed);
+  selection::LexicaseSelect tied_selector(tied_fit_funs, rnd_tied);
+  // Batch no larger than the survivor pool: distinct survivors per batch (n = 50 leaves a partial last batch)
+  tied_selector.SetBatchSize(3);
+  CheckBatches(tied_selector(pop_size), pop_size, 3, survivors);
+  tied_selector.SetBatchSize(2);
+  CheckBatches(tied_selector(pop_size), pop_size, 2, survivors);
+  // Batch larger than the survivor pool: pool is recycled within a batch (n = 50 leaves a partial last batch)
+  tied_selector.SetBatchSize(7);
+  const auto recycled = tied_selector(pop_size);
+  CheckBatches(recycled, pop_size, 7, survivors);
+  REQUIRE(std::count(recycled.begin(), recycled.begin() + 6, 3) == 2);
+  // Every candidate ties (one ordering can fill a whole batch with distinct candidates)
+  emp::vector< emp::vector<double> > flat_scores(pop_size, emp::vector<double>(num_fit_funs, 0.0));
+  fit_funs_t flat_fit_funs = MakeFitFuns(flat_scores);
+  emp::vector<size_t> all_ids(pop_size, 0);
+  std::iota(all_ids.begin(), all_ids.end(), 0);
+  emp::Random rnd_flat(seed);
+  selection::LexicaseSelect flat_selector(flat_fit_funs, rnd_flat);
+  flat_selector.SetBatchSize(16);
+  CheckBatches(flat_selector(pop_size), pop_size, 16, all_ids);
+  flat_selector.SetBatchSize(pop_size);
+  CheckBatches(flat_selector(pop_size), pop_size, pop_size, all_ids);
+}
+
+TEST_CASE("AgeLexicaseSelect batch mode") {
+  const int seed = 2;
+  const size_t pop_size = 50;
+  const size_t num_fit_funs = 10;
+  // Candidates 4, 9, 30, and 48 tie for best on every score function; everyone has the same age.
+  const emp::vector<size_t> survivors{4, 9, 30, 48};
+  emp::vector< emp::vector<double> > scores(pop_size, emp::vector<double>(num_fit_funs, 0.0));
+  for (size_t pop_i : survivors) {
+    std::fill(scores[pop_i].begin(), scores[pop_i].end(), 1.0);
+  }
+  fit_funs_t fit_funs = MakeFitFuns(scores);
+  fit_funs_t age_funs(pop_size);
+  for (size_t pop_i = 0; pop_i < pop_size; ++pop_i) {
+    age_funs[pop_i].emplace_back([](){ return 0.0; });
+  }
+
+  // Batch size of 1 should be standard age-lexicase.
+  emp::Random rnd_default(seed);
+  emp::Random rnd_batch_1(seed);
+  selection::AgeLexicaseSelect default_selector(fit_funs, age_funs, rnd_default);
+  selection::AgeLexicaseSelect batch_1_selector(fit_funs, age_funs, rnd_batch_1);
+  default_selector.SetAgeFunOrderLimit(num_fit_funs + 1);
+  batch_1_selector.SetAgeFunOrderLimit(num_fit_funs + 1);
+  batch_1_selector.SetBatchSize(1);
+  REQUIRE(batch_1_selector.GetBatchSize() == 1);
+  REQUIRE(default_selector(pop_size) == batch_1_selector(pop_size));
+
+  emp::Random rnd(seed);
+  selection::AgeLexicaseSelect selector(fit_funs, age_funs, rnd);
+  selector.SetAgeFunOrderLimit(num_fit_funs + 1);
+  for (size_t batch_size : {3, 4, 7}) {
+    selector.SetBatchSize(batch_size);
+    REQUIRE(selector.GetBatchSize() == batch_size);
+    CheckBatches(selector(pop_size), pop_size, batch_size, survivors);
+  }
+}
+
+TEST_CASE("LexicaseSelect lazy scores") {
+  const int seed = 2;
+  const size_t pop_size = 80;
+  const size_t num_fit_funs = 30;
+  emp::Random score_rnd(seed);
+  size_t num_calls = 0;
+  emp::vector< emp::vector<double> > scores(pop_size, emp::vector<double>(num_fit_funs, 0.0));
+  for (size_t pop_i = 0; pop_i < pop_size; ++pop_i) {
+    for (size_t fit_i = 0; fit_i < num_fit_funs; ++fit_i) {
+      scores[pop_i][fit_i] = (double)score_rnd.P(0.5);
+    }
+  }
+  fit_funs_t fit_funs = MakeFitFuns(scores, &num_calls);
+
+  emp::Random rnd_eager(seed);
+  emp::Random rnd_lazy(seed);
+  selection::LexicaseSelect eager_selector(fit_funs, rnd_eager);
+  selection::LexicaseSelect lazy_selector(fit_funs, rnd_lazy);
+  lazy_selector.SetLazyScores(true);
+  for (size_t rep = 0; rep < 5; ++rep) {
+    num_calls = 0;
+    const auto eager_selected = eager_selector(pop_size);
+    REQUIRE(num_calls == pop_size * num_fit_funs);
+    num_calls = 0;
+    const auto lazy_selected = lazy_selector(pop_size);
+    REQUIRE(lazy_selected == eager_selected);
+    // Every candidate is looked at on at least one function; never more than once per function
+    REQUIRE(num_calls >= pop_size);
+    REQUIRE(num_calls < pop_size * num_fit_funs);
+  }
+}
+
+TEST_CASE("LexicaseSelect lazy batch scores") {
+  const int seed = 3;
+  const size_t pop_size = 80;
+  const size_t num_fit_funs = 30;
+  emp::Random score_rnd(seed);
+  emp::vector< emp::vector<double> > scores(pop_size, emp::vector<double>(num_fit_funs, 0.0));
+  for (size_t pop_i = 0; pop_i < pop_size; ++pop_i) {
+    for (size_t fit_i = 0; fit_i < num_fit_funs; ++fit_i) {
+      scores[pop_i][fit_i] = (double)score_rnd.P(0.5);
+    }
+  }
+  // Record (candidate, function) for every score function call
+  call_log_t calls;
+  fit_funs_t fit_funs = MakeFitFuns(scores, nullptr, &calls);
+  // Number of times consecutive calls switch candidates (i.e., program loads for an evaluator)
+  auto count_switches = [&calls]() {
+    size_t switches = 0;
+    for (size_t i = 0; i < calls.size(); ++i) {
+      switches += (size_t)(i == 0 || calls[i].first != calls[i - 1].first);
+    }
+    return switches;
+  };
+
+  emp::Random rnd_eager(seed);
+  emp::Random rnd_lazy(seed);
+  emp::Random rnd_batch(seed);
+  selection::LexicaseSelect eager_selector(fit_funs, rnd_eager);
+  selection::LexicaseSelect lazy_selector(fit_funs, rnd_lazy);
+  selection::LexicaseSelect batch_selector(fit_funs, rnd_batch);
+  lazy_selector.SetLazyScores(true);
+  batch_selector.SetLazyScores(true);
+  batch_selector.SetLazyBatchSize(8);
+  REQUIRE(lazy_selector.GetLazyBatchSize() == 1);
+  REQUIRE(batch_selector.GetLazyBatchSize() == 8);
+  for (size_t rep = 0; rep < 5; ++rep) {
+    calls.clear();
+    const auto eager_selected = eager_selector(pop_size);
+    const size_t eager_calls = calls.size();
+    REQUIRE(eager_calls == pop_size * num_fit_funs);
+    calls.clear();
+    const auto lazy_selected = lazy_selector(pop_size);
+    const size_t lazy_switches = count_switches();
+    call_log_t lazy_calls(calls);
+    calls.clear();
+    const auto batch_selected = batch_selector(pop_size);
+    const size_t batch_switches = count_switches();
+    REQUIRE(lazy_selected == eager_selected);
+    REQUIRE(batch_selected == eager_selected);
+    // Batching keeps each candidate's calls together
+    REQUIRE(batch_switches < lazy_switches);
+    // Lazy scoring (batch size 1) only calls the functions filtering looks at
+    REQUIRE(lazy_calls.size() < eager_calls);
+    // Batching calls everything lazy scoring does, plus at most (batch size - 1) look-ahead calls per lazy call
+    REQUIRE(calls.size() >= lazy_calls.size());
+    REQUIRE(calls.size() <= std::min(eager_calls, lazy_calls.size() * batch_selector.GetLazyBatchSize()));
+    // Each score function is still called at most once per selection call
+    std::sort(calls.begin(), calls.end());
+    std::sort(lazy_calls.begin(), lazy_calls.end());
+    REQUIRE(std::adjacent_find(calls.begin(), calls.end()) == calls.end());
+    REQUIRE(std::adjacent_find(lazy_calls.begin(), lazy_calls.end()) == lazy_calls.end());
+    REQUIRE(std::includes(calls.begin(), calls.end(), lazy_calls.begin(), lazy_calls.end()));
+  }
+}
+
+TEST_CASE("LexicaseSelect cohort with repeated candidate ids") {
+  emp::Random random(2);
+  // Candidate 2 is best on every function
+  emp::vector< emp::vector<double> > scores{
+    {1.0, 0.0, 1.0},
+    {0.0, 1.0, 0.0},
+    {1.0, 1.0, 1.0}
+  };
+  fit_funs_t fit_funs = MakeFitFuns(scores);
+  emp::vector<size_t> fun_ids{0, 1, 2};
+  selection::LexicaseSelect selector(fit_funs, random);
+  // Repeated ids stand in for duplicate phenotypes (more candidates than score function sets)
+  emp::vector<size_t> cohort{0, 2, 1, 2, 0};
+  const auto& selected = selector(20, cohort, fun_ids);
+  REQUIRE(selected.size() == 20);
+  REQUIRE(std::count(selected.begin(), selected.end(), 2) == 20);
+  emp::vector<size_t> dup_cohort{1, 0, 0, 1};
+  const auto& dup_selected = selector(20, dup_cohort, emp::vector<size_t>{0});
+  REQUIRE(std::count(dup_selected.begin(), dup_selected.end(), 0) == 20);
+}
+
+TEST_CASE("LexicaseSelect selection profile") {
+  emp::Random random(2);
+  // Candidate 0 is best on every function except one, where everyone ties.
+  emp::vector< emp::vector<double> > scores{
+    {1.0, 1.0, 0.5},
+    {0.0, 1.0, 0.5},
+    {0.0, 0.0, 0.5}
+  };
+  fit_funs_t fit_funs = MakeFitFuns(scores);
+  selection::SelectionProfile profile;
+  selection::LexicaseSelect selector(fit_funs, random);
+  selector.SetProfile(&profile);
+  const auto& selected = selector(10);
+  REQUIRE(selected == emp::vector<size_t>(10, 0));
+  REQUIRE(profile.num_events == 10);
+  REQUIRE(profile.random_tie_events == 0);
+  size_t total_depth_events = 0;
+  for (size_t count : profile.depth_hist) total_depth_events += count;
+  REQUIRE(total_depth_events == 10);
+  // At most three criteria are ever needed
+  REQUIRE(profile.GetMeanDepth() >= 1.0);
+  REQUIRE(profile.GetMeanDepth() <= 3.0);
+  // Every event filters on at least one criterion; pools never grow
+  const auto mean_pools = profile.GetMeanPoolSizes();
+  REQUIRE(profile.pool_size_count[0] == 10);
+  REQUIRE(mean_pools[0] >= 1.0);
+  REQUIRE(mean_pools[0] <= 3.0);
+  REQUIRE(mean_pools[3] == 0.0);
+
+  profile.Reset();
+  REQUIRE(profile.num_events == 0);
+  REQUIRE(profile.GetMeanDepth() == 0.0);
+}
+
+TEST_CASE("AgeLexicaseSelect age source matches age functions") {
+  const int seed = 2;
+  const size_t pop_size = 60;
+  const size_t num_fit_funs = 8;
+  emp::Random score_rnd(seed);
+  emp::vector<size_t> ages(pop_size, 0);
+  emp::vector< emp::vector<double> > scores(pop_size, emp::vector<double>(num_fit_funs, 0.0));
+  fit_funs_t age_funs(pop_size);
+  for (size_t pop_i = 0; pop_i < pop_size; ++pop_i) {
+    ages[pop_i] = score_rnd.GetUInt(5);
+    for (size_t fit_i = 0; fit_i < num_fit_funs; ++fit_i) {
+      scores[pop_i][fit_i] = (double)score_rnd.GetUInt(3);
+    }
+    age_funs[pop_i].emplace_back(
+      [&ages, pop_i](){ return -1.0 * (double)ages[pop_i]; }
+    );
+  }
+  fit_funs_t fit_funs = MakeFitFuns(scores);
+
+  emp::Random rnd_funs(seed);
+  emp::Random rnd_source(seed);
+  selection::AgeLexicaseSelect fun_selector(fit_funs, age_funs, rnd_funs);
+  selection::AgeLexicaseSelect source_selector(fit_funs, age_funs, rnd_source);
+  fun_selector.SetAgeFunOrderLimit(num_fit_funs + 1);
+  source_selector.SetAgeFunOrderLimit(num_fit_funs + 1);
+  source_selector.SetAgeSource(&ages);
+  for (size_t rep = 0; rep < 5; ++rep) {
+    REQUIRE(fun_selector(pop_size) == source_selector(pop_size));
+    // Ages change between selection rounds (e.g., new generation placed)
+    for (size_t& age : ages) age = score_rnd.GetUInt(5);
+  }
+}
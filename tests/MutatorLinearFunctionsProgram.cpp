@@ -2,6 +2,8 @@
 
 #include "Catch2/single_include/catch2/catch.hpp"
 
+#include <thread>
+
 #include "emp/matching/MatchBin.hpp"
 #include "emp/bits/BitSet.hpp"
 
@@ -141,4 +143,49 @@ TEST_CASE("MutatorLinearFunctionsProgram") {
       REQUIRE(mutator.VerifyProgram(prog));
     }
   }
+  // Mutator clones (one per thread, each with its own random stream) give the same results
+  // in parallel as in serial.
+  const size_t num_threads = 4;
+  emp::vector<program_t> progs;
+  for (size_t i = 0; i < num_threads; ++i) {
+    progs.emplace_back(
+      sgp::cpu::lfunprg::GenRandLinearFunctionsProgram<hardware_t, TAG_WIDTH>(
+        random, inst_lib, {1,16}, NUM_FUNC_TAGS, {0,64}, NUM_INST_TAGS, NUM_INST_ARGS, ARG_VAL_RANGE
+      )
+    );
+  }
+  emp::vector<program_t> serial_progs(progs);
+  emp::vector<mutator_t::mutation_counts_t> serial_counts(num_threads);
+  for (size_t i = 0; i < num_threads; ++i) {
+    mutator_t clone(mutator);
+    emp::Random thread_random((int)i + 1);
+    clone.ResetLastMutationTracker();
+    for (size_t m = 0; m < 100; ++m) clone.ApplyAll(thread_random, serial_progs[i]);
+    serial_counts[i] = clone.GetLastMutations();
+  }
+  emp::vector<mutator_t> clones(num_threads, mutator);
+  emp::vector<std::thread> workers;
+  for (size_t i = 0; i < num_threads; ++i) {
+    workers.emplace_back([&clones, &progs, i]() {
+      emp::Random thread_random((int)i + 1);
+      clones[i].ResetLastMutationTracker();
+      for (size_t m = 0; m < 100; ++m) clones[i].ApplyAll(thread_random, progs[i]);
+    });
+  }
+  for (auto& worker : workers) worker.join();
+  mutator_t::mutation_counts_t merged;
+  mutator_t::mutation_counts_t serial_merged;
+  for (size_t i = 0; i < num_threads; ++i) {
+    REQUIRE(progs[i] == serial_progs[i]);
+    merged += clones[i].GetLastMutations();
+    serial_merged += serial_counts[i];
+  }
+  REQUIRE(merged == serial_merged);
+  REQUIRE(merged.GetTotal() > 0);
+  // Resetting the tracker zeroes every mutation type
+  clones[0].ResetLastMutationTracker();
+  REQUIRE(clones[0].GetLastMutations().GetTotal() == 0);
+  for (size_t i = 0; i < mutator_t::NUM_MUTATION_TYPES; ++i) {
+    REQUIRE(clones[0].GetLastMutations()[(mutator_t::MUTATION_TYPES)i] == 0);
+  }
 }
\ No newline at end of file
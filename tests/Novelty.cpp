@@ -0,0 +1,104 @@
+#define CATCH_CONFIG_MAIN
+
+#include "Catch2/single_include/catch2/catch.hpp"
+
+#include <algorithm>
+
+#include "emp/base/vector.hpp"
+#include "emp/math/Random.hpp"
+#include "utility/HammingVPTree.hpp"
+#include "selection/Novelty.hpp"
+
+namespace {
+
+// Brute-force mean distance to the k nearest rows (excluding the query row itself).
+double BruteForceKNearestMean(
+  const emp::vector<uint64_t>& rows,
+  size_t num_rows,
+  size_t num_words,
+  size_t query_id,
+  size_t k
+) {
+  emp::vector<size_t> dists;
+  for (size_t i = 0; i < num_rows; ++i) {
+    if (i == query_id) continue;
+    dists.emplace_back(utils::hamming_distance(
+      rows.data() + (query_id * num_words),
+      rows.data() + (i * num_words),
+      num_words
+    ));
+  }
+  std::sort(dists.begin(), dists.end());
+  const size_t n = std::min(k, dists.size());
+  double total = 0.0;
+  for (size_t i = 0; i < n; ++i) total += (double)dists[i];
+  return (n) ? total / (double)n : 0.0;
+}
+
+}
+
+TEST_CASE("HammingVPTree") {
+  emp::Random random(2);
+  for (size_t num_bits : {10, 100, 200}) {
+    const size_t num_rows = 300;
+    const size_t num_words = (num_bits + 63) / 64;
+    emp::vector<uint64_t> rows(num_rows * num_words, 0);
+    for (size_t row = 0; row < num_rows; ++row) {
+      // Copy an earlier row now and then to create duplicates
+      if (row > 0 && random.P(0.25)) {
+        const size_t src = random.GetUInt(row);
+        std::copy(
+          rows.begin() + (src * num_words),
+          rows.begin() + ((src + 1) * num_words),
+          rows.begin() + (row * num_words)
+        );
+        continue;
+      }
+      for (size_t bit = 0; bit < num_bits; ++bit) {
+        rows[(row * num_words) + (bit / 64)] |= (uint64_t)random.P(0.3) << (bit % 64);
+      }
+    }
+    utils::HammingVPTree tree;
+    tree.Build(rows.data(), num_rows, num_words, random);
+    for (size_t k : {1, 5, 20, 1000}) {
+      for (size_t query = 0; query < num_rows; query += 7) {
+        REQUIRE(
+          tree.KNearestMeanDistance(rows.data() + (query * num_words), k, query)
+          == Approx(BruteForceKNearestMean(rows, num_rows, num_words, query, k))
+        );
+      }
+    }
+  }
+}
+
+TEST_CASE("HammingVPTree weights") {
+  emp::Random random(2);
+  // Three unique points: 0b000 (x3), 0b001 (x1), 0b111 (x2)
+  emp::vector<uint64_t> points{0b000, 0b001, 0b111};
+  emp::vector<size_t> weights{3, 1, 2};
+  utils::HammingVPTree tree;
+  tree.Build(points.data(), points.size(), 1, random, weights.data());
+  // From a copy of 0b000: other copies of itself (0, 0), then 0b001 (1), then 0b111 (3, 3)
+  REQUIRE(tree.KNearestMeanDistance(points.data(), 2, 0) == Approx(0.0));
+  REQUIRE(tree.KNearestMeanDistance(points.data(), 3, 0) == Approx(1.0 / 3.0));
+  REQUIRE(tree.KNearestMeanDistance(points.data(), 4, 0) == Approx(4.0 / 4.0));
+  REQUIRE(tree.KNearestMeanDistance(points.data(), 100, 0) == Approx(7.0 / 5.0));
+}
+
+TEST_CASE("NoveltyArchive") {
+  emp::Random random(2);
+  selection::NoveltyArchive archive(random, 2, 10, 1.0);
+  // Four members: two identical, one close, one far
+  emp::vector<uint64_t> pop_rows{0b0000, 0b0000, 0b0001, 0b1111};
+  archive.Update(pop_rows, 4, 1);
+  REQUIRE(archive.GetNovelty(0) == Approx(0.5));
+  REQUIRE(archive.GetNovelty(1) == Approx(0.5));
+  REQUIRE(archive.GetNovelty(2) == Approx(1.0));
+  REQUIRE(archive.GetNovelty(3) == Approx(3.5));
+  // Everyone was added to the archive
+  REQUIRE(archive.GetArchiveSize() == 4);
+  // Now each member has its own archived copy as its nearest neighbour
+  archive.Update(pop_rows, 4, 1);
+  REQUIRE(archive.GetNovelty(3) == Approx(1.5));
+  REQUIRE(archive.GetArchiveSize() == 8);
+}
@@ -0,0 +1,77 @@
+#define CATCH_CONFIG_MAIN
+
+#include "Catch2/single_include/catch2/catch.hpp"
+
+#include <unordered_set>
+
+#include "emp/base/vector.hpp"
+#include "emp/base/Ptr.hpp"
+#include "utility/ObjectPool.hpp"
+#include "program-synthesis/ProgSynthOrg.hpp"
+
+TEST_CASE("ObjectPool") {
+  utils::ObjectPool<emp::vector<int>> pool;
+  pool.Reserve(8);
+  REQUIRE(pool.GetCapacity() == 8);
+  REQUIRE(pool.GetNumChunks() == 1);
+
+  emp::vector<void*> slots;
+  for (size_t i = 0; i < 8; ++i) slots.emplace_back(pool.Allocate());
+  REQUIRE(pool.GetNumLive() == 8);
+  REQUIRE(pool.GetNumFree() == 0);
+  REQUIRE(std::unordered_set<void*>(slots.begin(), slots.end()).size() == 8);
+  for (void* slot : slots) REQUIRE(pool.Owns(slot));
+  int outside = 0;
+  REQUIRE(!pool.Owns(&outside));
+
+  // Freed slots are reused before the pool grows.
+  pool.Deallocate(slots[3]);
+  REQUIRE(pool.Allocate() == slots[3]);
+  REQUIRE(pool.GetNumChunks() == 1);
+
+  // Exhausted pools grow.
+  void* extra = pool.Allocate();
+  REQUIRE(pool.GetNumChunks() == 2);
+  REQUIRE(pool.GetCapacity() == 24);
+  REQUIRE(pool.Owns(extra));
+  pool.Deallocate(extra);
+  for (void* slot : slots) pool.Deallocate(slot);
+  REQUIRE(pool.GetNumLive() == 0);
+}
+
+TEST_CASE("Pooled organisms") {
+  using org_t = psynth::ProgSynthOrg<emp::vector<int>>;
+  using genome_t = typename org_t::genome_t;
+  typename org_t::pool_t pool;
+  pool.Reserve(4);
+
+  // Organisms allocated before a pool is attached still return to the global heap.
+  emp::Ptr<org_t> heap_org = emp::NewPtr<org_t>(genome_t({1, 2, 3}));
+  REQUIRE(!pool.Owns(heap_org.Raw()));
+
+  org_t::SetPool(&pool);
+  emp::vector<emp::Ptr<org_t>> orgs;
+  for (int i = 0; i < 4; ++i) {
+    orgs.emplace_back(emp::NewPtr<org_t>(genome_t({i, i})));
+    REQUIRE(pool.Owns(orgs.back().Raw()));
+    REQUIRE(orgs.back()->GetGenome().GetProgram()[0] == i);
+  }
+  REQUIRE(pool.GetNumLive() == 4);
+  heap_org.Delete();
+  REQUIRE(pool.GetNumLive() == 4);
+
+  // Steady state: a generation of deaths and births reuses the same slots.
+  std::unordered_set<org_t*> first_gen;
+  for (auto& org : orgs) {
+    first_gen.emplace(org.Raw());
+    org.Delete();
+  }
+  REQUIRE(pool.GetNumLive() == 0);
+  for (int i = 0; i < 4; ++i) {
+    orgs[(size_t)i] = emp::NewPtr<org_t>(genome_t({i}));
+    REQUIRE(first_gen.count(orgs[(size_t)i].Raw()) == 1);
+  }
+  REQUIRE(pool.GetNumChunks() == 1);
+  for (auto& org : orgs) org.Delete();
+  org_t::SetPool(nullptr);
+}
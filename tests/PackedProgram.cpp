@@ -0,0 +1,301 @@
+#define CATCH_CONFIG_MAIN
+
+#include "Catch2/single_include/catch2/catch.hpp"
+
+#include <sstream>
+#include <unordered_set>
+
+#include "emp/matching/MatchBin.hpp"
+#include "emp/bits/BitSet.hpp"
+
+#include "sgp/cpu/mem/BasicMemoryModel.hpp"
+#include "sgp/cpu/LinearFunctionsProgramCPU.hpp"
+
+#include "program-synthesis/PackedProgram.hpp"
+#include "program-synthesis/MutatorLinearFunctionsProgram.hpp"
+#include "program-synthesis/RecombinerLinearFunctionsProgram.hpp"
+#include "program-synthesis/program_utils.hpp"
+
+TEST_CASE("PackedProgram") {
+  constexpr size_t TAG_WIDTH = 16;
+  constexpr int RANDOM_SEED = 1;
+  using mem_model_t = sgp::cpu::mem::BasicMemoryModel;
+  using tag_t = emp::BitSet<TAG_WIDTH>;
+  using arg_t = int;
+  using matchbin_t = emp::MatchBin<
+    size_t,
+    emp::HammingMetric<TAG_WIDTH>,
+    emp::RankedSelector<>,
+    emp::NopRegulator
+  >;
+  using hardware_t = sgp::cpu::LinearFunctionsProgramCPU<
+    mem_model_t,
+    arg_t,
+    matchbin_t
+  >;
+  using inst_t = typename hardware_t::inst_t;
+  using inst_lib_t = typename hardware_t::inst_lib_t;
+  using program_t = typename hardware_t::program_t;
+  using packed_program_t = psynth::PackedProgram<TAG_WIDTH>;
+  using mutator_t = psynth::MutatorLinearFunctionsProgram<hardware_t, tag_t, arg_t>;
+  using recomb_t = psynth::RecombinerLinearFunctionsProgram<hardware_t, tag_t, arg_t>;
+
+  inst_lib_t inst_lib;
+  inst_lib.AddInst("Nop-A", [](hardware_t & hw, const inst_t & inst) { ; }, "No operation!");
+  inst_lib.AddInst("Nop-B", [](hardware_t & hw, const inst_t & inst) { ; }, "No operation!");
+  inst_lib.AddInst("Nop-C", [](hardware_t & hw, const inst_t & inst) { ; }, "No operation!");
+  emp::Random random(RANDOM_SEED);
+
+  emp::Range<int> ARG_VAL_RANGE = {0, 15};
+  emp::Range<size_t> FUNC_LEN_RANGE = {1, 64};
+  emp::Range<size_t> FUNC_CNT_RANGE = {1, 16};
+
+  SECTION("Conversions, comparisons, and hashing") {
+    for (size_t i = 0; i < 100; ++i) {
+      program_t prog(
+        sgp::cpu::lfunprg::GenRandLinearFunctionsProgram<hardware_t, TAG_WIDTH>(
+          random, inst_lib, FUNC_CNT_RANGE, 1, FUNC_LEN_RANGE, 1, 3, ARG_VAL_RANGE
+        )
+      );
+      const packed_program_t packed = packed_program_t::FromProgram(prog);
+      REQUIRE(packed.GetSize() == prog.GetSize());
+      REQUIRE(packed.GetInstCount() == prog.GetInstCount());
+      for (size_t fID = 0; fID < prog.GetSize(); ++fID) {
+        REQUIRE(packed.GetFunctionSize(fID) == prog[fID].GetSize());
+      }
+      REQUIRE(packed.ToProgram<program_t>() == prog);
+
+      packed_program_t copy(packed);
+      REQUIRE(copy == packed);
+      REQUIRE(copy.Hash() == packed.Hash());
+      REQUIRE(!(copy < packed));
+      copy.GetInst(0, 0).args[0] = (int8_t)(copy.GetInst(0, 0).args[0] + 1);
+      REQUIRE(copy != packed);
+      REQUIRE(copy.Hash() != packed.Hash());
+      REQUIRE(((copy < packed) != (packed < copy)));
+    }
+  }
+
+  SECTION("Native edits") {
+    packed_program_t prog;
+    for (uint32_t f = 0; f < 3; ++f) {
+      prog.PushFunction(f);
+      for (uint32_t i = 0; i < 4; ++i) {
+        prog.PushInst({0, f, (int8_t)i});
+      }
+    }
+    REQUIRE(prog.GetInstCount() == 12);
+    prog.InsertInst(0, 4, {1, 0});
+    REQUIRE(prog.GetFunctionSize(0) == 5);
+    REQUIRE(prog.GetInst(0, 4).op == 1);
+    REQUIRE(prog.GetInst(1, 0).tag == 1);
+    prog.EraseInsts(1, 1, 3);
+    REQUIRE(prog.GetFunctionSize(1) == 2);
+    REQUIRE(prog.GetInst(1, 1).args[0] == 3);
+    REQUIRE(prog.GetInst(2, 0).tag == 2);
+    prog.DuplicateFunction(1);
+    REQUIRE(prog.GetSize() == 4);
+    REQUIRE(prog.GetFunctionTag(3) == 1);
+    REQUIRE(prog.GetFunctionSize(3) == 2);
+    prog.RemoveFunctionSwapLast(0);
+    REQUIRE(prog.GetSize() == 3);
+    REQUIRE(prog.GetFunctionTag(0) == 1);
+    REQUIRE(prog.GetFunctionSize(0) == 2);
+    REQUIRE(prog.GetInstCount() == 8);
+    std::unordered_set<packed_program_t> seen;
+    seen.emplace(prog);
+    REQUIRE(seen.count(prog) == 1);
+  }
+
+  SECTION("Printing") {
+    program_t prog(
+      sgp::cpu::lfunprg::GenRandLinearFunctionsProgram<hardware_t, TAG_WIDTH>(
+        random, inst_lib, FUNC_CNT_RANGE, 1, FUNC_LEN_RANGE, 1, 3, ARG_VAL_RANGE
+      )
+    );
+    const packed_program_t packed = packed_program_t::FromProgram(prog);
+    std::ostringstream packed_out;
+    std::ostringstream prog_out;
+    packed.Print(packed_out, inst_lib);
+    prog.Print(prog_out, inst_lib);
+    REQUIRE(packed_out.str() == prog_out.str());
+    std::istringstream packed_in(packed_out.str());
+    const program_t loaded = psynth::LoadLinearFunctionsProgram_PrintFormat<inst_lib_t, TAG_WIDTH>(packed_in, inst_lib);
+    REQUIRE(loaded == prog);
+    std::ostringstream packed_json;
+    std::ostringstream prog_json;
+    psynth::PrintProgramJSON(packed_json, packed, inst_lib);
+    psynth::PrintProgramJSON(prog_json, prog, inst_lib);
+    REQUIRE(packed_json.str() == prog_json.str());
+  }
+
+  SECTION("Mutation") {
+    mutator_t mutator(inst_lib);
+    mutator.SetProgFunctionCntRange(FUNC_CNT_RANGE);
+    mutator.SetProgFunctionInstCntRange(FUNC_LEN_RANGE);
+    mutator.SetProgInstArgValueRange(ARG_VAL_RANGE);
+    mutator.SetTotalInstLimit(1024);
+    mutator.SetFuncNumTags(1);
+    mutator.SetInstNumTags(1);
+    mutator.SetInstNumArgs(3);
+    mutator.SetRateInstArgSub(0.25);
+    mutator.SetRateInstTagBF(0.25);
+    mutator.SetRateInstSub(0.25);
+    mutator.SetRateInstIns(0.25);
+    mutator.SetRateInstDel(0.25);
+    mutator.SetRateSeqSlip(0.25);
+    mutator.SetRateFuncDup(0.25);
+    mutator.SetRateFuncDel(0.25);
+    mutator.SetRateFuncTagBF(0.25);
+    for (size_t i = 0; i < 200; ++i) {
+      packed_program_t prog = packed_program_t::FromProgram(
+        sgp::cpu::lfunprg::GenRandLinearFunctionsProgram<hardware_t, TAG_WIDTH>(
+          random, inst_lib, FUNC_CNT_RANGE, 1, FUNC_LEN_RANGE, 1, 3, ARG_VAL_RANGE
+        )
+      );
+      REQUIRE(mutator.VerifyProgram(prog));
+      for (size_t m = 0; m < 20; ++m) {
+        mutator.ApplyAll(random, prog);
+        REQUIRE(mutator.VerifyProgram(prog));
+        // Mutated packed programs still convert cleanly
+        REQUIRE(packed_program_t::FromProgram(prog.ToProgram<program_t>()) == prog);
+      }
+    }
+  }
+
+  SECTION("In-place indels") {
+    // Is [a_begin, a_end) a subsequence of [b_begin, b_end)?
+    auto is_subsequence = [](const auto* a_begin, const auto* a_end, const auto* b_begin, const auto* b_end) {
+      for (; a_begin != a_end; ++b_begin) {
+        if (b_begin == b_end) return false;
+        if (*a_begin == *b_begin) ++a_begin;
+      }
+      return true;
+    };
+    mutator_t mutator(inst_lib);
+    mutator.SetProgFunctionCntRange(FUNC_CNT_RANGE);
+    mutator.SetProgFunctionInstCntRange(FUNC_LEN_RANGE);
+    mutator.SetProgInstArgValueRange(ARG_VAL_RANGE);
+    mutator.SetTotalInstLimit(512);
+    mutator.SetFuncNumTags(1);
+    mutator.SetInstNumTags(1);
+    mutator.SetInstNumArgs(3);
+    const emp::vector<std::pair<double, double>> indel_rates{{0.1, 0.0}, {0.0, 0.1}, {0.1, 0.1}, {0.5, 0.5}};
+    for (const auto& [ins_rate, del_rate] : indel_rates) {
+      mutator.SetRateInstIns(ins_rate);
+      mutator.SetRateInstDel(del_rate);
+      for (size_t i = 0; i < 100; ++i) {
+        // Up to 8 functions, so programs start within (and can bump into) the total instruction limit.
+        const program_t orig_prog(
+          sgp::cpu::lfunprg::GenRandLinearFunctionsProgram<hardware_t, TAG_WIDTH>(
+            random, inst_lib, {1, 8}, 1, FUNC_LEN_RANGE, 1, 3, ARG_VAL_RANGE
+          )
+        );
+        const packed_program_t orig = packed_program_t::FromProgram(orig_prog);
+        program_t prog(orig_prog);
+        packed_program_t packed(orig);
+        mutator.ResetLastMutationTracker();
+        mutator.ApplyInstInDels(random, prog);
+        const int prog_ins = mutator.GetLastMutations()[mutator_t::MUTATION_TYPES::INST_INS];
+        const int prog_dels = mutator.GetLastMutations()[mutator_t::MUTATION_TYPES::INST_DEL];
+        mutator.ResetLastMutationTracker();
+        mutator.ApplyInstInDels(random, packed);
+        const int packed_ins = mutator.GetLastMutations()[mutator_t::MUTATION_TYPES::INST_INS];
+        const int packed_dels = mutator.GetLastMutations()[mutator_t::MUTATION_TYPES::INST_DEL];
+        REQUIRE(mutator.VerifyProgram(prog));
+        REQUIRE(mutator.VerifyProgram(packed));
+        REQUIRE((int)prog.GetInstCount() == (int)orig.GetInstCount() + prog_ins - prog_dels);
+        REQUIRE((int)packed.GetInstCount() == (int)orig.GetInstCount() + packed_ins - packed_dels);
+        REQUIRE(packed.GetFunctionOffsets().back() == packed.GetInstCount());
+        const packed_program_t mutated_prog = packed_program_t::FromProgram(prog);
+        REQUIRE(mutated_prog.GetFunctionTags() == orig.GetFunctionTags());
+        REQUIRE(packed.GetFunctionTags() == orig.GetFunctionTags());
+        // Surviving instructions keep their order.
+        for (const packed_program_t* mutated : emp::vector<const packed_program_t*>{&mutated_prog, &packed}) {
+          for (size_t fID = 0; fID < orig.GetSize(); ++fID) {
+            if (del_rate == 0.0) {
+              REQUIRE(is_subsequence(orig.FunctionBegin(fID), orig.FunctionEnd(fID), mutated->FunctionBegin(fID), mutated->FunctionEnd(fID)));
+            }
+            if (ins_rate == 0.0) {
+              REQUIRE(is_subsequence(mutated->FunctionBegin(fID), mutated->FunctionEnd(fID), orig.FunctionBegin(fID), orig.FunctionEnd(fID)));
+            }
+          }
+        }
+      }
+    }
+  }
+
+  SECTION("Recombination") {
+    recomb_t recombiner;
+    recombiner.SetWholeFuncSwapRate(0.5);
+    recombiner.SetFuncSeqCrossoverRate(0.5);
+    for (size_t i = 0; i < 100; ++i) {
+      packed_program_t prog_1 = packed_program_t::FromProgram(
+        sgp::cpu::lfunprg::GenRandLinearFunctionsProgram<hardware_t, TAG_WIDTH>(
+          random, inst_lib, FUNC_CNT_RANGE, 1, FUNC_LEN_RANGE, 1, 3, ARG_VAL_RANGE
+        )
+      );
+      packed_program_t prog_2 = packed_program_t::FromProgram(
+        sgp::cpu::lfunprg::GenRandLinearFunctionsProgram<hardware_t, TAG_WIDTH>(
+          random, inst_lib, FUNC_CNT_RANGE, 1, FUNC_LEN_RANGE, 1, 3, ARG_VAL_RANGE
+        )
+      );
+      // Whole function swaps conserve functions and instructions.
+      const size_t total_insts = prog_1.GetInstCount() + prog_2.GetInstCount();
+      const size_t p1_funcs = prog_1.GetSize();
+      const size_t p2_funcs = prog_2.GetSize();
+      recombiner.ApplyWholeFunctionRecombination(random, prog_1, prog_2);
+      REQUIRE(prog_1.GetInstCount() + prog_2.GetInstCount() == total_insts);
+      REQUIRE(prog_1.GetSize() == p1_funcs);
+      REQUIRE(prog_2.GetSize() == p2_funcs);
+      // Two-point crossover never changes function counts or tags.
+      const auto p1_tags = prog_1.GetFunctionTags();
+      const auto p2_tags = prog_2.GetFunctionTags();
+      recombiner.ApplyFunctionSequenceRecombinationTwoPoint(random, prog_1, prog_2);
+      REQUIRE(prog_1.GetFunctionTags() == p1_tags);
+      REQUIRE(prog_2.GetFunctionTags() == p2_tags);
+      REQUIRE(prog_1.GetFunctionOffsets().back() == prog_1.GetInstCount());
+      REQUIRE(prog_2.GetFunctionOffsets().back() == prog_2.GetInstCount());
+    }
+  }
+
+  SECTION("In-place recombination") {
+    // Program and packed program recombination make the same random draws, so (given the same
+    // random seed) they should produce the same offspring.
+    recomb_t recombiner;
+    recomb_t packed_recombiner;
+    for (double rate : {0.0, 0.5, 1.0}) {
+      recombiner.SetWholeFuncSwapRate(rate);
+      recombiner.SetFuncSeqCrossoverRate(rate);
+      packed_recombiner.SetWholeFuncSwapRate(rate);
+      packed_recombiner.SetFuncSeqCrossoverRate(rate);
+      for (size_t i = 0; i < 100; ++i) {
+        program_t prog_1 = sgp::cpu::lfunprg::GenRandLinearFunctionsProgram<hardware_t, TAG_WIDTH>(
+          random, inst_lib, FUNC_CNT_RANGE, 1, FUNC_LEN_RANGE, 1, 3, ARG_VAL_RANGE
+        );
+        program_t prog_2 = sgp::cpu::lfunprg::GenRandLinearFunctionsProgram<hardware_t, TAG_WIDTH>(
+          random, inst_lib, FUNC_CNT_RANGE, 1, FUNC_LEN_RANGE, 1, 3, ARG_VAL_RANGE
+        );
+        packed_program_t packed_1 = packed_program_t::FromProgram(prog_1);
+        packed_program_t packed_2 = packed_program_t::FromProgram(prog_2);
+        const size_t total_insts = prog_1.GetInstCount() + prog_2.GetInstCount();
+        const int seed = (int)random.GetUInt(1, 100000);
+        emp::Random prog_random(seed);
+        emp::Random packed_random(seed);
+        recombiner.ApplyWholeFunctionRecombination(prog_random, prog_1, prog_2);
+        packed_recombiner.ApplyWholeFunctionRecombination(packed_random, packed_1, packed_2);
+        REQUIRE(packed_program_t::FromProgram(prog_1) == packed_1);
+        REQUIRE(packed_program_t::FromProgram(prog_2) == packed_2);
+        recombiner.ApplyFunctionSequenceRecombinationTwoPoint(prog_random, prog_1, prog_2);
+        packed_recombiner.ApplyFunctionSequenceRecombinationTwoPoint(packed_random, packed_1, packed_2);
+        REQUIRE(packed_program_t::FromProgram(prog_1) == packed_1);
+        REQUIRE(packed_program_t::FromProgram(prog_2) == packed_2);
+        // Crossover exchanges instructions between programs (none are created or lost).
+        REQUIRE(prog_1.GetInstCount() + prog_2.GetInstCount() == total_insts);
+        REQUIRE(packed_1.GetFunctionOffsets().back() == packed_1.GetInstCount());
+        REQUIRE(packed_2.GetFunctionOffsets().back() == packed_2.GetInstCount());
+      }
+    }
+  }
+
+}
@@ -0,0 +1,154 @@
+#define CATCH_CONFIG_MAIN
+
+#include "Catch2/single_include/catch2/catch.hpp"
+
+#include <cstdint>
+#include <string>
+
+#include "emp/base/vector.hpp"
+#include "program-synthesis/ScoreStore.hpp"
+#include "program-synthesis/ProgSynthPhenotype.hpp"
+
+TEST_CASE("ScoreStore") {
+  const size_t num_orgs = 3;
+  const size_t num_tests = 70; // Spans two bit words
+  psynth::ScoreStore store;
+  store.Resize(num_orgs, num_tests);
+  REQUIRE(store.GetNumWords() == 2);
+  REQUIRE(store.GetPopCoverage() == 0);
+
+  // Score rows start on cache lines
+  for (size_t org_id = 0; org_id < num_orgs; ++org_id) {
+    REQUIRE(((uintptr_t)store.ScoreRow(org_id) % psynth::ScoreStore::ROW_ALIGN) == 0);
+  }
+
+  store.Record(0, 0, 1.0, true);
+  store.Record(0, 65, 0.5, false);
+  store.Record(1, 65, 1.0, true);
+  store.Record(1, 3, 0.25, false);
+
+  REQUIRE(store.IsEvaluated(0, 65));
+  REQUIRE(!store.IsEvaluated(0, 3));
+  REQUIRE(store.Passed(0, 0));
+  REQUIRE(!store.Passed(0, 65));
+  REQUIRE(store.GetScore(0, 65) == 0.5);
+  REQUIRE(store.GetScore(0, 3) == 0.0);
+  REQUIRE(store.GetAggregate(0) == 1.5);
+  REQUIRE(store.GetAggregate(1) == 1.25);
+  REQUIRE(store.GetAggregate(2) == 0.0);
+  REQUIRE(store.GetNumEvaluated(0) == 2);
+  REQUIRE(store.GetNumPassed(0) == 1);
+  REQUIRE(store.GetNumEvaluated(2) == 0);
+  REQUIRE(store.GetPopCoverage() == 2);
+  REQUIRE(store.PopCovered(65));
+  REQUIRE(!store.PopCovered(3));
+
+  const auto evals = store.GetEvaluated(1);
+  REQUIRE(evals.size() == num_tests);
+  REQUIRE(evals[3]);
+  REQUIRE(evals[65]);
+  REQUIRE(!evals[0]);
+  const auto scores = store.GetScores(1);
+  REQUIRE(scores.size() == num_tests);
+  REQUIRE(scores[3] == 0.25);
+
+  // Resetting an organism leaves the others (and population coverage) alone
+  store.ResetOrg(0);
+  REQUIRE(store.GetAggregate(0) == 0.0);
+  REQUIRE(store.GetNumEvaluated(0) == 0);
+  REQUIRE(store.GetScore(0, 65) == 0.0);
+  REQUIRE(store.GetNumEvaluated(1) == 2);
+  REQUIRE(store.GetPopCoverage() == 2);
+
+  store.ResetPopCoverage();
+  REQUIRE(store.GetPopCoverage() == 0);
+  REQUIRE(store.GetNumPassed(1) == 1);
+}
+
+TEST_CASE("ProgSynthPhenotype is a view of a ScoreStore row") {
+  psynth::ScoreStore store;
+  store.Resize(2, 100);
+  psynth::ProgSynthPhenotype phen;
+  REQUIRE(!phen.IsBound());
+  phen.Bind(store, 1);
+  REQUIRE(phen.IsBound());
+  REQUIRE(phen.GetNumTests() == 100);
+
+  store.Record(1, 70, 2.0, true);
+  store.Record(1, 5, 0.5, false);
+  store.Record(0, 6, 1.0, true);
+  REQUIRE(phen.GetAggregateScore() == 2.5);
+  REQUIRE(phen.GetNumPasses() == 1);
+  REQUIRE(phen.PassedTest(70));
+  REQUIRE(!phen.PassedTest(6));
+  REQUIRE(phen.TestEvaluated(5));
+  REQUIRE(phen.GetTestScore(5) == 0.5);
+  const auto passes = phen.GetTestPasses();
+  REQUIRE(passes.size() == 100);
+  for (size_t test_id = 0; test_id < 100; ++test_id) {
+    REQUIRE(passes.Get(test_id) == (test_id == 70));
+  }
+
+  // Copies view the same row
+  psynth::ProgSynthPhenotype copy(phen);
+  store.ResetOrg(1);
+  REQUIRE(copy.GetAggregateScore() == 0.0);
+  REQUIRE(!copy.PassedTest(70));
+}
+
+TEST_CASE("Compact score storage") {
+  using fixed_store_t = psynth::BasicScoreStore<uint16_t>;
+  using float_store_t = psynth::BasicScoreStore<float>;
+  const emp::vector<double> test_scores{0.0, 0.25, 0.5, 1.0 / 3.0, 1.0, 0.5};
+
+  fixed_store_t fixed_store;
+  float_store_t float_store;
+  fixed_store.Resize(2, 100);
+  float_store.Resize(2, 100);
+  REQUIRE(fixed_store_t::SCORES_PER_LINE == 32);
+  for (size_t org_id = 0; org_id < 2; ++org_id) {
+    REQUIRE(((uintptr_t)fixed_store.ScoreRow(org_id) % fixed_store_t::ROW_ALIGN) == 0);
+  }
+  for (size_t test_id = 0; test_id < test_scores.size(); ++test_id) {
+    fixed_store.Record(0, test_id, test_scores[test_id], test_scores[test_id] == 1.0);
+    float_store.Record(0, test_id, test_scores[test_id], test_scores[test_id] == 1.0);
+  }
+
+  // Scores exactly representable in [0, 1] survive; the rest are within storage resolution.
+  REQUIRE(fixed_store.GetScore(0, 1) == Approx(0.25).margin(1.0 / 65535.0));
+  REQUIRE(fixed_store.GetScore(0, 4) == 1.0);
+  // fixed16 rounds 0.25 and 0.5 (but 65535 is divisible by 3); float only rounds 1/3
+  REQUIRE(fixed_store.GetNumInexact() == 3);
+  REQUIRE(float_store.GetNumInexact() == 1);
+  REQUIRE(fixed_store.GetScore(0, 3) == Approx(1.0 / 3.0).margin(1.0 / 65535.0));
+  REQUIRE(float_store.GetScore(0, 2) == 0.5);
+  REQUIRE(float_store.GetScore(0, 3) == Approx(1.0 / 3.0));
+  // Ties and orderings are preserved.
+  REQUIRE(fixed_store.GetScore(0, 2) == fixed_store.GetScore(0, 5));
+  REQUIRE(float_store.GetScore(0, 2) == float_store.GetScore(0, 5));
+  for (size_t i = 0; i + 1 < 5; ++i) {
+    const bool lt = test_scores[i] < test_scores[i + 1];
+    REQUIRE((fixed_store.GetScore(0, i) < fixed_store.GetScore(0, i + 1)) == lt);
+  }
+  // Aggregates are sums of stored scores.
+  double agg = 0.0;
+  for (double score : fixed_store.GetScores(0)) agg += score;
+  REQUIRE(fixed_store.GetAggregate(0) == Approx(agg));
+  REQUIRE(fixed_store.GetStoredScores(0)[4] == 65535);
+  REQUIRE(fixed_store.GetNumPassed(0) == 1);
+  // Out-of-range scores are clamped.
+  fixed_store.Record(1, 0, 2.0, false);
+  fixed_store.Record(1, 1, -1.0, false);
+  REQUIRE(fixed_store.GetScore(1, 0) == 1.0);
+  REQUIRE(fixed_store.GetScore(1, 1) == 0.0);
+  REQUIRE(fixed_store.GetNumInexact() == 5);
+  // Scores closer than storage resolution collapse into a tie
+  REQUIRE(!utils::ScoreCodec<uint16_t>::IsExact(0.5 + 1e-6));
+  REQUIRE(utils::ScoreCodec<uint16_t>::Encode(0.5) == utils::ScoreCodec<uint16_t>::Encode(0.5 + 1e-6));
+  REQUIRE(std::string(utils::ScoreCodec<uint16_t>::caveat) != "");
+  REQUIRE(std::string(utils::ScoreCodec<double>::caveat) == "");
+  REQUIRE(utils::ScoreCodec<double>::IsExact(0.5 + 1e-6));
+  // Resize clears the count
+  fixed_store.Resize(2, 100);
+  REQUIRE(fixed_store.GetNumInexact() == 0);
+}
@@ -0,0 +1,210 @@
+#define CATCH_CONFIG_MAIN
+
+#include "Catch2/single_include/catch2/catch.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+#include "emp/math/Random.hpp"
+#include "selection/SelectionSchemes.hpp"
+
+namespace {
+
+/// Exposes TournamentSelect's entrant sampling for testing.
+struct TournamentSelectProbe : public selection::TournamentSelect {
+  using selection::TournamentSelect::TournamentSelect;
+  using selection::TournamentSelect::SampleEntries;
+  const emp::vector<size_t>& GetEntries() const { return entries; }
+};
+
+/// Entries are tournament_size distinct indices in [0, num_candidates).
+void CheckEntries(const TournamentSelectProbe& selector, size_t num_candidates) {
+  const auto& entries = selector.GetEntries();
+  REQUIRE(entries.size() == selector.GetTournamentSize());
+  emp::vector<size_t> sorted_entries(entries.begin(), entries.end());
+  std::sort(sorted_entries.begin(), sorted_entries.end());
+  REQUIRE(std::adjacent_find(sorted_entries.begin(), sorted_entries.end()) == sorted_entries.end());
+  REQUIRE(sorted_entries.back() < num_candidates);
+}
+
+/// Run one tournament over candidate_ids; the winner must be the best-scoring entrant.
+void CheckWinner(
+  TournamentSelectProbe& selector,
+  const emp::vector<double>& scores,
+  const emp::vector<size_t>& candidate_ids
+) {
+  const auto& selected = selector(1, candidate_ids);
+  REQUIRE(selected.size() == 1);
+  CheckEntries(selector, candidate_ids.size());
+  size_t best_id = candidate_ids[selector.GetEntries()[0]];
+  for (size_t entry : selector.GetEntries()) {
+    if (scores[candidate_ids[entry]] > scores[best_id]) best_id = candidate_ids[entry];
+  }
+  REQUIRE(selected[0] == best_id);
+}
+
+}
+
+TEST_CASE("TournamentSelect") {
+  emp::Random random(2);
+  // Distinct scores, so every tournament has a single best entrant
+  const size_t pop_size = 100;
+  emp::vector<double> scores(pop_size, 0.0);
+  for (size_t i = 0; i < pop_size; ++i) {
+    scores[i] = (double)((i * 7) % pop_size);
+  }
+  emp::vector<size_t> all_ids(pop_size, 0);
+  std::iota(all_ids.begin(), all_ids.end(), 0);
+
+  SECTION("Rejection sampling (tournament_size^2 <= num_candidates)") {
+    TournamentSelectProbe selector(scores, random, 4);
+    emp::vector<size_t> entry_counts(pop_size, 0);
+    for (size_t rep = 0; rep < 1000; ++rep) {
+      selector.SampleEntries(pop_size);
+      CheckEntries(selector, pop_size);
+      for (size_t entry : selector.GetEntries()) ++entry_counts[entry];
+    }
+    // Every candidate gets into some tournament
+    REQUIRE(std::count(entry_counts.begin(), entry_counts.end(), 0) == 0);
+    for (size_t rep = 0; rep < 100; ++rep) {
+      CheckWinner(selector, scores, all_ids);
+    }
+  }
+
+  SECTION("Partial Fisher-Yates (tournament_size^2 > num_candidates)") {
+    const size_t num_candidates = 10;
+    TournamentSelectProbe selector(scores, random, 8);
+    emp::vector<size_t> entry_counts(num_candidates, 0);
+    for (size_t rep = 0; rep < 1000; ++rep) {
+      selector.SampleEntries(num_candidates);
+      CheckEntries(selector, num_candidates);
+      for (size_t entry : selector.GetEntries()) ++entry_counts[entry];
+    }
+    REQUIRE(std::count(entry_counts.begin(), entry_counts.end(), 0) == 0);
+    // Tournament as large as the candidate pool: everyone is entered
+    selector.SetTournamentSize(num_candidates);
+    selector.SampleEntries(num_candidates);
+    CheckEntries(selector, num_candidates);
+    // Tournament of the whole population: best candidate always wins
+    selector.SetTournamentSize(pop_size);
+    const auto& selected = selector(10);
+    const size_t best_id = (size_t)(std::max_element(scores.begin(), scores.end()) - scores.begin());
+    REQUIRE(std::count(selected.begin(), selected.end(), best_id) == 10);
+    selector.SetTournamentSize(20);
+    for (size_t rep = 0; rep < 100; ++rep) {
+      CheckWinner(selector, scores, all_ids);
+    }
+  }
+
+  SECTION("Cohort") {
+    // Every third candidate
+    emp::vector<size_t> cohort;
+    for (size_t i = 0; i < pop_size; i += 3) cohort.emplace_back(i);
+    emp::vector<size_t> small_cohort{5, 17, 42, 63, 81, 99};
+    TournamentSelectProbe selector(scores, random, 4);
+    // Alternate between regimes (and permutation sizes) across calls
+    for (size_t rep = 0; rep < 100; ++rep) {
+      CheckWinner(selector, scores, cohort);       // 4^2 <= 34: rejection sampling
+      CheckWinner(selector, scores, small_cohort); // 4^2 > 6: partial Fisher-Yates
+      CheckWinner(selector, scores, all_ids);
+    }
+    const auto& selected = selector(50, small_cohort);
+    REQUIRE(selected.size() == 50);
+    for (size_t id : selected) {
+      REQUIRE(std::find(small_cohort.begin(), small_cohort.end(), id) != small_cohort.end());
+    }
+  }
+}
+
+TEST_CASE("TruncationSelect") {
+  emp::Random random(2);
+  emp::vector<double> scores{0.0, 5.0, 1.0, 4.0, 2.0, 3.0};
+  selection::TruncationSelect selector(scores, random, 2);
+
+  // Full population
+  const auto& selected = selector(6);
+  REQUIRE(selected.size() == 6);
+  for (size_t id : selected) {
+    REQUIRE((id == 1 || id == 3));
+  }
+  REQUIRE(std::count(selected.begin(), selected.end(), 1) == 3);
+
+  // Cohort
+  emp::vector<size_t> cohort{0, 2, 4};
+  const auto& cohort_selected = selector(3, cohort);
+  REQUIRE(cohort_selected.size() == 3);
+  for (size_t id : cohort_selected) {
+    REQUIRE((id == 2 || id == 4));
+  }
+
+  // Truncation size larger than number of candidates
+  selector.SetTruncationSize(10);
+  const auto& all_selected = selector(6);
+  emp::vector<size_t> sorted_selected(all_selected.begin(), all_selected.end());
+  std::sort(sorted_selected.begin(), sorted_selected.end());
+  REQUIRE(sorted_selected == emp::vector<size_t>{0, 1, 2, 3, 4, 5});
+}
+
+TEST_CASE("RandomSelect") {
+  emp::Random random(2);
+  selection::RandomSelect selector(random, 10);
+
+  const auto& selected = selector(100);
+  REQUIRE(selected.size() == 100);
+  for (size_t id : selected) {
+    REQUIRE(id < 10);
+  }
+
+  emp::vector<size_t> cohort{3, 7};
+  const auto& cohort_selected = selector(50, cohort);
+  REQUIRE(cohort_selected.size() == 50);
+  for (size_t id : cohort_selected) {
+    REQUIRE((id == 3 || id == 7));
+  }
+}
+
+TEST_CASE("NoSelect") {
+  selection::NoSelect selector(4);
+  REQUIRE(selector(4) == emp::vector<size_t>{0, 1, 2, 3});
+  REQUIRE(selector(6) == emp::vector<size_t>{0, 1, 2, 3, 0, 1});
+
+  emp::vector<size_t> cohort{5, 2, 9};
+  REQUIRE(selector(3, cohort) == cohort);
+}
+
+TEST_CASE("NSGA2Select") {
+  emp::Random random(2);
+  // Candidate 0 dominates everyone else; candidates 1 and 2 are mutually non-dominated.
+  emp::vector< emp::vector<double> > scores{
+    {2.0, 2.0},
+    {1.0, 0.0},
+    {0.0, 1.0},
+    {0.0, 0.0}
+  };
+  emp::vector<
+    emp::vector<std::function<double(void)>>
+  > fit_funs(scores.size(), {});
+  for (size_t pop_i = 0; pop_i < scores.size(); ++pop_i) {
+    for (size_t fit_i = 0; fit_i < scores[pop_i].size(); ++fit_i) {
+      fit_funs[pop_i].emplace_back(
+        [&scores, pop_i, fit_i](){ return scores[pop_i][fit_i]; }
+      );
+    }
+  }
+  selection::NSGA2Select selector(fit_funs, random);
+  const auto& selected = selector(1000);
+  REQUIRE(selected.size() == 1000);
+  REQUIRE(selector.GetSorter().GetNumFronts() == 3);
+  // The worst candidate can never win a tournament (it either loses or plays itself).
+  const size_t worst_wins = (size_t)std::count(selected.begin(), selected.end(), 3);
+  const size_t best_wins = (size_t)std::count(selected.begin(), selected.end(), 0);
+  REQUIRE(best_wins > worst_wins);
+
+  // Cohort: only candidates 1 and 3 (1 dominates 3)
+  emp::vector<size_t> cohort{1, 3};
+  emp::vector<size_t> fun_ids{0, 1};
+  const auto& cohort_selected = selector(100, cohort, fun_ids);
+  for (size_t id : cohort_selected) {
+    REQUIRE((id == 1 || id == 3));
+  }
+}
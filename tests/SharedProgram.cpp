@@ -0,0 +1,157 @@
+#define CATCH_CONFIG_MAIN
+
+#include "Catch2/single_include/catch2/catch.hpp"
+
+#include <sstream>
+
+#include "emp/matching/MatchBin.hpp"
+#include "emp/bits/BitSet.hpp"
+
+#include "sgp/cpu/mem/BasicMemoryModel.hpp"
+#include "sgp/cpu/LinearFunctionsProgramCPU.hpp"
+
+#include "program-synthesis/SharedProgram.hpp"
+#include "program-synthesis/MutatorLinearFunctionsProgram.hpp"
+#include "program-synthesis/RecombinerLinearFunctionsProgram.hpp"
+
+TEST_CASE("SharedFunctionTable") {
+  auto& table = psynth::SharedFunctionTable::Get();
+  const size_t base_funcs = table.GetNumFunctions();
+  const emp::vector<psynth::PackedInst> insts{{0, 1, 2}, {1, 3, 4}};
+  {
+    psynth::SharedFunction func_a(7, insts.data(), insts.data() + insts.size());
+    psynth::SharedFunction func_b(7, insts.data(), insts.data() + insts.size());
+    psynth::SharedFunction func_c(8, insts.data(), insts.data() + insts.size());
+    // Identical functions share a node
+    REQUIRE(func_a == func_b);
+    REQUIRE(func_a != func_c);
+    REQUIRE(func_a.GetRefCount() == 2);
+    REQUIRE(table.GetNumFunctions() == base_funcs + 2);
+    psynth::SharedFunction func_d(func_c);
+    REQUIRE(func_c.GetRefCount() == 2);
+    func_d = func_a;
+    REQUIRE(func_c.GetRefCount() == 1);
+    REQUIRE(func_a.GetRefCount() == 3);
+  }
+  // Unreferenced functions are freed
+  REQUIRE(table.GetNumFunctions() == base_funcs);
+}
+
+TEST_CASE("SharedProgram") {
+  constexpr size_t TAG_WIDTH = 16;
+  constexpr int RANDOM_SEED = 1;
+  using mem_model_t = sgp::cpu::mem::BasicMemoryModel;
+  using tag_t = emp::BitSet<TAG_WIDTH>;
+  using arg_t = int;
+  using matchbin_t = emp::MatchBin<
+    size_t,
+    emp::HammingMetric<TAG_WIDTH>,
+    emp::RankedSelector<>,
+    emp::NopRegulator
+  >;
+  using hardware_t = sgp::cpu::LinearFunctionsProgramCPU<
+    mem_model_t,
+    arg_t,
+    matchbin_t
+  >;
+  using inst_t = typename hardware_t::inst_t;
+  using inst_lib_t = typename hardware_t::inst_lib_t;
+  using program_t = typename hardware_t::program_t;
+  using shared_program_t = psynth::SharedProgram<TAG_WIDTH>;
+  using mutator_t = psynth::MutatorLinearFunctionsProgram<hardware_t, tag_t, arg_t>;
+  using recomb_t = psynth::RecombinerLinearFunctionsProgram<hardware_t, tag_t, arg_t>;
+
+  inst_lib_t inst_lib;
+  inst_lib.AddInst("Nop-A", [](hardware_t & hw, const inst_t & inst) { ; }, "No operation!");
+  inst_lib.AddInst("Nop-B", [](hardware_t & hw, const inst_t & inst) { ; }, "No operation!");
+  inst_lib.AddInst("Nop-C", [](hardware_t & hw, const inst_t & inst) { ; }, "No operation!");
+  emp::Random random(RANDOM_SEED);
+
+  emp::Range<int> ARG_VAL_RANGE = {0, 15};
+  emp::Range<size_t> FUNC_LEN_RANGE = {1, 64};
+  emp::Range<size_t> FUNC_CNT_RANGE = {1, 16};
+  auto& table = psynth::SharedFunctionTable::Get();
+
+  SECTION("Conversions and sharing") {
+    for (size_t i = 0; i < 50; ++i) {
+      const program_t prog(
+        sgp::cpu::lfunprg::GenRandLinearFunctionsProgram<hardware_t, TAG_WIDTH>(
+          random, inst_lib, FUNC_CNT_RANGE, 1, FUNC_LEN_RANGE, 1, 3, ARG_VAL_RANGE
+        )
+      );
+      const shared_program_t shared = shared_program_t::FromProgram(prog);
+      REQUIRE(shared.GetSize() == prog.GetSize());
+      REQUIRE(shared.GetInstCount() == prog.GetInstCount());
+      REQUIRE(shared.ToProgram<program_t>() == prog);
+      std::ostringstream shared_out;
+      std::ostringstream prog_out;
+      shared.Print(shared_out, inst_lib);
+      prog.Print(prog_out, inst_lib);
+      REQUIRE(shared_out.str() == prog_out.str());
+      // Building the same program again reuses every function.
+      const size_t num_funcs = table.GetNumFunctions();
+      const shared_program_t rebuilt = shared_program_t::FromProgram(prog);
+      REQUIRE(table.GetNumFunctions() == num_funcs);
+      REQUIRE(rebuilt == shared);
+      REQUIRE(rebuilt.Hash() == shared.Hash());
+      REQUIRE(!(rebuilt < shared));
+    }
+  }
+
+  SECTION("Copy-on-write mutation") {
+    mutator_t mutator(inst_lib);
+    mutator.SetProgFunctionCntRange(FUNC_CNT_RANGE);
+    mutator.SetProgFunctionInstCntRange(FUNC_LEN_RANGE);
+    mutator.SetProgInstArgValueRange(ARG_VAL_RANGE);
+    mutator.SetTotalInstLimit(1024);
+    mutator.SetRateInstArgSub(0.005);
+    mutator.SetRateInstSub(0.005);
+    for (size_t i = 0; i < 50; ++i) {
+      const shared_program_t parent = shared_program_t::FromProgram(
+        sgp::cpu::lfunprg::GenRandLinearFunctionsProgram<hardware_t, TAG_WIDTH>(
+          random, inst_lib, FUNC_CNT_RANGE, 1, FUNC_LEN_RANGE, 1, 3, ARG_VAL_RANGE
+        )
+      );
+      shared_program_t offspring(parent);
+      REQUIRE(offspring == parent);
+      const size_t num_muts = mutator.ApplyAll(random, offspring);
+      REQUIRE(offspring.GetSize() == parent.GetSize());
+      size_t num_changed = 0;
+      for (size_t fID = 0; fID < parent.GetSize(); ++fID) {
+        if (offspring[fID] != parent[fID]) ++num_changed;
+      }
+      // Only mutated functions are new; everything else is shared with the parent.
+      REQUIRE(num_changed <= num_muts);
+      if (num_muts == 0) REQUIRE(offspring == parent);
+      REQUIRE(
+        psynth::PackedProgram<TAG_WIDTH>::FromProgram(offspring.ToProgram<program_t>()).GetInstCount()
+        == offspring.GetInstCount()
+      );
+    }
+  }
+
+  SECTION("Recombination") {
+    recomb_t recombiner;
+    recombiner.SetWholeFuncSwapRate(0.5);
+    recombiner.SetFuncSeqCrossoverRate(0.5);
+    for (size_t i = 0; i < 50; ++i) {
+      shared_program_t prog_1 = shared_program_t::FromProgram(
+        sgp::cpu::lfunprg::GenRandLinearFunctionsProgram<hardware_t, TAG_WIDTH>(
+          random, inst_lib, FUNC_CNT_RANGE, 1, FUNC_LEN_RANGE, 1, 3, ARG_VAL_RANGE
+        )
+      );
+      shared_program_t prog_2 = shared_program_t::FromProgram(
+        sgp::cpu::lfunprg::GenRandLinearFunctionsProgram<hardware_t, TAG_WIDTH>(
+          random, inst_lib, FUNC_CNT_RANGE, 1, FUNC_LEN_RANGE, 1, 3, ARG_VAL_RANGE
+        )
+      );
+      const size_t total_insts = prog_1.GetInstCount() + prog_2.GetInstCount();
+      recombiner.ApplyWholeFunctionRecombination(random, prog_1, prog_2);
+      REQUIRE(prog_1.GetInstCount() + prog_2.GetInstCount() == total_insts);
+      recombiner.ApplyFunctionSequenceRecombinationTwoPoint(random, prog_1, prog_2);
+      REQUIRE(prog_1.ToProgram<program_t>().GetInstCount() == prog_1.GetInstCount());
+      REQUIRE(prog_2.ToProgram<program_t>().GetInstCount() == prog_2.GetInstCount());
+    }
+  }
+
+}
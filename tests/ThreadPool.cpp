@@ -0,0 +1,47 @@
+#define CATCH_CONFIG_MAIN
+#define PSYNTH_TRACK_ALLOCATIONS
+
+#include "Catch2/single_include/catch2/catch.hpp"
+
+#include <atomic>
+
+#include "emp/base/vector.hpp"
+#include "utility/AllocationTracker.hpp"
+#include "utility/ThreadPool.hpp"
+
+TEST_CASE("ThreadPool") {
+  const size_t num_threads = 4;
+  utils::ThreadPool pool(num_threads);
+  REQUIRE(pool.GetNumThreads() == num_threads);
+
+  // Each task runs exactly once on each thread, and Run waits for all of them.
+  emp::vector<size_t> runs(num_threads, 0);
+  std::atomic<size_t> total{0};
+  auto task = [&runs, &total](size_t thread_id) {
+    ++runs[thread_id];
+    total.fetch_add(thread_id + 1);
+  };
+  for (size_t rep = 1; rep <= 100; ++rep) {
+    pool.Run(task);
+    REQUIRE(runs == emp::vector<size_t>(num_threads, rep));
+    REQUIRE(total.load() == rep * (num_threads * (num_threads + 1)) / 2);
+  }
+
+  // Running a task on the persistent workers does not allocate.
+  utils::AllocationStopwatch stopwatch;
+  for (size_t rep = 0; rep < 100; ++rep) pool.Run(task);
+  REQUIRE(stopwatch.Lap().allocations == 0);
+
+  // Restarting with a different thread count does not rerun the last task.
+  pool.Start(2);
+  REQUIRE(pool.GetNumThreads() == 2);
+  REQUIRE(runs == emp::vector<size_t>(num_threads, 200));
+  pool.Run(task);
+  REQUIRE(runs == emp::vector<size_t>{201, 201, 200, 200});
+
+  // Single thread: task runs inline on the calling thread.
+  pool.Start(1);
+  REQUIRE(pool.GetNumThreads() == 1);
+  pool.Run(task);
+  REQUIRE(runs == emp::vector<size_t>{202, 201, 200, 200});
+}
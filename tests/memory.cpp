@@ -0,0 +1,43 @@
+#define CATCH_CONFIG_MAIN
+
+#include "Catch2/single_include/catch2/catch.hpp"
+
+#include <cstdint>
+
+#include "emp/base/vector.hpp"
+#include "utility/memory.hpp"
+#include "program-synthesis/PackedProgram.hpp"
+#include "program-synthesis/ScoreStore.hpp"
+#include "program-synthesis/program_utils.hpp"
+
+TEST_CASE("Vector byte accounting") {
+  emp::vector<uint64_t> words;
+  REQUIRE(utils::VectorBytes(words) == 0);
+  words.reserve(10);
+  words.resize(3);
+  REQUIRE(utils::VectorBytes(words) == words.capacity() * sizeof(uint64_t));
+  emp::vector<bool> bits(100);
+  REQUIRE(utils::VectorBytes(bits) == (bits.capacity() + 7) / 8);
+  emp::vector<emp::vector<double>> table(4, emp::vector<double>(8));
+  size_t expected = table.capacity() * sizeof(emp::vector<double>);
+  for (const auto& row : table) expected += row.capacity() * sizeof(double);
+  REQUIRE(utils::NestedVectorBytes(table) == expected);
+}
+
+TEST_CASE("Subsystem byte accounting") {
+  psynth::ScoreStore store;
+  store.Resize(10, 100);
+  REQUIRE(store.GetNumBytes() >= 10 * 100 * sizeof(psynth::stored_score_t));
+
+  psynth::PackedProgram<16> program;
+  program.PushFunction(1);
+  program.PushInst({0, 1, 2});
+  program.PushInst({1, 3, 4});
+  REQUIRE(psynth::GetProgramBytes(program) >= 2 * sizeof(psynth::PackedInst));
+}
+
+TEST_CASE("Process RSS") {
+  const size_t rss = utils::GetCurrentRSS();
+  REQUIRE(rss > 0);
+  REQUIRE(utils::GetPeakRSS() >= rss);
+}
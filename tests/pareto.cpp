@@ -0,0 +1,101 @@
+#define CATCH_CONFIG_MAIN
+
+#include "Catch2/single_include/catch2/catch.hpp"
+
+#include <algorithm>
+
+#include "emp/base/vector.hpp"
+#include "emp/math/Random.hpp"
+#include "utility/pareto.hpp"
+
+namespace {
+
+// Reference front ranks: repeatedly peel off the pareto front of the remaining candidates.
+emp::vector<size_t> ReferenceRanks(const emp::vector< emp::vector<double> >& rows) {
+  emp::vector<size_t> ranks(rows.size(), 0);
+  emp::vector<size_t> remaining(rows.size());
+  std::iota(remaining.begin(), remaining.end(), 0);
+  size_t rank = 0;
+  while (remaining.size()) {
+    emp::vector< emp::vector<double> > remaining_rows;
+    for (size_t id : remaining) remaining_rows.emplace_back(rows[id]);
+    const auto front = utils::find_pareto_front(remaining_rows);
+    emp::vector<size_t> next_remaining;
+    for (size_t i = 0; i < remaining.size(); ++i) {
+      if (std::find(front.begin(), front.end(), i) != front.end()) {
+        ranks[remaining[i]] = rank;
+      } else {
+        next_remaining.emplace_back(remaining[i]);
+      }
+    }
+    remaining = next_remaining;
+    ++rank;
+  }
+  return ranks;
+}
+
+}
+
+TEST_CASE("dominates_packed") {
+  const uint64_t a[2] = {0b1011, 0b1};
+  const uint64_t b[2] = {0b0011, 0b1};
+  const uint64_t c[2] = {0b0100, 0b0};
+  REQUIRE(utils::dominates_packed(a, b, 2));
+  REQUIRE(!utils::dominates_packed(b, a, 2));
+  REQUIRE(!utils::dominates_packed(a, a, 2));
+  REQUIRE(!utils::dominates_packed(a, c, 2));
+  REQUIRE(!utils::dominates_packed(c, a, 2));
+}
+
+TEST_CASE("NonDominatedSorter") {
+  emp::Random random(2);
+  const size_t num_candidates = 200;
+  utils::NonDominatedSorter sorter;
+
+  for (size_t num_objectives : {3, 70}) {
+    for (bool binary : {true, false}) {
+      emp::vector< emp::vector<double> > rows(num_candidates, emp::vector<double>(num_objectives, 0.0));
+      emp::vector<double> table(num_candidates * num_objectives, 0.0);
+      for (size_t cand = 0; cand < num_candidates; ++cand) {
+        for (size_t obj = 0; obj < num_objectives; ++obj) {
+          const double score = (binary) ?
+            (double)random.P(0.5 + (0.4 * (double)cand / (double)num_candidates)) :
+            (double)random.GetUInt(5);
+          rows[cand][obj] = score;
+          table[(cand * num_objectives) + obj] = score;
+        }
+      }
+      sorter.Sort(table, num_candidates, num_objectives);
+      REQUIRE(sorter.IsBinary() == binary);
+      REQUIRE(sorter.GetRanks() == ReferenceRanks(rows));
+      // Every candidate appears in exactly one front
+      size_t total = 0;
+      for (size_t front_i = 0; front_i < sorter.GetNumFronts(); ++front_i) {
+        for (size_t cand : sorter.GetFront(front_i)) {
+          REQUIRE(sorter.GetRanks()[cand] == front_i);
+        }
+        total += sorter.GetFront(front_i).size();
+      }
+      REQUIRE(total == num_candidates);
+    }
+  }
+}
+
+TEST_CASE("NonDominatedSorter crowding") {
+  // Single front of four candidates on two objectives
+  emp::vector<double> table{
+    0.0, 3.0,
+    1.0, 2.0,
+    2.0, 1.0,
+    3.0, 0.0
+  };
+  utils::NonDominatedSorter sorter;
+  sorter.Sort(table, 4, 2);
+  REQUIRE(sorter.GetNumFronts() == 1);
+  sorter.ComputeCrowding(table);
+  const auto& crowding = sorter.GetCrowding();
+  REQUIRE(crowding[0] == std::numeric_limits<double>::infinity());
+  REQUIRE(crowding[3] == std::numeric_limits<double>::infinity());
+  REQUIRE(crowding[1] == Approx(4.0 / 3.0));
+  REQUIRE(crowding[2] == Approx(4.0 / 3.0));
+}